@@ -22,6 +22,10 @@ C_MODE_START
 
 uint32 murmur3_32(const uchar * key, size_t len, uint32 seed);
 
+#define MURMUR3_128_HASH_SIZE 16 /* Size of murmur3_x64_128() hash in bytes */
+
+void murmur3_x64_128(const uchar *key, size_t len, uint32 seed, uchar *hash);
+
 C_MODE_END
 
 #endif /* MY_MURMUR3_INCLUDED */
@@ -14,9 +14,9 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
 
 /*
-  Implementation of 32-bit version of MurmurHash3 - fast non-cryptographic
-  hash function with good statistical properties, which is based on public
-  domain code by Austin Appleby.
+  Implementation of 32-bit and x64 128-bit versions of MurmurHash3 - fast
+  non-cryptographic hash function with good statistical properties, which
+  is based on public domain code by Austin Appleby.
 */
 
 #include <my_murmur3.h>
@@ -33,12 +33,14 @@
 #include <stdlib.h>
 
 #define ROTL32(x, y)	_rotl(x, y)
+#define ROTL64(x, y)	_rotl64(x, y)
 
 /*
   Force inlining of intrinsic even though /Oi option is turned off
   in release builds.
 */
 #pragma intrinsic(_rotl)
+#pragma intrinsic(_rotl64)
 
 #else // !defined(_MSC_VER)
 
@@ -54,6 +56,13 @@ inline uint32 rotl32 (uint32 x, char r)
 
 #define	ROTL32(x,y)	rotl32(x,y)
 
+inline uint64 rotl64 (uint64 x, char r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+#define	ROTL64(x,y)	rotl64(x,y)
+
 #endif // !defined(_MSC_VER)
 
 
@@ -132,3 +141,144 @@ uint32 murmur3_32(const uchar *key, size_t len, uint32 seed)
 
   return h1;
 }
+
+
+/** Finalization mix of 128-bit version, forces all bits to avalanche. */
+
+static inline uint64 fmix64(uint64 k)
+{
+  k^= k >> 33;
+  k*= 0xff51afd7ed558ccdULL;
+  k^= k >> 33;
+  k*= 0xc4ceb9fe1a85ec53ULL;
+  k^= k >> 33;
+  return k;
+}
+
+
+/**
+  Compute x64 128-bit version of MurmurHash3 hash for the key.
+
+  @param key        Key for which hash value to be computed.
+  @param len        Key length.
+  @param seed       Seed for hash computation.
+  @param[out] hash  Buffer of MURMUR3_128_HASH_SIZE bytes for hash value,
+                    which is stored as two little-endian 64-bit halves.
+
+  @note The same warning about "hash DoS" as for murmur3_32() applies.
+*/
+
+void murmur3_x64_128(const uchar *key, size_t len, uint32 seed, uchar *hash)
+{
+  const uchar *tail= key + (len - len % 16);
+
+  uint64 h1= seed;
+  uint64 h2= seed;
+
+  const uint64 c1= 0x87c37b91114253d5ULL;
+  const uint64 c2= 0x4cf5ad432745937fULL;
+
+  /* Body: process all 128-bit blocks in the key. */
+
+  for (const uchar *data= key; data != tail; data+= 16)
+  {
+    uint64 k1= uint8korr(data);
+    uint64 k2= uint8korr(data + 8);
+
+    k1*= c1;
+    k1= ROTL64(k1, 31);
+    k1*= c2;
+    h1^= k1;
+
+    h1= ROTL64(h1, 27);
+    h1+= h2;
+    h1= h1 * 5 + 0x52dce729;
+
+    k2*= c2;
+    k2= ROTL64(k2, 33);
+    k2*= c1;
+    h2^= k2;
+
+    h2= ROTL64(h2, 31);
+    h2+= h1;
+    h2= h2 * 5 + 0x38495ab5;
+  }
+
+  /* Tail: handle remaining len % 16 bytes. */
+
+  uint64 k1= 0;
+  uint64 k2= 0;
+
+  switch(len % 16)
+  {
+  case 15:
+    k2^= static_cast<uint64>(tail[14]) << 48;
+    /* Fall through. */
+  case 14:
+    k2^= static_cast<uint64>(tail[13]) << 40;
+    /* Fall through. */
+  case 13:
+    k2^= static_cast<uint64>(tail[12]) << 32;
+    /* Fall through. */
+  case 12:
+    k2^= static_cast<uint64>(tail[11]) << 24;
+    /* Fall through. */
+  case 11:
+    k2^= static_cast<uint64>(tail[10]) << 16;
+    /* Fall through. */
+  case 10:
+    k2^= static_cast<uint64>(tail[9]) << 8;
+    /* Fall through. */
+  case 9:
+    k2^= static_cast<uint64>(tail[8]);
+    k2*= c2;
+    k2= ROTL64(k2, 33);
+    k2*= c1;
+    h2^= k2;
+    /* Fall through. */
+  case 8:
+    k1^= static_cast<uint64>(tail[7]) << 56;
+    /* Fall through. */
+  case 7:
+    k1^= static_cast<uint64>(tail[6]) << 48;
+    /* Fall through. */
+  case 6:
+    k1^= static_cast<uint64>(tail[5]) << 40;
+    /* Fall through. */
+  case 5:
+    k1^= static_cast<uint64>(tail[4]) << 32;
+    /* Fall through. */
+  case 4:
+    k1^= static_cast<uint64>(tail[3]) << 24;
+    /* Fall through. */
+  case 3:
+    k1^= static_cast<uint64>(tail[2]) << 16;
+    /* Fall through. */
+  case 2:
+    k1^= static_cast<uint64>(tail[1]) << 8;
+    /* Fall through. */
+  case 1:
+    k1^= static_cast<uint64>(tail[0]);
+    k1*= c1;
+    k1= ROTL64(k1, 31);
+    k1*= c2;
+    h1^= k1;
+  };
+
+  /* Finalization: add length and mix both halves. */
+
+  h1^= len;
+  h2^= len;
+
+  h1+= h2;
+  h2+= h1;
+
+  h1= fmix64(h1);
+  h2= fmix64(h2);
+
+  h1+= h2;
+  h2+= h1;
+
+  int8store(hash, h1);
+  int8store(hash + 8, h2);
+}
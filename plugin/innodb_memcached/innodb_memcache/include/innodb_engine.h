@@ -46,6 +46,23 @@ a connection before committing the transaction */
 /** Structure contains the cursor information for each connection */
 typedef struct innodb_conn_data_struct		innodb_conn_data_t;
 
+/** Result buffers of a key that has been handed out to memcached as part
+of a multi-get. The buffers stay owned by the item until memcached
+releases it, so the value can be sent straight from the row buffer
+without copying */
+typedef struct innodb_mget_buf_struct		innodb_mget_buf_t;
+
+struct innodb_mget_buf_struct {
+	void*		result;		/*!< result info */
+	void*		row_buf;	/*!< row buffer the value points to */
+	ib_ulint_t	row_buf_len;	/*!< row buffer len */
+	void*		mul_col_buf;	/*!< buffer holding a value assembled
+					from multiple mapped columns */
+	ib_ulint_t	mul_col_buf_len;/*!< mul_col_buf len */
+	innodb_mget_buf_t*
+			next;		/*!< next buffer in the list */
+};
+
 /** Connection specific data */
 struct innodb_conn_data_struct {
 	ib_crsr_t	read_crsr;	/*!< read only cursor for the
@@ -70,6 +87,13 @@ struct innodb_conn_data_struct {
 	void*		mul_col_buf;	/*!< buffer to construct final result
 					from multiple mapped column */
 	ib_ulint_t	mul_col_buf_len;/*!< mul_col_buf len */
+	innodb_mget_buf_t*
+			mget_used;	/*!< result buffers of earlier keys
+					of a multi-get, not yet released
+					by memcached */
+	innodb_mget_buf_t*
+			mget_free;	/*!< released result buffers kept
+					for reuse by the next multi-get */
 	bool            in_use;		/*!< whether the connection
 					is processing a request */
 	bool		is_stale;	/*!< connection closed, this is
@@ -112,6 +112,155 @@ innodb_handle(
 	return((struct innodb_engine*) handle);
 }
 
+/*******************************************************************//**
+Free a list of multi-get result buffers */
+static
+void
+innodb_mget_free_list(
+/*==================*/
+	innodb_mget_buf_t*	buf)	/*!< in/own: first buffer of the list */
+{
+	while (buf) {
+		innodb_mget_buf_t*	next = buf->next;
+
+		free(buf->result);
+		free(buf->row_buf);
+
+		if (buf->mul_col_buf) {
+			free(buf->mul_col_buf);
+		}
+
+		free(buf);
+		buf = next;
+	}
+}
+
+/*******************************************************************//**
+Hand the result buffers of the connection, which back an item memcached
+still holds for an earlier key of a multi-get, over to that item, and
+give the connection a fresh set of buffers for the next key. Released
+buffers are recycled, so a multi-get of n keys allocates at most n
+buffer sets over the life of the connection.
+@return true if successful */
+static
+bool
+innodb_mget_detach_result(
+/*======================*/
+	innodb_conn_data_t*	conn_data)	/*!< in/out: connection data */
+{
+	innodb_mget_buf_t*	buf = conn_data->mget_free;
+	void*			result;
+	void*			row_buf;
+	ib_ulint_t		row_buf_len;
+	void*			mul_col_buf;
+	ib_ulint_t		mul_col_buf_len;
+
+	if (buf) {
+		conn_data->mget_free = buf->next;
+	} else {
+		buf = malloc(sizeof(*buf));
+
+		if (!buf) {
+			return(false);
+		}
+
+		memset(buf, 0, sizeof(*buf));
+
+		buf->result = malloc(sizeof(mci_item_t));
+		buf->row_buf = malloc(1024);
+
+		if (!buf->result || !buf->row_buf) {
+			free(buf->result);
+			free(buf->row_buf);
+			free(buf);
+			return(false);
+		}
+
+		buf->row_buf_len = 1024;
+	}
+
+	result = buf->result;
+	row_buf = buf->row_buf;
+	row_buf_len = buf->row_buf_len;
+	mul_col_buf = buf->mul_col_buf;
+	mul_col_buf_len = buf->mul_col_buf_len;
+
+	buf->result = conn_data->result;
+	buf->row_buf = conn_data->row_buf;
+	buf->row_buf_len = conn_data->row_buf_len;
+	buf->mul_col_buf = conn_data->mul_col_buf;
+	buf->mul_col_buf_len = conn_data->mul_col_buf_len;
+
+	conn_data->result = result;
+	conn_data->row_buf = row_buf;
+	conn_data->row_buf_len = row_buf_len;
+	conn_data->mul_col_buf = mul_col_buf;
+	conn_data->mul_col_buf_len = mul_col_buf_len;
+
+	buf->next = conn_data->mget_used;
+	conn_data->mget_used = buf;
+
+	conn_data->result_in_use = false;
+
+	return(true);
+}
+
+/*******************************************************************//**
+Check whether an item handed out to memcached is an InnoDB result, as
+opposed to a hash item of the default engine.
+@return true if the item is backed by InnoDB result buffers */
+static
+bool
+innodb_mget_is_result(
+/*==================*/
+	const innodb_conn_data_t*	conn_data,	/*!< in: connection
+							data */
+	const void*			item)		/*!< in: item */
+{
+	const innodb_mget_buf_t*	buf;
+
+	if (conn_data->result_in_use && item == conn_data->result) {
+		return(true);
+	}
+
+	for (buf = conn_data->mget_used; buf; buf = buf->next) {
+		if (item == buf->result) {
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/*******************************************************************//**
+Return the result buffers backing an item of a multi-get to the free list
+of the connection once memcached has released the item.
+@return true if the item belonged to an earlier key of a multi-get */
+static
+bool
+innodb_mget_release_result(
+/*=======================*/
+	innodb_conn_data_t*	conn_data,	/*!< in/out: connection data */
+	const void*		item)		/*!< in: item released */
+{
+	innodb_mget_buf_t**	prev = &conn_data->mget_used;
+
+	while (*prev) {
+		innodb_mget_buf_t*	buf = *prev;
+
+		if (item == buf->result) {
+			*prev = buf->next;
+			buf->next = conn_data->mget_free;
+			conn_data->mget_free = buf;
+			return(true);
+		}
+
+		prev = &buf->next;
+	}
+
+	return(false);
+}
+
 /*******************************************************************//**
 Cleanup idle connections if "clear_all" is false, and clean up all
 connections if "clear_all" is true.
@@ -632,6 +781,11 @@ innodb_conn_clean_data(
 			conn_data->mul_col_buf_len = 0;
 		}
 
+		innodb_mget_free_list(conn_data->mget_used);
+		conn_data->mget_used = NULL;
+		innodb_mget_free_list(conn_data->mget_free);
+		conn_data->mget_free = NULL;
+
 		pthread_mutex_destroy(&conn_data->curr_conn_mutex);
 		free(conn_data);
 	}
@@ -1627,6 +1781,13 @@ innodb_release(
 		return;
 	}
 
+	/* Items of earlier keys of a multi-get own their buffers, the
+	connection result stays in use for the last key */
+	if (conn_data->mget_used
+	    && innodb_mget_release_result(conn_data, item)) {
+		return;
+	}
+
 	conn_data->result_in_use = false;
 
 	/* If item's memory comes from Memcached default engine, release it
@@ -1805,6 +1966,15 @@ innodb_get(
 		return(ENGINE_TMPFAIL);
 	}
 
+	/* memcached still holds the result of an earlier key of this
+	multi-get, leave its buffers to it instead of copying the value */
+	if (conn_data->result_in_use
+	    && !innodb_mget_detach_result(conn_data)) {
+		innodb_api_cursor_reset(innodb_eng, conn_data,
+					CONN_OP_READ, true);
+		return(ENGINE_TMPFAIL);
+	}
+
 	result = (mci_item_t*)(conn_data->result);
 
 	err = innodb_api_search(conn_data, &crsr, key + nkey - key_len,
@@ -1834,7 +2004,11 @@ search_done:
 			 "%s/%s", dbname, name);
 #endif
 
-		assert(!conn_data->result_in_use);
+		if (conn_data->result_in_use
+		    && !innodb_mget_detach_result(conn_data)) {
+			return(ENGINE_TMPFAIL);
+		}
+
 		conn_data->result_in_use = true;
 		result = (mci_item_t*)(conn_data->result);
 
@@ -2358,7 +2532,7 @@ innodb_get_item_info(
 
 	conn_data = innodb_eng->server.cookie->get_engine_specific(cookie);
 
-	if (!conn_data || !conn_data->result_in_use) {
+	if (!conn_data || !innodb_mget_is_result(conn_data, item)) {
 		hash_item*      it;
 
 		if (item_info->nvalue < 1) {
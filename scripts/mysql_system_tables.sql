@@ -246,6 +246,16 @@ INSERT IGNORE INTO engine_cost(engine_name, device_type, cost_name) VALUES
   ("default", 0, "memory_block_read_cost"),
   ("default", 0, "io_block_read_cost");
 
+-- Column value histograms, written by ANALYZE TABLE ... UPDATE HISTOGRAM
+
+CREATE TABLE IF NOT EXISTS column_stats (
+  database_name VARCHAR(64) NOT NULL,
+  table_name    VARCHAR(64) NOT NULL,
+  column_name   VARCHAR(64) NOT NULL,
+  histogram     JSON NOT NULL,
+  PRIMARY KEY (database_name, table_name, column_name)
+) ENGINE=InnoDB CHARACTER SET=utf8 COLLATE=utf8_bin STATS_PERSISTENT=0;
+
 --
 -- PERFORMANCE SCHEMA INSTALLATION
 -- Note that this script is also reused by mysql_upgrade,
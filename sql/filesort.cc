@@ -310,6 +310,7 @@ bool filesort(THD *thd, Filesort *filesort, bool sort_positions,
                           table,
                           thd->variables.max_length_for_sort_data,
                           max_rows, sort_positions);
+  param.max_sort_threads= thd->variables.max_sort_threads;
 
   table_sort.addon_fields= param.addon_fields;
 
@@ -389,7 +390,8 @@ bool filesort(THD *thd, Filesort *filesort, bool sort_positions,
 
     while (memory_available >= min_sort_memory)
     {
-      ha_rows keys= memory_available / (param.rec_length + sizeof(char*));
+      ha_rows keys= memory_available /
+        Filesort_buffer::bytes_per_record(param.rec_length);
       // If the table is empty, allocate space for one row.
       param.max_keys_per_buffer= (uint) min(num_rows > 0 ? num_rows : 1, keys);
 
@@ -1736,7 +1738,7 @@ bool check_if_pq_applicable(Opt_trace_context *trace,
   }
 
   ulong num_available_keys=
-    memory_available / (param->rec_length + sizeof(char*));
+    memory_available / Filesort_buffer::bytes_per_record(param->rec_length);
   // We need 1 extra record in the buffer, when using PQ.
   param->max_keys_per_buffer= (uint) param->max_rows + 1;
 
@@ -1773,7 +1775,9 @@ bool check_if_pq_applicable(Opt_trace_context *trace,
   {
     const ulong row_length=
       param->sort_length + param->ref_length + sizeof(char*);
-    num_available_keys= memory_available / row_length;
+    num_available_keys= memory_available /
+      Filesort_buffer::bytes_per_record(param->sort_length +
+                                        param->ref_length);
 
     Opt_trace_object trace_addon(trace, "strip_additional_fields");
     trace_addon.add("row_size", row_length);
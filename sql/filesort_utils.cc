@@ -14,10 +14,15 @@
    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
 
 #include "filesort_utils.h"
+#include "mysqld.h"                             // key_thread_sort
 #include "opt_costmodel.h"
 #include "sql_const.h"
 #include "sql_sort.h"
 #include "table.h"
+#include "my_atomic.h"
+#include "my_thread.h"
+#include "myisampack.h"
+#include "mysql/psi/mysql_thread.h"
 
 #include <algorithm>
 #include <functional>
@@ -26,6 +31,9 @@
 PSI_memory_key key_memory_Filesort_buffer_sort_keys;
 
 namespace {
+/// Below this many keys, the comparison sorts are as fast as radix sort.
+const uint MIN_KEYS_FOR_PREFIX_SORT= 1000;
+
 /**
   A local helper function. See comments for get_merge_buffers_cost().
  */
@@ -120,14 +128,18 @@ uchar *Filesort_buffer::alloc_sort_buffer(uint num_records, uint record_length)
   }
 
   m_size_in_bytes= ALIGN_SIZE(num_records * (record_length + sizeof(uchar*)));
+  // The space for sorting key prefixes follows the record pointers.
+  const size_t scratch_size= num_records >= MIN_KEYS_FOR_PREFIX_SORT ?
+    num_records * PREFIX_SORT_BYTES_PER_RECORD : 0;
   if (m_rawmem == NULL)
     m_rawmem= (uchar*) my_malloc(key_memory_Filesort_buffer_sort_keys,
-                                 m_size_in_bytes, MYF(0));
+                                 m_size_in_bytes + scratch_size, MYF(0));
   if (m_rawmem == NULL)
   {
     m_size_in_bytes= 0;
     return NULL;
   }
+  m_prefix_scratch= scratch_size > 0 ? m_rawmem + m_size_in_bytes : NULL;
   m_record_pointers= reinterpret_cast<uchar**>(m_rawmem)
     + ((m_size_in_bytes / sizeof(uchar*)) - 1);
   m_num_records= num_records;
@@ -215,6 +227,278 @@ size_t try_reserve(std::pair<type*, ptrdiff_t> *buf, ptrdiff_t size)
   return buf->second;
 }
 
+/// Buckets smaller than this are finished with a comparison sort.
+const size_t MIN_RADIX_BUCKET= 64;
+
+/**
+  The first eight bytes of a sort key, loaded as a big-endian integer,
+  next to the pointer to the key. Comparing prefixes is an integer
+  comparison, and needs no access to the key itself.
+*/
+struct Sort_key_prefix
+{
+  ulonglong prefix;
+  uchar *key;
+};
+
+class Prefix_compare :
+  public std::binary_function<const Sort_key_prefix&,
+                              const Sort_key_prefix&, bool>
+{
+public:
+  bool operator()(const Sort_key_prefix &k1, const Sort_key_prefix &k2) const
+  {
+    return k1.prefix < k2.prefix;
+  }
+};
+
+inline ulonglong load_key_prefix(const uchar *key, size_t sort_length)
+{
+  if (sort_length >= 8)
+    return mi_uint8korr(key);
+  ulonglong prefix= 0;
+  for (size_t ix= 0; ix < 8; ++ix)
+    prefix= (prefix << 8) | (ix < sort_length ? key[ix] : 0);
+  return prefix;
+}
+
+/**
+  Stable MSD radix sort of the prefixes, one byte per level, starting with
+  byte number 'byte' (0 is the most significant one). Each level
+  distributes the keys into 'tmp' and copies them back, which keeps keys
+  with equal bytes in their original order. Levels where all keys have
+  the same byte are skipped without moving anything.
+*/
+void msd_radix_sort(Sort_key_prefix *keys, Sort_key_prefix *tmp, size_t n,
+                    uint byte)
+{
+  for (; byte < 8; ++byte)
+  {
+    if (n < MIN_RADIX_BUCKET)
+    {
+      std::stable_sort(keys, keys + n, Prefix_compare());
+      return;
+    }
+    const uint shift= 56 - 8 * byte;
+    size_t count[256];
+    memset(count, 0, sizeof(count));
+    for (size_t ix= 0; ix < n; ++ix)
+      count[(keys[ix].prefix >> shift) & 0xff]++;
+    if (count[(keys[0].prefix >> shift) & 0xff] == n)
+      continue;
+
+    // Turn the counts into bucket starts; after distribution, count[b]
+    // is the end of bucket b.
+    size_t start[256];
+    size_t pos= 0;
+    for (uint b= 0; b < 256; ++b)
+    {
+      start[b]= pos;
+      pos+= count[b];
+      count[b]= start[b];
+    }
+    for (size_t ix= 0; ix < n; ++ix)
+      tmp[count[(keys[ix].prefix >> shift) & 0xff]++]= keys[ix];
+    memcpy(keys, tmp, n * sizeof(Sort_key_prefix));
+
+    if (byte + 1 < 8)
+    {
+      for (uint b= 0; b < 256; ++b)
+        if (count[b] - start[b] > 1)
+          msd_radix_sort(keys + start[b], tmp + start[b],
+                         count[b] - start[b], byte + 1);
+    }
+    return;
+  }
+}
+
+/**
+  Stable sort of the keys in [first, last) by an MSD radix sort of their
+  eight byte prefixes. Only runs of keys with equal prefixes, if the keys
+  are longer than that, are compared on the full key afterwards.
+
+  @param scratch  Space for 2 * (last - first) prefixes, taken from the
+                  sort buffer. @see Filesort_buffer::alloc_sort_buffer()
+*/
+void prefix_radix_sort(uchar **first, uchar **last, size_t sort_length,
+                       Sort_key_prefix *scratch)
+{
+  compile_time_assert(2 * sizeof(Sort_key_prefix) <=
+                      Filesort_buffer::PREFIX_SORT_BYTES_PER_RECORD);
+  const ptrdiff_t n= last - first;
+  Sort_key_prefix *keys= scratch;
+  Sort_key_prefix *tmp= scratch + n;
+
+  for (ptrdiff_t ix= 0; ix < n; ++ix)
+  {
+    keys[ix].prefix= load_key_prefix(first[ix], sort_length);
+    keys[ix].key= first[ix];
+  }
+  msd_radix_sort(keys, tmp, n, 0);
+  for (ptrdiff_t ix= 0; ix < n; ++ix)
+    first[ix]= keys[ix].key;
+
+  if (sort_length > 8)
+  {
+    for (ptrdiff_t ix= 0; ix < n; )
+    {
+      ptrdiff_t end= ix + 1;
+      while (end < n && keys[end].prefix == keys[ix].prefix)
+        ++end;
+      if (end - ix > 1)
+        std::stable_sort(first + ix, first + end,
+                         Mem_compare_longkey(sort_length));
+      ix= end;
+    }
+  }
+}
+
+/// Sorting fewer keys than this per thread is not worth a thread.
+const uint MIN_KEYS_PER_SORT_THREAD= 16384;
+
+/**
+  Number of sort threads reserved by all sessions, at most
+  MAX_SORT_THREADS, so that concurrent sorts do not start more threads
+  than one sort may use.
+*/
+volatile int32 sort_threads_reserved= 0;
+
+/**
+  Reserves up to n_wanted sort threads within the server-wide limit.
+
+  @return the number of threads reserved, possibly 0
+*/
+uint reserve_sort_threads(uint n_wanted)
+{
+  int32 reserved= my_atomic_load32(&sort_threads_reserved);
+  for (;;)
+  {
+    const int32 n_free= MAX_SORT_THREADS - reserved;
+    if (n_free <= 0)
+      return 0;
+    const int32 n= std::min(static_cast<int32>(n_wanted), n_free);
+    if (my_atomic_cas32(&sort_threads_reserved, &reserved, reserved + n))
+      return n;
+  }
+}
+
+void release_sort_threads(uint n)
+{
+  my_atomic_add32(&sort_threads_reserved, -static_cast<int32>(n));
+}
+
+/**
+  A range of the sort keys that one thread either sorts, or merges from
+  two sorted runs [first, middle) and [middle, last).
+*/
+struct Sort_slice
+{
+  uchar **first;
+  uchar **middle;             ///< NULL if the range is to be sorted
+  uchar **last;
+  size_t sort_length;
+  Sort_key_prefix *scratch;   ///< NULL if prefixes are not to be sorted
+  my_thread_handle thread;
+  bool thread_started;
+};
+
+void sort_slice(Sort_slice *slice)
+{
+  if (slice->middle == NULL)
+  {
+    if (slice->scratch != NULL)
+    {
+      prefix_radix_sort(slice->first, slice->last, slice->sort_length,
+                        slice->scratch);
+      return;
+    }
+    if (slice->sort_length < 10)
+      std::stable_sort(slice->first, slice->last,
+                       Mem_compare(slice->sort_length));
+    else
+      std::stable_sort(slice->first, slice->last,
+                       Mem_compare_longkey(slice->sort_length));
+    return;
+  }
+  if (slice->sort_length < 10)
+    std::inplace_merge(slice->first, slice->middle, slice->last,
+                       Mem_compare(slice->sort_length));
+  else
+    std::inplace_merge(slice->first, slice->middle, slice->last,
+                       Mem_compare_longkey(slice->sort_length));
+}
+
+extern "C" void *sort_slice_thread(void *arg)
+{
+  sort_slice(static_cast<Sort_slice*>(arg));
+  return NULL;
+}
+
+/**
+  Processes n_slices slices, all but the first one in threads of their
+  own. A slice for which no thread can be started is processed by the
+  calling thread.
+*/
+void sort_slices(Sort_slice *slices, uint n_slices)
+{
+  for (uint ix= 1; ix < n_slices; ++ix)
+    slices[ix].thread_started=
+      mysql_thread_create(key_thread_sort, &slices[ix].thread, NULL,
+                          sort_slice_thread, &slices[ix]) == 0;
+  sort_slice(&slices[0]);
+  for (uint ix= 1; ix < n_slices; ++ix)
+  {
+    if (slices[ix].thread_started)
+      my_thread_join(&slices[ix].thread, NULL);
+    else
+      sort_slice(&slices[ix]);
+  }
+}
+
+/**
+  Sorts the keys with n_threads threads: each thread stable sorts an
+  equal share of the keys, then neighbouring runs are merged pairwise,
+  in parallel, until one run is left. Merging the left run before the
+  right one keeps the sort stable.
+
+  @param scratch  Space for 2 * count prefixes, which the threads share
+                  out, or NULL if no space for them was reserved.
+*/
+void parallel_sort(uchar **keys, uint count, size_t sort_length,
+                   Sort_key_prefix *scratch, uint n_threads)
+{
+  DBUG_ASSERT(n_threads > 1 && n_threads <= MAX_SORT_THREADS);
+  Sort_slice slices[MAX_SORT_THREADS];
+  uchar **bounds[MAX_SORT_THREADS + 1];
+
+  for (uint ix= 0; ix <= n_threads; ++ix)
+    bounds[ix]= keys + static_cast<ulonglong>(count) * ix / n_threads;
+
+  for (uint ix= 0; ix < n_threads; ++ix)
+  {
+    slices[ix].first= bounds[ix];
+    slices[ix].middle= NULL;
+    slices[ix].last= bounds[ix + 1];
+    slices[ix].sort_length= sort_length;
+    slices[ix].scratch= scratch ? scratch + 2 * (bounds[ix] - keys) : NULL;
+  }
+  sort_slices(slices, n_threads);
+
+  for (uint width= 1; width < n_threads; width*= 2)
+  {
+    uint n_merges= 0;
+    for (uint ix= 0; ix + width < n_threads; ix+= 2 * width)
+    {
+      slices[n_merges].first= bounds[ix];
+      slices[n_merges].middle= bounds[ix + width];
+      slices[n_merges].last= bounds[std::min(ix + 2 * width, n_threads)];
+      slices[n_merges].sort_length= sort_length;
+      n_merges++;
+    }
+    sort_slices(slices, n_merges);
+  }
+}
+
 } // namespace
 
 void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
@@ -257,6 +541,34 @@ void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
               Mem_compare_longkey(param->sort_length));
     return;
   }
+  /*
+    Packed records may be more than the buffer was allocated for, there is
+    no space for sorting the prefixes of these.
+  */
+  Sort_key_prefix *scratch= NULL;
+  if (count >= MIN_KEYS_FOR_PREFIX_SORT && count <= m_num_records)
+    scratch= reinterpret_cast<Sort_key_prefix*>(m_prefix_scratch);
+
+  const uint n_wanted=
+    std::min(param->max_sort_threads, count / MIN_KEYS_PER_SORT_THREAD);
+  if (n_wanted > 1)
+  {
+    // The session thread sorts a slice too, it needs no reservation.
+    const uint n_reserved= reserve_sort_threads(n_wanted - 1);
+    if (n_reserved > 0)
+    {
+      parallel_sort(m_sort_keys, count, param->sort_length, scratch,
+                    n_reserved + 1);
+      release_sort_threads(n_reserved);
+      return;
+    }
+  }
+  if (scratch != NULL)
+  {
+    prefix_radix_sort(m_sort_keys, m_sort_keys + count, param->sort_length,
+                      scratch);
+    return;
+  }
   // Heuristics here: avoid function overhead call for short keys.
   if (param->sort_length < 10)
   {
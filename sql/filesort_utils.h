@@ -82,7 +82,7 @@ class Filesort_buffer
 public:
   Filesort_buffer() :
     m_next_rec_ptr(NULL), m_rawmem(NULL), m_record_pointers(NULL),
-    m_sort_keys(NULL),
+    m_sort_keys(NULL), m_prefix_scratch(NULL),
     m_num_records(0), m_record_length(0), m_sort_length(0),
     m_size_in_bytes(0), m_idx(0)
   {}
@@ -186,10 +186,29 @@ public:
     return m_size_in_bytes;
   }
 
+  /**
+    Bytes per record which sort_buffer() uses for radix sorting the key
+    prefixes: two arrays of (prefix, record pointer) pairs.
+  */
+  static const size_t PREFIX_SORT_BYTES_PER_RECORD=
+    2 * (sizeof(ulonglong) + sizeof(uchar*));
+
+  /**
+    @returns the memory needed per record of the given length: the record,
+    its pointer, and the space for sorting its key prefix.
+  */
+  static size_t bytes_per_record(size_t record_length)
+  {
+    return record_length + sizeof(uchar*) + PREFIX_SORT_BYTES_PER_RECORD;
+  }
+
   /**
     Allocates the buffer, but does *not* initialize pointers.
     Total size = (num_records * record_length) + (num_records * sizeof(pointer))
                   space for records               space for pointer to records
+    Buffers for enough records to be radix sorted get
+    num_records * PREFIX_SORT_BYTES_PER_RECORD bytes more, which are not
+    part of sort_buffer_size(). @see bytes_per_record()
     Caller is responsible for raising an error if allocation fails.
 
     @param num_records   Number of records.
@@ -246,6 +265,7 @@ public:
     m_rawmem= rhs.m_rawmem;
     m_record_pointers= rhs.m_record_pointers;
     m_sort_keys= rhs.m_sort_keys;
+    m_prefix_scratch= rhs.m_prefix_scratch;
     m_num_records= rhs.m_num_records;
     m_record_length= rhs.m_record_length;
     m_sort_length= rhs.m_sort_length;
@@ -262,6 +282,7 @@ private:
   uchar  *m_rawmem;          /// The raw memory buffer.
   uchar **m_record_pointers; /// The "right-to-left" array of record pointers.
   uchar **m_sort_keys;       /// Caches the value of get_sort_keys()
+  uchar  *m_prefix_scratch;  /// Space for sorting key prefixes, or NULL.
   uint    m_num_records;     /// Saved value from alloc_sort_buffer()
   uint    m_record_length;   /// Saved value from alloc_sort_buffer()
   uint    m_sort_length;     /// The length of the sort key.
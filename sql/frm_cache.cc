@@ -0,0 +1,388 @@
+/* Copyright (c) 2018 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "frm_cache.h"
+
+#include "my_dir.h"                             // my_dir
+#include "mysqld.h"                             // key_file_frm, reg_ext
+#include "log.h"                                // sql_print_warning
+#include "mutex_lock.h"                         // Mutex_lock
+#include "mysql/psi/mysql_file.h"               // mysql_file_open
+#include "table.h"                              // tmp_file_prefix
+
+#include <map>
+#include <string>
+#include <vector>
+
+ulong frm_cache_size;
+uint frm_cache_prewarm_threads;
+
+
+/** Image of one .frm file, with the attributes of the file it came from */
+struct Frm_cache_entry
+{
+  std::string path;
+  uchar *image;
+  size_t length;
+  time_t mtime;
+  time_t ctime;
+  ulonglong inode;
+  /* Neighbours in the LRU list, most recently used first */
+  Frm_cache_entry *lru_prev;
+  Frm_cache_entry *lru_next;
+
+  /** @return memory accounted to the entry */
+  size_t size() const { return length + path.length() + sizeof(*this); }
+
+  /** @return whether the entry still describes the file */
+  bool matches(const MY_STAT *stat) const
+  {
+    return static_cast<size_t>(stat->st_size) == length &&
+           stat->st_mtime == mtime && stat->st_ctime == ctime &&
+           static_cast<ulonglong>(stat->st_ino) == inode;
+  }
+};
+
+typedef std::map<std::string, Frm_cache_entry *> Frm_cache_map;
+
+/* All members below are protected by LOCK_frm_cache */
+static Frm_cache_map *frm_cache= NULL;
+static mysql_mutex_t LOCK_frm_cache;
+static Frm_cache_entry *lru_first= NULL;
+static Frm_cache_entry *lru_last= NULL;
+static size_t frm_cache_used= 0;
+
+/* State of the prewarm threads */
+static std::vector<std::string> *prewarm_dbs= NULL;
+static volatile int32 prewarm_next_db= 0;
+static volatile bool prewarm_abort= false;
+static my_thread_handle *prewarm_threads= NULL;
+static uint prewarm_thread_count= 0;
+
+
+static void lru_unlink(Frm_cache_entry *entry)
+{
+  if (entry->lru_prev)
+    entry->lru_prev->lru_next= entry->lru_next;
+  else
+    lru_first= entry->lru_next;
+  if (entry->lru_next)
+    entry->lru_next->lru_prev= entry->lru_prev;
+  else
+    lru_last= entry->lru_prev;
+}
+
+
+static void lru_push_front(Frm_cache_entry *entry)
+{
+  entry->lru_prev= NULL;
+  entry->lru_next= lru_first;
+  if (lru_first)
+    lru_first->lru_prev= entry;
+  else
+    lru_last= entry;
+  lru_first= entry;
+}
+
+
+static void remove_entry(Frm_cache_map::iterator it)
+{
+  mysql_mutex_assert_owner(&LOCK_frm_cache);
+  Frm_cache_entry *entry= it->second;
+  lru_unlink(entry);
+  frm_cache_used-= entry->size();
+  frm_cache->erase(it);
+  my_free(entry->image);
+  delete entry;
+}
+
+
+/** Evicts least recently used images until limit bytes are left */
+static void evict_entries(size_t limit)
+{
+  mysql_mutex_assert_owner(&LOCK_frm_cache);
+  while (frm_cache_used > limit && lru_last != NULL)
+    remove_entry(frm_cache->find(lru_last->path));
+}
+
+
+/**
+  Copies the cached image of a .frm file, if it still matches the file.
+
+  @return true if the cache has no current image of the file
+*/
+static bool frm_cache_get(const char *path, const MY_STAT *stat,
+                          uchar **image, size_t *length)
+{
+  Mutex_lock lock(&LOCK_frm_cache);
+  Frm_cache_map::iterator it= frm_cache->find(path);
+  if (it == frm_cache->end())
+    return true;
+  Frm_cache_entry *entry= it->second;
+  if (!entry->matches(stat))
+  {
+    remove_entry(it);
+    return true;
+  }
+  if (!(*image= (uchar *) my_malloc(key_memory_frm_string, entry->length,
+                                    MYF(MY_WME))))
+    return true;
+  memcpy(*image, entry->image, entry->length);
+  *length= entry->length;
+  lru_unlink(entry);
+  lru_push_front(entry);
+  return false;
+}
+
+
+/** Adds or replaces the image of a .frm file. Failures are ignored. */
+static void frm_cache_put(const char *path, const MY_STAT *stat,
+                          const uchar *image, size_t length)
+{
+  Frm_cache_entry *entry= new (std::nothrow) Frm_cache_entry;
+  if (entry == NULL)
+    return;
+  entry->length= length;
+  entry->mtime= stat->st_mtime;
+  entry->ctime= stat->st_ctime;
+  entry->inode= static_cast<ulonglong>(stat->st_ino);
+  if (!(entry->image= (uchar *) my_malloc(key_memory_frm_cache, length,
+                                          MYF(0))))
+  {
+    delete entry;
+    return;
+  }
+  memcpy(entry->image, image, length);
+  entry->path.assign(path);
+
+  Mutex_lock lock(&LOCK_frm_cache);
+  if (entry->size() > frm_cache_size)
+  {
+    my_free(entry->image);
+    delete entry;
+    return;
+  }
+  Frm_cache_map::iterator it= frm_cache->find(entry->path);
+  if (it != frm_cache->end())
+    remove_entry(it);
+  evict_entries(frm_cache_size - entry->size());
+  frm_cache->insert(std::make_pair(entry->path, entry));
+  lru_push_front(entry);
+  frm_cache_used+= entry->size();
+}
+
+
+int read_frm_file(const char *path, bool use_cache,
+                  uchar **image, size_t *length)
+{
+  File file;
+  MY_STAT stat;
+  int error= 2;
+  DBUG_ENTER("read_frm_file");
+
+  use_cache= use_cache && frm_cache != NULL && frm_cache_size > 0;
+  if (use_cache)
+  {
+    if (!mysql_file_stat(key_file_frm, path, &stat, MYF(0)))
+      DBUG_RETURN(1);
+    if (!frm_cache_get(path, &stat, image, length))
+      DBUG_RETURN(0);
+  }
+
+  if ((file= mysql_file_open(key_file_frm, path,
+                             O_RDONLY | O_SHARE, MYF(0))) < 0)
+    DBUG_RETURN(1);
+
+  *image= NULL;
+  if (mysql_file_fstat(file, &stat, MYF(0)))
+    goto err;
+  *length= static_cast<size_t>(stat.st_size);
+  if (!(*image= (uchar *) my_malloc(key_memory_frm_string, *length + 1,
+                                    MYF(MY_WME))) ||
+      mysql_file_read(file, *image, *length, MYF(MY_NABP)))
+    goto err;
+
+  /* Only images of base tables are used by more than one open. */
+  if (use_cache && *length >= 64 &&
+      (*image)[0] == (uchar) 254 && (*image)[1] == 1)
+    frm_cache_put(path, &stat, *image, *length);
+  error= 0;
+
+err:
+  if (error)
+  {
+    my_free(*image);
+    *image= NULL;
+  }
+  mysql_file_close(file, MYF(MY_WME));
+  DBUG_RETURN(error);
+}
+
+
+void frm_cache_invalidate(const char *path)
+{
+  if (frm_cache == NULL)
+    return;
+  Mutex_lock lock(&LOCK_frm_cache);
+  Frm_cache_map::iterator it= frm_cache->find(path);
+  if (it != frm_cache->end())
+    remove_entry(it);
+}
+
+
+void frm_cache_flush()
+{
+  if (frm_cache == NULL)
+    return;
+  Mutex_lock lock(&LOCK_frm_cache);
+  evict_entries(0);
+}
+
+
+void frm_cache_resize()
+{
+  if (frm_cache == NULL)
+    return;
+  Mutex_lock lock(&LOCK_frm_cache);
+  evict_entries(frm_cache_size);
+}
+
+
+void frm_cache_init()
+{
+  DBUG_ASSERT(frm_cache == NULL);
+  mysql_mutex_init(key_LOCK_frm_cache, &LOCK_frm_cache, MY_MUTEX_INIT_FAST);
+  frm_cache= new Frm_cache_map;
+}
+
+
+/**
+  Body of a prewarm thread. Reads the .frm files of one database after
+  the other into the frm cache until all databases are done, the cache
+  is full or the server shuts down.
+*/
+extern "C" void *frm_cache_prewarm_thread(void *arg MY_ATTRIBUTE((unused)))
+{
+  my_thread_init();
+  DBUG_ENTER("frm_cache_prewarm_thread");
+
+  for (;;)
+  {
+    int32 db= my_atomic_add32(&prewarm_next_db, 1);
+    if (prewarm_abort || db >= static_cast<int32>(prewarm_dbs->size()))
+      break;
+
+    char dir_path[FN_REFLEN + 1];
+    strxnmov(dir_path, sizeof(dir_path) - 1, mysql_data_home, "/",
+             (*prewarm_dbs)[db].c_str(), NullS);
+    MY_DIR *dir= my_dir(dir_path, MYF(0));
+    if (dir == NULL)
+      continue;
+
+    for (uint i= 0; i < dir->number_off_files && !prewarm_abort; i++)
+    {
+      const char *name= dir->dir_entry[i].name;
+      const size_t name_length= strlen(name);
+      if (name_length <= reg_ext_length ||
+          strcmp(name + name_length - reg_ext_length, reg_ext) ||
+          is_prefix(name, tmp_file_prefix))
+        continue;
+
+      char path[FN_REFLEN + 1];
+      strxnmov(path, sizeof(path) - 1, dir_path, "/", name, NullS);
+      unpack_filename(path, path);
+
+      uchar *image;
+      size_t length;
+      if (read_frm_file(path, true, &image, &length))
+        continue;
+      my_free(image);
+
+      /* Stop before the prewarm starts evicting its own images. */
+      mysql_mutex_lock(&LOCK_frm_cache);
+      const bool full= frm_cache_used + length > frm_cache_size;
+      mysql_mutex_unlock(&LOCK_frm_cache);
+      if (full)
+        prewarm_abort= true;
+    }
+    my_dirend(dir);
+  }
+
+  DBUG_LEAVE; // Can't use DBUG_RETURN after my_thread_end
+  my_thread_end();
+  return NULL;
+}
+
+
+void frm_cache_prewarm()
+{
+  DBUG_ENTER("frm_cache_prewarm");
+  if (frm_cache == NULL || frm_cache_size == 0 ||
+      frm_cache_prewarm_threads == 0)
+    DBUG_VOID_RETURN;
+
+  MY_DIR *dir= my_dir(mysql_data_home, MYF(MY_WANT_STAT));
+  if (dir == NULL)
+    DBUG_VOID_RETURN;
+  prewarm_dbs= new std::vector<std::string>;
+  for (uint i= 0; i < dir->number_off_files; i++)
+  {
+    const FILEINFO *file= dir->dir_entry + i;
+    if (MY_S_ISDIR(file->mystat->st_mode) && file->name[0] != '.')
+      prewarm_dbs->push_back(file->name);
+  }
+  my_dirend(dir);
+
+  prewarm_next_db= 0;
+  prewarm_abort= false;
+  prewarm_threads= new my_thread_handle[frm_cache_prewarm_threads];
+  for (prewarm_thread_count= 0;
+       prewarm_thread_count < frm_cache_prewarm_threads;
+       prewarm_thread_count++)
+  {
+    int error;
+    if ((error= mysql_thread_create(key_thread_frm_cache_prewarm,
+                                    &prewarm_threads[prewarm_thread_count],
+                                    NULL, frm_cache_prewarm_thread, NULL)))
+    {
+      sql_print_warning("Can't create frm cache prewarm thread (errno= %d)",
+                        error);
+      break;
+    }
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+void frm_cache_free()
+{
+  if (frm_cache == NULL)
+    return;
+
+  prewarm_abort= true;
+  for (uint i= 0; i < prewarm_thread_count; i++)
+    my_thread_join(&prewarm_threads[i], NULL);
+  delete [] prewarm_threads;
+  prewarm_threads= NULL;
+  prewarm_thread_count= 0;
+  delete prewarm_dbs;
+  prewarm_dbs= NULL;
+
+  frm_cache_flush();
+  delete frm_cache;
+  frm_cache= NULL;
+  mysql_mutex_destroy(&LOCK_frm_cache);
+}
@@ -0,0 +1,79 @@
+/* Copyright (c) 2018 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef FRM_CACHE_INCLUDED
+#define FRM_CACHE_INCLUDED
+
+/**
+  @file sql/frm_cache.h
+
+  Cache of the contents of .frm files.
+
+  Opening a TABLE_SHARE that is not in the table definition cache reads
+  the .frm of the table. With many tables and a table definition cache
+  that can not hold them all, or right after a restart, this file I/O
+  is a large part of the cost of opening a table. The frm cache keeps
+  the images of .frm files of base tables in memory, up to frm_cache_size
+  bytes, and evicts the least recently used ones. An image is only used
+  if the modification time, change time, size and inode of the file still
+  match those it was read with, so a share is never built from an
+  outdated definition. Images of views and temporary tables are not
+  cached.
+
+  At startup, the cache can be filled in the background by
+  frm_cache_prewarm_threads threads, each reading the .frm files of one
+  database at a time.
+*/
+
+#include "my_global.h"
+
+/** Largest size in bytes of the images in the frm cache, 0 disables it */
+extern ulong frm_cache_size;
+/** Number of threads filling the frm cache at startup */
+extern uint frm_cache_prewarm_threads;
+
+/**
+  Reads the whole contents of a .frm file.
+
+  @param      path       path of the .frm file
+  @param      use_cache  whether the image may be taken from or put into
+                         the frm cache
+  @param[out] image      the image, to be freed by the caller with my_free()
+  @param[out] length     length of the image
+
+  @retval 0  ok
+  @retval 1  the file could not be opened, my_errno() is set
+  @retval 2  the file could not be read, my_errno() is set
+*/
+int read_frm_file(const char *path, bool use_cache,
+                  uchar **image, size_t *length);
+
+/** Removes the image of a .frm file from the frm cache. */
+void frm_cache_invalidate(const char *path);
+
+/** Removes all images from the frm cache. */
+void frm_cache_flush();
+
+/** Evicts images until the cache fits into frm_cache_size. */
+void frm_cache_resize();
+
+void frm_cache_init();
+/** Starts the threads filling the frm cache, if any. */
+void frm_cache_prewarm();
+/** Stops the prewarm threads and frees the frm cache. */
+void frm_cache_free();
+
+#endif /* FRM_CACHE_INCLUDED */
@@ -2219,6 +2219,22 @@ int ha_commit_attachable(THD *thd)
 }
 
 
+/** Incremented by ha_statistics_changed() */
+static int64 volatile statistics_version= 0;
+
+
+void ha_statistics_changed()
+{
+  my_atomic_add64(&statistics_version, 1);
+}
+
+
+ulonglong ha_statistics_version()
+{
+  return static_cast<ulonglong>(my_atomic_load64(&statistics_version));
+}
+
+
 /**
   @details
   This function should be called when MySQL sends rows of a SELECT result set
@@ -3160,6 +3176,60 @@ int handler::ha_rnd_next(uchar *buf)
 }
 
 
+/**
+  Read the next rows of a table scan.
+
+  @param[out] buf       Buffer for max_rows rows
+  @param      max_rows  Maximum number of rows to read
+  @param[out] n_rows    Number of rows read
+
+  @note The whole batch is instrumented as one table io wait.
+
+  @return Operation status, @see rnd_next_batch()
+*/
+
+int handler::ha_rnd_next_batch(uchar *buf, uint max_rows, uint *n_rows)
+{
+  int result;
+  DBUG_ENTER("handler::ha_rnd_next_batch");
+  DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
+              m_lock_type != F_UNLCK);
+  DBUG_ASSERT(inited == RND);
+  DBUG_ASSERT(max_rows > 0);
+  // Generated fields are only updated in record[0]
+  DBUG_ASSERT(!table->has_gcol());
+
+  *n_rows= 0;
+  MYSQL_TABLE_IO_WAIT(PSI_TABLE_FETCH_ROW, MAX_KEY, result,
+    { result= rnd_next_batch(buf, max_rows, n_rows); })
+  DBUG_ASSERT(result || *n_rows > 0);
+
+  for (uint i= 0; i < *n_rows; i++)
+    update_index_stats(active_index);
+
+  DBUG_RETURN(result);
+}
+
+
+int handler::rnd_next_batch(uchar *buf, uint max_rows, uint *n_rows)
+{
+  const size_t rec_length= table->s->rec_buff_length;
+  int error= 0;
+
+  while (*n_rows < max_rows)
+  {
+    if ((error= rnd_next(buf + *n_rows * rec_length)))
+    {
+      if (error != HA_ERR_RECORD_DELETED)
+        break;
+      continue;
+    }
+    (*n_rows)++;
+  }
+  return error;
+}
+
+
 /**
   Read row via random scan from position.
 
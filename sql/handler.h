@@ -302,6 +302,12 @@ enum enum_alter_inplace_result {
  */
 #define HA_ONLINE_ANALYZE             (1LL << 48)
 
+/**
+  Handler reads several rows of a table scan per call of rnd_next_batch()
+  faster than with as many rnd_next() calls.
+*/
+#define HA_CAN_READ_BATCH             (1LL << 49)
+
 /* bits in index_flags(index_number) for what you can do with index */
 #define HA_READ_NEXT            1       /* TODO really use this flag */
 #define HA_READ_PREV            2       /* supports ::index_prev */
@@ -2519,6 +2525,7 @@ public:
   int ha_rnd_init(bool scan);
   int ha_rnd_end();
   int ha_rnd_next(uchar *buf);
+  int ha_rnd_next_batch(uchar *buf, uint max_rows, uint *n_rows);
   int ha_rnd_pos(uchar * buf, uchar *pos);
   int ha_index_read_map(uchar *buf, const uchar *key,
                         key_part_map keypart_map,
@@ -3069,6 +3076,24 @@ protected:
   virtual int rnd_next(uchar *buf)=0;
   /// @returns @see index_read_map().
   virtual int rnd_pos(uchar * buf, uchar *pos)=0;
+  /**
+    Read the next rows of a table scan.
+
+    The rows are stored one after another in buf, table->s->rec_buff_length
+    bytes apart. The handler is positioned after the last row read, so
+    position() and unlock_row() must not be used for the rows of a batch.
+
+    The default implementation calls rnd_next() for every row.
+
+    @param[out] buf       Buffer for max_rows rows
+    @param      max_rows  Maximum number of rows to read
+    @param[out] n_rows    Number of rows read
+
+    @retval 0       At least one row was read
+    @retval != 0    Error code of the read that ended the batch. The
+                    n_rows rows read before it are valid.
+  */
+  virtual int rnd_next_batch(uchar *buf, uint max_rows, uint *n_rows);
 public:
   /**
     This function only works for handlers having
@@ -4391,6 +4416,15 @@ int ha_change_key_cache(KEY_CACHE *old_key_cache, KEY_CACHE *new_key_cache);
 /* report to InnoDB that control passes to the client */
 int ha_release_temporary_latches(THD *thd);
 
+/*
+  Version of the statistics plans are chosen with: index statistics of
+  the storage engines and the optimizer cost constants. Whoever changes
+  them calls ha_statistics_changed(), so that plans cached with an older
+  version are chosen anew.
+*/
+void ha_statistics_changed();
+ulonglong ha_statistics_version();
+
 /* transactions: interface to handlerton functions */
 int ha_start_consistent_snapshot(THD *thd);
 int ha_store_binlog_info(THD *thd);
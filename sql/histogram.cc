@@ -0,0 +1,1182 @@
+/* Copyright (c) 2018 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "histogram.h"
+
+#include "field.h"                              // Field
+#include "item.h"                               // Item
+#include "json_dom.h"                           // Json_dom
+#include "key.h"                                // key_copy
+#include "log.h"                                // sql_print_warning
+#include "mysqld.h"                             // key_LOCK_histograms
+#include "records.h"                            // READ_RECORD
+#include "sql_base.h"                           // open_and_lock_tables
+#include "sql_class.h"                          // THD
+#include "sql_lex.h"                            // lex_start/lex_end
+#include "sql_string.h"                         // String
+#include "table.h"                              // TABLE
+#include "template_utils.h"                     // pointer_cast
+#include "transaction.h"                        // trans_commit_stmt
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+  Largest number of rows ANALYZE TABLE ... UPDATE HISTOGRAM samples.
+  Larger tables are sampled uniformly down to this many rows.
+*/
+static const size_t HISTOGRAM_SAMPLE_ROWS= 200000;
+
+/**
+  Largest number of column values ANALYZE TABLE ... UPDATE HISTOGRAM keeps
+  in memory. Histograms of many columns at once sample fewer rows.
+*/
+static const size_t HISTOGRAM_MAX_SAMPLE_VALUES= 4 * 1024 * 1024;
+
+static const char histogram_type_singleton[]= "singleton";
+static const char histogram_type_equi_height[]= "equi-height";
+
+
+/*****************************************************************************
+  Histogram
+*****************************************************************************/
+
+Histogram *Histogram::build(MEM_ROOT *mem_root, double *values,
+                            size_t num_values, size_t num_nulls,
+                            uint max_buckets, int data_type)
+{
+  Histogram *histogram= new (mem_root) Histogram;
+  if (histogram == NULL)
+    return NULL;                                /* purecov: inspected */
+
+  std::sort(values, values + num_values);
+
+  const double total= static_cast<double>(num_values + num_nulls);
+  histogram->m_data_type= data_type;
+  histogram->m_null_values= total > 0.0 ? num_nulls / total : 0.0;
+
+  size_t distinct= 0;
+  for (size_t i= 0; i < num_values; i++)
+  {
+    if (i == 0 || values[i] != values[i - 1])
+      distinct++;
+  }
+
+  max_buckets= std::max(max_buckets, 1U);
+  const size_t buckets= std::min(distinct, static_cast<size_t>(max_buckets));
+  if (buckets > 0 &&
+      !(histogram->m_buckets= static_cast<Bucket*>(
+          alloc_root(mem_root, buckets * sizeof(Bucket)))))
+    return NULL;                                /* purecov: inspected */
+
+  /*
+    A singleton histogram has a bucket per distinct value. Otherwise the
+    values are cut into buckets of about num_values / max_buckets values.
+    Equal values stay in the same bucket, and a value that would fill a
+    bucket on its own gets one, so that its frequency is not spread over
+    the other values of a bucket. The last bucket takes the remaining
+    values if the buckets run out.
+  */
+  histogram->m_type= distinct <= max_buckets ? SINGLETON : EQUI_HEIGHT;
+  const size_t bucket_size= histogram->m_type == SINGLETON ? 1 :
+    (num_values + max_buckets - 1) / max_buckets;
+
+  size_t rows= 0;
+  for (size_t start= 0; start < num_values; )
+  {
+    size_t end= std::min(start + bucket_size, num_values);
+    if (histogram->m_num_buckets + 1 == buckets)
+      end= num_values;
+    else if (end < num_values && values[end] == values[end - 1])
+    {
+      const size_t run_start=
+        std::lower_bound(values + start, values + end, values[end - 1]) -
+        values;
+      if (run_start > start)
+        end= run_start;
+      else
+      {
+        while (end < num_values && values[end] == values[end - 1])
+          end++;
+      }
+    }
+
+    size_t bucket_distinct= 1;
+    for (size_t i= start + 1; i < end; i++)
+    {
+      if (values[i] != values[i - 1])
+        bucket_distinct++;
+    }
+
+    rows+= end - start;
+    Bucket *bucket= histogram->m_buckets + histogram->m_num_buckets++;
+    bucket->lower= values[start];
+    bucket->upper= values[end - 1];
+    bucket->cumulative_frequency= rows / total;
+    bucket->distinct_values= static_cast<double>(bucket_distinct);
+    start= end;
+  }
+  DBUG_ASSERT(histogram->m_num_buckets <= buckets);
+
+  return histogram;
+}
+
+
+/**
+  Reads a JSON number as a double.
+
+  @return true if the value is not a number
+*/
+static bool json_get_double(const Json_dom *dom, double *value)
+{
+  if (dom == NULL)
+    return true;
+  switch (dom->json_type())
+  {
+  case Json_dom::J_DOUBLE:
+    *value= down_cast<const Json_double*>(dom)->value();
+    return false;
+  case Json_dom::J_INT:
+    *value= static_cast<double>(down_cast<const Json_int*>(dom)->value());
+    return false;
+  case Json_dom::J_UINT:
+    *value= ulonglong2double(down_cast<const Json_uint*>(dom)->value());
+    return false;
+  default:
+    return true;
+  }
+}
+
+
+Histogram *Histogram::from_json(MEM_ROOT *mem_root, const char *text,
+                                size_t length)
+{
+  Json_dom *dom= Json_dom::parse(text, length, NULL, NULL);
+  if (dom == NULL)
+    return NULL;
+
+  Histogram *histogram= NULL;
+  double data_type;
+  double null_values;
+  const Json_dom *type;
+  const Json_dom *buckets;
+  const Json_object *object;
+  const Json_array *array;
+  size_t bucket_width;
+  double previous= 0.0;
+
+  if (dom->json_type() != Json_dom::J_OBJECT)
+    goto end;
+  object= down_cast<const Json_object*>(dom);
+  type= object->get("histogram-type");
+  buckets= object->get("buckets");
+  if (type == NULL || type->json_type() != Json_dom::J_STRING ||
+      buckets == NULL || buckets->json_type() != Json_dom::J_ARRAY ||
+      json_get_double(object->get("data-type"), &data_type) ||
+      json_get_double(object->get("null-values"), &null_values) ||
+      null_values < 0.0 || null_values > 1.0)
+    goto end;
+
+  if (!(histogram= new (mem_root) Histogram))
+    goto end;                                   /* purecov: inspected */
+  histogram->m_data_type= static_cast<int>(data_type);
+  histogram->m_null_values= null_values;
+  if (down_cast<const Json_string*>(type)->value() ==
+      histogram_type_singleton)
+  {
+    histogram->m_type= SINGLETON;
+    bucket_width= 2;
+  }
+  else if (down_cast<const Json_string*>(type)->value() ==
+           histogram_type_equi_height)
+  {
+    histogram->m_type= EQUI_HEIGHT;
+    bucket_width= 4;
+  }
+  else
+    goto invalid;
+
+  array= down_cast<const Json_array*>(buckets);
+  histogram->m_num_buckets= static_cast<uint>(array->size());
+  if (histogram->m_num_buckets > HISTOGRAM_MAX_BUCKETS)
+    goto invalid;
+  if (histogram->m_num_buckets > 0 &&
+      !(histogram->m_buckets= static_cast<Bucket*>(
+          alloc_root(mem_root, histogram->m_num_buckets * sizeof(Bucket)))))
+    goto invalid;                               /* purecov: inspected */
+
+  for (uint i= 0; i < histogram->m_num_buckets; i++)
+  {
+    const Json_dom *elem= (*array)[i];
+    if (elem->json_type() != Json_dom::J_ARRAY)
+      goto invalid;
+    const Json_array *values= down_cast<const Json_array*>(elem);
+    if (values->size() != bucket_width)
+      goto invalid;
+
+    Bucket *bucket= histogram->m_buckets + i;
+    if (histogram->m_type == SINGLETON)
+    {
+      if (json_get_double((*values)[0], &bucket->lower) ||
+          json_get_double((*values)[1], &bucket->cumulative_frequency))
+        goto invalid;
+      bucket->upper= bucket->lower;
+      bucket->distinct_values= 1.0;
+    }
+    else if (json_get_double((*values)[0], &bucket->lower) ||
+             json_get_double((*values)[1], &bucket->upper) ||
+             json_get_double((*values)[2], &bucket->cumulative_frequency) ||
+             json_get_double((*values)[3], &bucket->distinct_values))
+      goto invalid;
+
+    if (bucket->lower > bucket->upper ||
+        bucket->cumulative_frequency < previous ||
+        bucket->cumulative_frequency > 1.0 ||
+        bucket->distinct_values < 1.0 ||
+        (i > 0 && bucket->lower <= bucket[-1].upper))
+      goto invalid;
+    previous= bucket->cumulative_frequency;
+  }
+  goto end;
+
+invalid:
+  histogram= NULL;
+end:
+  delete dom;
+  return histogram;
+}
+
+
+/**
+  Appends a double to a string the way JSON_TYPE DOUBLE values are
+  printed.
+
+  @return true if out of memory
+*/
+static bool append_double(String *str, double value)
+{
+  if (str->reserve(MY_GCVT_MAX_FIELD_WIDTH + 1))
+    return true;                                /* purecov: inspected */
+  size_t len= my_gcvt(value, MY_GCVT_ARG_DOUBLE, MY_GCVT_MAX_FIELD_WIDTH,
+                      const_cast<char*>(str->ptr()) + str->length(), NULL);
+  str->length(str->length() + len);
+  return false;
+}
+
+
+bool Histogram::to_json(String *str) const
+{
+  bool error= false;
+
+  error|= str->append(STRING_WITH_LEN("{\"histogram-type\": \""));
+  error|= str->append(m_type == SINGLETON ? histogram_type_singleton :
+                      histogram_type_equi_height);
+  error|= str->append(STRING_WITH_LEN("\", \"data-type\": "));
+  error|= str->append_longlong(m_data_type);
+  error|= str->append(STRING_WITH_LEN(", \"null-values\": "));
+  error|= append_double(str, m_null_values);
+  error|= str->append(STRING_WITH_LEN(", \"buckets\": ["));
+  for (uint i= 0; i < m_num_buckets; i++)
+  {
+    const Bucket *bucket= m_buckets + i;
+    if (i > 0)
+      error|= str->append(STRING_WITH_LEN(", "));
+    error|= str->append('[');
+    error|= append_double(str, bucket->lower);
+    if (m_type == EQUI_HEIGHT)
+    {
+      error|= str->append(STRING_WITH_LEN(", "));
+      error|= append_double(str, bucket->upper);
+    }
+    error|= str->append(STRING_WITH_LEN(", "));
+    error|= append_double(str, bucket->cumulative_frequency);
+    if (m_type == EQUI_HEIGHT)
+    {
+      error|= str->append(STRING_WITH_LEN(", "));
+      error|= append_double(str, bucket->distinct_values);
+    }
+    error|= str->append(']');
+  }
+  error|= str->append(STRING_WITH_LEN("]}"));
+
+  return error;
+}
+
+
+static bool bucket_upper_less(const Histogram::Bucket &bucket, double value)
+{
+  return bucket.upper < value;
+}
+
+
+const Histogram::Bucket *Histogram::find_bucket(double value) const
+{
+  const Bucket *begin= m_buckets;
+  const Bucket *end= m_buckets + m_num_buckets;
+  const Bucket *bucket= std::lower_bound(begin, end, value,
+                                         bucket_upper_less);
+  return bucket == end ? NULL : bucket;
+}
+
+
+double Histogram::get_equal_to_selectivity(double value) const
+{
+  const Bucket *bucket= find_bucket(value);
+  if (bucket == NULL || value < bucket->lower)
+    return 0.0;
+
+  /* Assume that all values of a bucket are equally frequent. */
+  return (bucket->cumulative_frequency - frequency_before(bucket)) /
+    bucket->distinct_values;
+}
+
+
+double Histogram::get_less_than_selectivity(double value) const
+{
+  const Bucket *bucket= find_bucket(value);
+  if (bucket == NULL)
+    return get_non_null_values_fraction();
+
+  const double before= frequency_before(bucket);
+  if (value <= bucket->lower)
+    return before;
+
+  /*
+    lower < value <= upper, which only happens in equi-height buckets.
+    Interpolate linearly, but leave out the rows that are equal to upper.
+  */
+  const double frequency= bucket->cumulative_frequency - before;
+  const double fraction= (value - bucket->lower) /
+    (bucket->upper - bucket->lower);
+  return before + std::min(frequency * fraction,
+                           frequency - frequency / bucket->distinct_values);
+}
+
+
+double Histogram::get_less_than_equal_selectivity(double value) const
+{
+  return std::min(get_less_than_selectivity(value) +
+                  get_equal_to_selectivity(value),
+                  get_non_null_values_fraction());
+}
+
+
+double Histogram::get_greater_than_selectivity(double value) const
+{
+  return std::max(get_non_null_values_fraction() -
+                  get_less_than_equal_selectivity(value), 0.0);
+}
+
+
+double Histogram::get_greater_than_equal_selectivity(double value) const
+{
+  return std::max(get_non_null_values_fraction() -
+                  get_less_than_selectivity(value), 0.0);
+}
+
+
+double Histogram::get_between_selectivity(double low, double high) const
+{
+  return std::max(get_less_than_equal_selectivity(high) -
+                  get_less_than_selectivity(low), 0.0);
+}
+
+
+/*****************************************************************************
+  Values of columns and constants
+*****************************************************************************/
+
+bool histogram_supports_field(const Field *field)
+{
+  if (field->is_virtual_gcol())
+    return false;
+
+  switch (field->real_type())
+  {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+  case MYSQL_TYPE_FLOAT:
+  case MYSQL_TYPE_DOUBLE:
+  case MYSQL_TYPE_DECIMAL:
+  case MYSQL_TYPE_NEWDECIMAL:
+  case MYSQL_TYPE_YEAR:
+  case MYSQL_TYPE_DATE:
+  case MYSQL_TYPE_NEWDATE:
+  case MYSQL_TYPE_TIME:
+  case MYSQL_TYPE_TIME2:
+  case MYSQL_TYPE_DATETIME:
+  case MYSQL_TYPE_DATETIME2:
+  case MYSQL_TYPE_TIMESTAMP:
+  case MYSQL_TYPE_TIMESTAMP2:
+    return true;
+  default:
+    return false;
+  }
+}
+
+
+double histogram_field_value(Field *field)
+{
+  DBUG_ASSERT(!field->is_null());
+  if (field->is_temporal())
+    return static_cast<double>(field->val_temporal_by_field_type());
+  return field->val_real();
+}
+
+
+bool histogram_item_value(const Field *field, Item *item, double *value)
+{
+  if (!item->const_item() || item->is_expensive() || item->has_subquery())
+    return true;
+
+  /*
+    The item is evaluated again when the condition is executed, which
+    reports any conversion warnings. Keep them out of optimization.
+  */
+  THD *thd= current_thd;
+  Dummy_error_handler error_handler;
+  thd->push_internal_handler(&error_handler);
+  if (field->is_temporal())
+    *value= static_cast<double>(field->type() == MYSQL_TYPE_TIME ?
+                                item->val_time_temporal() :
+                                item->val_date_temporal());
+  else
+    *value= item->val_real();
+  thd->pop_internal_handler();
+
+  return item->null_value;
+}
+
+
+const Histogram *get_histogram(THD *thd, const Field *field)
+{
+  if (field->table == NULL || field->table->s->histograms == NULL ||
+      !thd->optimizer_switch_flag(OPTIMIZER_SWITCH_HISTOGRAMS))
+    return NULL;
+  return field->table->s->histograms[field->field_index];
+}
+
+
+/**
+  Reads a key image of a column as a histogram value.
+
+  @param      field   the column
+  @param      copy    copy of the column with a record buffer of its own
+  @param      key     the key image, starting with a NULL byte if the
+                      column is nullable
+  @param[out] value   the value
+
+  @return true if the image is NULL
+*/
+static bool histogram_key_value(const Field *field, Field *copy,
+                                const uchar *key, double *value)
+{
+  if (field->real_maybe_null())
+  {
+    if (*key)
+      return true;
+    key++;
+  }
+  copy->set_key_image(key, copy->key_length());
+  *value= histogram_field_value(copy);
+  return false;
+}
+
+
+bool get_histogram_range_selectivity(THD *thd, Field *field,
+                                     const uchar *min_key, bool include_min,
+                                     const uchar *max_key, bool include_max,
+                                     double *selectivity)
+{
+  const Histogram *histogram= get_histogram(thd, field);
+  if (histogram == NULL)
+    return true;
+
+  /*
+    record[0] may hold a row the optimizer still needs, e.g. of a const
+    table, so the key images are unpacked into a copy of the field that
+    points to a buffer of its own and has no NULL bit.
+  */
+  uchar buff[MAX_FIELD_WIDTH];
+  MEM_ROOT mem_root;
+  init_alloc_root(PSI_NOT_INSTRUMENTED, &mem_root, 256, 0);
+  Field *copy= field->clone(&mem_root);
+  if (copy == NULL || field->pack_length() > sizeof(buff))
+  {
+    free_root(&mem_root, MYF(0));
+    return true;                                /* purecov: inspected */
+  }
+  copy->move_field(buff, NULL, 0);
+
+  /*
+    The range holds the rows up to its upper bound but not those below its
+    lower bound. A NULL lower bound means "greater than NULL".
+  */
+  double value;
+  double below= 0.0;
+  double up_to= histogram->get_non_null_values_fraction();
+  if (min_key != NULL && !histogram_key_value(field, copy, min_key, &value))
+    below= include_min ? histogram->get_less_than_selectivity(value) :
+                         histogram->get_less_than_equal_selectivity(value);
+  if (max_key != NULL && !histogram_key_value(field, copy, max_key, &value))
+    up_to= include_max ? histogram->get_less_than_equal_selectivity(value) :
+                         histogram->get_less_than_selectivity(value);
+  free_root(&mem_root, MYF(0));
+
+  *selectivity= std::max(up_to - below, 0.0);
+  return false;
+}
+
+
+/*****************************************************************************
+  ANALYZE TABLE ... UPDATE HISTOGRAM
+*****************************************************************************/
+
+bool build_histograms(THD *thd, TABLE *table, Field **fields,
+                      uint num_fields, uint num_buckets, MEM_ROOT *mem_root,
+                      Histogram **histograms)
+{
+  handler *file= table->file;
+  int error;
+  DBUG_ENTER("build_histograms");
+
+  /*
+    Keep a uniform sample of at most max_rows rows by reservoir sampling,
+    which needs no estimate of the number of rows. Row n of the sample
+    holds the values of the columns at sample[n * num_fields], with the
+    NULL values flagged in is_null.
+  */
+  const size_t max_rows=
+    std::max<size_t>(std::min(HISTOGRAM_SAMPLE_ROWS,
+                              HISTOGRAM_MAX_SAMPLE_VALUES / num_fields), 1);
+  std::vector<double> sample;
+  std::vector<bool> is_null;
+  ulonglong rows_read= 0;
+
+  /* Read only the columns of the histograms. */
+  bitmap_clear_all(table->read_set);
+  for (uint i= 0; i < num_fields; i++)
+    bitmap_set_bit(table->read_set, fields[i]->field_index);
+  file->column_bitmaps_signal();
+
+  if ((error= file->ha_rnd_init(true)))
+  {
+    file->print_error(error, MYF(0));
+    DBUG_RETURN(true);
+  }
+  for (;;)
+  {
+    if (thd->killed)
+    {
+      thd->send_kill_message();
+      file->ha_rnd_end();
+      DBUG_RETURN(true);
+    }
+    if ((error= file->ha_rnd_next(table->record[0])))
+    {
+      if (error == HA_ERR_RECORD_DELETED)
+        continue;
+      break;
+    }
+
+    /*
+      The first max_rows rows fill the sample; each later row replaces a
+      random one of it with probability max_rows / rows_read.
+    */
+    size_t slot;
+    if (++rows_read <= max_rows)
+    {
+      slot= sample.size();
+      sample.resize(slot + num_fields);
+      is_null.resize(slot + num_fields);
+    }
+    else
+    {
+      const ulonglong n= static_cast<ulonglong>(my_rnd(&thd->rand) *
+                                                rows_read);
+      if (n >= max_rows)
+        continue;
+      slot= static_cast<size_t>(n) * num_fields;
+    }
+
+    for (uint i= 0; i < num_fields; i++)
+    {
+      is_null[slot + i]= fields[i]->is_null();
+      sample[slot + i]= is_null[slot + i] ? 0.0 :
+                        histogram_field_value(fields[i]);
+    }
+  }
+  file->ha_rnd_end();
+  if (error != HA_ERR_END_OF_FILE)
+  {
+    file->print_error(error, MYF(0));
+    DBUG_RETURN(true);
+  }
+
+  std::vector<double> values;
+  for (uint i= 0; i < num_fields; i++)
+  {
+    size_t nulls= 0;
+    values.clear();
+    for (size_t slot= i; slot < sample.size(); slot+= num_fields)
+    {
+      if (is_null[slot])
+        nulls++;
+      else
+        values.push_back(sample[slot]);
+    }
+
+    double *data= values.empty() ? NULL : &values[0];
+    if (!(histograms[i]= Histogram::build(mem_root, data, values.size(),
+                                          nulls, num_buckets,
+                                          fields[i]->real_type())))
+      DBUG_RETURN(true);                        /* purecov: inspected */
+  }
+  DBUG_RETURN(false);
+}
+
+
+/*****************************************************************************
+  Histogram cache
+*****************************************************************************/
+
+/**
+  JSON text of all histograms in mysql.column_stats, keyed by
+  "db\0table\0column" so that the histograms of a table are adjacent.
+*/
+typedef std::map<std::string, std::string> Histogram_map;
+
+static Histogram_map *histogram_cache= NULL;
+static mysql_mutex_t LOCK_histograms;
+
+
+static std::string histogram_key(const char *db, const char *table_name,
+                                 const char *column)
+{
+  std::string key(db);
+  key.push_back('\0');
+  key.append(table_name);
+  key.push_back('\0');
+  key.append(column);
+  return key;
+}
+
+
+void init_histogram_cache()
+{
+  DBUG_ASSERT(histogram_cache == NULL);
+  mysql_mutex_init(key_LOCK_histograms, &LOCK_histograms, MY_MUTEX_INIT_FAST);
+  histogram_cache= new Histogram_map;
+}
+
+
+void free_histogram_cache()
+{
+  if (histogram_cache == NULL)
+    return;
+  delete histogram_cache;
+  histogram_cache= NULL;
+  mysql_mutex_destroy(&LOCK_histograms);
+}
+
+
+void attach_histograms(TABLE_SHARE *share)
+{
+  if (histogram_cache == NULL || share->is_view ||
+      share->tmp_table != NO_TMP_TABLE)
+    return;
+
+  const std::string prefix= histogram_key(share->db.str,
+                                          share->table_name.str, "");
+
+  mysql_mutex_lock(&LOCK_histograms);
+  for (Histogram_map::const_iterator it= histogram_cache->lower_bound(prefix);
+       it != histogram_cache->end() &&
+         it->first.compare(0, prefix.size(), prefix) == 0;
+       ++it)
+  {
+    const char *column= it->first.c_str() + prefix.size();
+    Field *field= NULL;
+    for (Field **f= share->field; *f; f++)
+    {
+      if (!strcmp((*f)->field_name, column))
+      {
+        field= *f;
+        break;
+      }
+    }
+    if (field == NULL || !histogram_supports_field(field))
+      continue;
+
+    /*
+      The column may have been changed since the histogram was built,
+      so it must still have the same type.
+    */
+    const Histogram *histogram=
+      Histogram::from_json(&share->mem_root, it->second.data(),
+                           it->second.size());
+    if (histogram == NULL || histogram->get_data_type() != field->real_type())
+      continue;
+
+    if (share->histograms == NULL)
+    {
+      if (!(share->histograms= static_cast<const Histogram**>(
+              alloc_root(&share->mem_root,
+                         share->fields * sizeof(Histogram*)))))
+        break;                                  /* purecov: inspected */
+      memset(share->histograms, 0, share->fields * sizeof(Histogram*));
+    }
+    share->histograms[field->field_index]= histogram;
+  }
+  mysql_mutex_unlock(&LOCK_histograms);
+}
+
+
+void load_histograms()
+{
+  DBUG_ENTER("load_histograms");
+
+  /*
+    Like read_cost_constants(), use a THD of our own, restoring the current
+    one at the end.
+  */
+  THD *orig_thd= current_thd;
+  THD *thd= new THD;
+  thd->thread_stack= pointer_cast<char*>(&thd);
+  thd->store_globals();
+  lex_start(thd);
+
+  TABLE_LIST tables;
+  tables.init_one_table(C_STRING_WITH_LEN("mysql"),
+                        C_STRING_WITH_LEN("column_stats"),
+                        "column_stats", TL_READ);
+
+  if (!open_and_lock_tables(thd, &tables, MYSQL_LOCK_IGNORE_TIMEOUT))
+  {
+    /*
+      The table has the following columns:
+
+      database_name VARCHAR(64) NOT NULL COLLATE utf8_bin
+      table_name    VARCHAR(64) NOT NULL COLLATE utf8_bin
+      column_name   VARCHAR(64) NOT NULL COLLATE utf8_bin
+      histogram     JSON NOT NULL
+    */
+    TABLE *table= tables.table;
+    READ_RECORD read_record_info;
+    if (!init_read_record(&read_record_info, thd, table, NULL, true, true,
+                          false))
+    {
+      table->use_all_columns();
+      String db, table_name, column, histogram;
+
+      mysql_mutex_lock(&LOCK_histograms);
+      while (!read_record_info.read_record(&read_record_info))
+      {
+        table->field[0]->val_str(&db);
+        table->field[1]->val_str(&table_name);
+        table->field[2]->val_str(&column);
+        table->field[3]->val_str(&histogram);
+        (*histogram_cache)[histogram_key(db.c_ptr_safe(),
+                                         table_name.c_ptr_safe(),
+                                         column.c_ptr_safe())]=
+          std::string(histogram.ptr(), histogram.length());
+      }
+      mysql_mutex_unlock(&LOCK_histograms);
+
+      end_read_record(&read_record_info);
+    }
+  }
+  else
+  {
+    sql_print_warning("Failed to open the mysql.column_stats table, "
+                      "histograms are not used\n");
+  }
+
+  trans_commit_stmt(thd);
+  close_thread_tables(thd);
+  lex_end(thd->lex);
+  delete thd;
+
+  if (orig_thd)
+    orig_thd->store_globals();
+
+  DBUG_VOID_RETURN;
+}
+
+
+/** Opens mysql.column_stats for writing. */
+static TABLE *open_column_stats_for_update(THD *thd, TABLE_LIST *tables)
+{
+  tables->init_one_table(C_STRING_WITH_LEN("mysql"),
+                         C_STRING_WITH_LEN("column_stats"),
+                         "column_stats", TL_WRITE);
+  TABLE *table= open_ltable(thd, tables, TL_WRITE, MYSQL_LOCK_IGNORE_TIMEOUT);
+  if (table != NULL)
+    table->use_all_columns();
+  return table;
+}
+
+
+/**
+  Commits or rolls back the changes to mysql.column_stats and closes it.
+
+  @return true if there was an error before or during the commit
+*/
+static bool close_column_stats(THD *thd, bool error)
+{
+  if (error)
+  {
+    trans_rollback_stmt(thd);
+    trans_rollback(thd);
+  }
+  else
+    error= trans_commit_stmt(thd) || trans_commit(thd);
+  close_thread_tables(thd);
+  thd->mdl_context.release_transactional_locks();
+  return error;
+}
+
+
+/**
+  Positions the record of a column in mysql.column_stats.
+
+  @return 0 if the row was found and read into record[0],
+          HA_ERR_KEY_NOT_FOUND if not, or another handler error
+*/
+static int find_column_stats_row(TABLE *table, const char *db,
+                                 const char *table_name, const char *column)
+{
+  uchar key[MAX_KEY_LENGTH];
+
+  empty_record(table);
+  table->field[0]->store(db, strlen(db), system_charset_info);
+  table->field[1]->store(table_name, strlen(table_name), system_charset_info);
+  table->field[2]->store(column, strlen(column), system_charset_info);
+  key_copy(key, table->record[0], table->key_info,
+           table->key_info->key_length);
+
+  int error= table->file->ha_index_read_idx_map(table->record[0], 0, key,
+                                                HA_WHOLE_KEY,
+                                                HA_READ_KEY_EXACT);
+  return error == HA_ERR_END_OF_FILE ? HA_ERR_KEY_NOT_FOUND : error;
+}
+
+
+bool store_histograms(THD *thd, const char *db, const char *table_name,
+                      const char **columns, uint num_columns,
+                      Histogram **histograms)
+{
+  TABLE_LIST tables;
+  String json;
+  bool error= false;
+  DBUG_ENTER("store_histograms");
+
+  TABLE *table= open_column_stats_for_update(thd, &tables);
+  if (table == NULL)
+    DBUG_RETURN(true);
+
+  /* ANALYZE TABLE is logged as a statement instead of the changed rows. */
+  tmp_disable_binlog(thd);
+  for (uint i= 0; i < num_columns && !error; i++)
+  {
+    json.length(0);
+    if ((error= histograms[i]->to_json(&json)))
+      break;                                    /* purecov: inspected */
+
+    int res= find_column_stats_row(table, db, table_name, columns[i]);
+    if (res == 0)
+    {
+      store_record(table, record[1]);
+      table->field[3]->store(json.ptr(), json.length(), json.charset());
+      res= table->file->ha_update_row(table->record[1], table->record[0]);
+      if (res == HA_ERR_RECORD_IS_THE_SAME)
+        res= 0;
+    }
+    else if (res == HA_ERR_KEY_NOT_FOUND)
+    {
+      /* find_column_stats_row() overwrote the key columns. */
+      empty_record(table);
+      table->field[0]->store(db, strlen(db), system_charset_info);
+      table->field[1]->store(table_name, strlen(table_name),
+                             system_charset_info);
+      table->field[2]->store(columns[i], strlen(columns[i]),
+                             system_charset_info);
+      table->field[3]->store(json.ptr(), json.length(), json.charset());
+      res= table->file->ha_write_row(table->record[0]);
+    }
+    if (res)
+    {
+      table->file->print_error(res, MYF(0));
+      error= true;
+    }
+  }
+  reenable_binlog(thd);
+
+  if (close_column_stats(thd, error))
+    DBUG_RETURN(true);
+
+  /*
+    Publish the new histograms, then make the table reopen its share to
+    pick them up. Shares in use keep the old histograms until they are
+    released.
+  */
+  mysql_mutex_lock(&LOCK_histograms);
+  for (uint i= 0; i < num_columns; i++)
+  {
+    json.length(0);
+    histograms[i]->to_json(&json);
+    (*histogram_cache)[histogram_key(db, table_name, columns[i])]=
+      std::string(json.ptr(), json.length());
+  }
+  mysql_mutex_unlock(&LOCK_histograms);
+  tdc_remove_table(thd, TDC_RT_REMOVE_UNUSED, db, table_name, false);
+
+  DBUG_RETURN(false);
+}
+
+
+bool drop_histograms(THD *thd, const char *db, const char *table_name,
+                     const char **columns, uint num_columns, bool *dropped)
+{
+  TABLE_LIST tables;
+  bool error= false;
+  DBUG_ENTER("drop_histograms");
+
+  TABLE *table= open_column_stats_for_update(thd, &tables);
+  if (table == NULL)
+    DBUG_RETURN(true);
+
+  tmp_disable_binlog(thd);
+  for (uint i= 0; i < num_columns; i++)
+  {
+    int res= find_column_stats_row(table, db, table_name, columns[i]);
+    dropped[i]= res == 0;
+    if (res == 0)
+      res= table->file->ha_delete_row(table->record[0]);
+    if (res && res != HA_ERR_KEY_NOT_FOUND)
+    {
+      table->file->print_error(res, MYF(0));
+      error= true;
+      break;
+    }
+  }
+  reenable_binlog(thd);
+
+  if (close_column_stats(thd, error))
+    DBUG_RETURN(true);
+
+  mysql_mutex_lock(&LOCK_histograms);
+  for (uint i= 0; i < num_columns; i++)
+    histogram_cache->erase(histogram_key(db, table_name, columns[i]));
+  mysql_mutex_unlock(&LOCK_histograms);
+  tdc_remove_table(thd, TDC_RT_REMOVE_UNUSED, db, table_name, false);
+
+  DBUG_RETURN(false);
+}
+
+
+/**
+  Collects the names of the rows of mysql.column_stats of a database or
+  of a table.
+
+  @param      table        mysql.column_stats
+  @param      db           the database
+  @param      table_name   the table, or NULL for all tables of db
+  @param[out] names        table and column names of the rows
+
+  @return 0, or a handler error
+*/
+static int find_column_stats_rows(TABLE *table, const char *db,
+                                  const char *table_name,
+                                  std::vector<std::pair<std::string,
+                                                        std::string> > *names)
+{
+  uchar key[MAX_KEY_LENGTH];
+  const key_part_map keypart_map= table_name != NULL ? 3 : 1;
+  String value;
+  int error;
+
+  empty_record(table);
+  table->field[0]->store(db, strlen(db), system_charset_info);
+  if (table_name != NULL)
+    table->field[1]->store(table_name, strlen(table_name),
+                           system_charset_info);
+  key_copy(key, table->record[0], table->key_info,
+           table->key_info->key_length);
+  const uint key_len= calculate_key_len(table, 0, keypart_map);
+
+  if ((error= table->file->ha_index_init(0, true)))
+    return error;
+  error= table->file->ha_index_read_map(table->record[0], key, keypart_map,
+                                        HA_READ_KEY_EXACT);
+  while (!error)
+  {
+    table->field[1]->val_str(&value);
+    std::string name(value.ptr(), value.length());
+    table->field[2]->val_str(&value);
+    names->push_back(std::make_pair(name,
+                                    std::string(value.ptr(),
+                                                value.length())));
+    error= table->file->ha_index_next_same(table->record[0], key, key_len);
+  }
+  table->file->ha_index_end();
+  return error == HA_ERR_END_OF_FILE || error == HA_ERR_KEY_NOT_FOUND ?
+         0 : error;
+}
+
+
+/**
+  Deletes or renames the histograms of a database or of a table in
+  mysql.column_stats and in the histogram cache.
+
+  The rows are changed by a THD of our own, like load_histograms() reads
+  them, so that the transaction and the LOCK TABLES state of the DDL
+  statement are left alone. A failure is only logged, since the DDL
+  statement has already been done.
+
+  @param db          the database
+  @param table_name  the table, or NULL for all tables of db
+  @param new_db      database to move the histograms to, or NULL to
+                     delete them
+  @param new_name    table to move the histograms to
+*/
+static void change_histograms(const char *db, const char *table_name,
+                              const char *new_db, const char *new_name)
+{
+  DBUG_ENTER("change_histograms");
+  if (histogram_cache == NULL)
+    DBUG_VOID_RETURN;
+
+  std::string prefix(db);
+  prefix.push_back('\0');
+  if (table_name != NULL)
+  {
+    prefix.append(table_name);
+    prefix.push_back('\0');
+  }
+
+  /*
+    Every row of mysql.column_stats is in the cache, so most tables are
+    dropped or renamed without opening mysql.column_stats.
+  */
+  mysql_mutex_lock(&LOCK_histograms);
+  Histogram_map::iterator it= histogram_cache->lower_bound(prefix);
+  const bool found= it != histogram_cache->end() &&
+                    it->first.compare(0, prefix.size(), prefix) == 0;
+  mysql_mutex_unlock(&LOCK_histograms);
+  if (!found)
+    DBUG_VOID_RETURN;
+
+  THD *orig_thd= current_thd;
+  THD *thd= new THD;
+  thd->thread_stack= pointer_cast<char*>(&thd);
+  thd->store_globals();
+  lex_start(thd);
+
+  TABLE_LIST tables;
+  bool error= true;
+  TABLE *table= open_column_stats_for_update(thd, &tables);
+  if (table != NULL)
+  {
+    std::vector<std::pair<std::string, std::string> > names;
+    int res= find_column_stats_rows(table, db, table_name, &names);
+
+    tmp_disable_binlog(thd);
+    for (size_t i= 0; i < names.size() && !res; i++)
+    {
+      res= find_column_stats_row(table, db, names[i].first.c_str(),
+                                 names[i].second.c_str());
+      if (res == HA_ERR_KEY_NOT_FOUND)
+      {
+        res= 0;
+        continue;
+      }
+      if (res)
+        break;
+      if (new_db == NULL)
+      {
+        res= table->file->ha_delete_row(table->record[0]);
+        continue;
+      }
+      store_record(table, record[1]);
+      table->field[0]->store(new_db, strlen(new_db), system_charset_info);
+      table->field[1]->store(new_name, strlen(new_name),
+                             system_charset_info);
+      res= table->file->ha_update_row(table->record[1], table->record[0]);
+    }
+    reenable_binlog(thd);
+
+    if (res)
+      table->file->print_error(res, MYF(0));
+    error= close_column_stats(thd, res != 0);
+  }
+  if (error)
+    sql_print_warning("Failed to %s the histograms of %s%s%s in "
+                      "mysql.column_stats: %s",
+                      new_db == NULL ? "remove" : "rename", db,
+                      table_name != NULL ? "." : "",
+                      table_name != NULL ? table_name : "",
+                      thd->get_stmt_da()->is_error() ?
+                      thd->get_stmt_da()->message_text() : "");
+
+  lex_end(thd->lex);
+  delete thd;
+  if (orig_thd)
+    orig_thd->store_globals();
+
+  /* The table is gone or renamed whatever happened above. */
+  mysql_mutex_lock(&LOCK_histograms);
+  it= histogram_cache->lower_bound(prefix);
+  while (it != histogram_cache->end() &&
+         it->first.compare(0, prefix.size(), prefix) == 0)
+  {
+    if (new_db != NULL)
+    {
+      const char *column= it->first.c_str() + prefix.size();
+      (*histogram_cache)[histogram_key(new_db, new_name, column)]=
+        it->second;
+    }
+    histogram_cache->erase(it++);
+  }
+  mysql_mutex_unlock(&LOCK_histograms);
+
+  DBUG_VOID_RETURN;
+}
+
+
+void drop_table_histograms(const char *db, const char *table_name)
+{
+  change_histograms(db, table_name, NULL, NULL);
+}
+
+
+void drop_database_histograms(const char *db)
+{
+  change_histograms(db, NULL, NULL, NULL);
+}
+
+
+void rename_table_histograms(const char *db, const char *table_name,
+                             const char *new_db, const char *new_name)
+{
+  change_histograms(db, table_name, new_db, new_name);
+}
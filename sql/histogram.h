@@ -0,0 +1,272 @@
+/* Copyright (c) 2018 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef HISTOGRAM_INCLUDED
+#define HISTOGRAM_INCLUDED
+
+/**
+  @file sql/histogram.h
+
+  Column value histograms for the optimizer.
+
+  A histogram describes the distribution of the values of one column. It
+  is built by ANALYZE TABLE ... UPDATE HISTOGRAM ON from a sample of the
+  rows, stored as JSON in mysql.column_stats, and attached to the
+  TABLE_SHARE of the table when the share is opened. Condition filtering
+  and the range optimizer then use it instead of the fixed COND_FILTER_*
+  guesses for columns that have no index statistics.
+
+  Values are mapped to doubles: numbers by their value, temporal values
+  by their packed longlong representation, which keeps their order.
+  String, ENUM, SET, BIT, JSON and spatial columns are not supported.
+*/
+
+#include "my_global.h"
+#include "my_alloc.h"                           // MEM_ROOT
+#include "sql_alloc.h"                          // Sql_alloc
+
+class Field;
+class Item;
+class String;
+class THD;
+struct TABLE;
+struct TABLE_SHARE;
+
+/** Number of buckets if ANALYZE TABLE does not specify one */
+static const uint HISTOGRAM_DEFAULT_BUCKETS= 100;
+/** Largest number of buckets of a histogram */
+static const uint HISTOGRAM_MAX_BUCKETS= 1024;
+
+
+class Histogram : public Sql_alloc
+{
+public:
+  enum enum_histogram_type
+  {
+    /** One bucket for each distinct value */
+    SINGLETON,
+    /** Buckets holding about the same number of rows each */
+    EQUI_HEIGHT
+  };
+
+  struct Bucket
+  {
+    /** Smallest value in the bucket, equal to upper in singletons */
+    double lower;
+    /** Largest value in the bucket */
+    double upper;
+    /** Fraction of all rows, NULLs included, with a value <= upper */
+    double cumulative_frequency;
+    /** Number of distinct values in the bucket */
+    double distinct_values;
+  };
+
+  /**
+    Builds a histogram from a sample of the values of a column.
+
+    A singleton histogram is built if the sample has no more distinct
+    values than max_buckets, otherwise an equi-height one. Equal values
+    never span two buckets of an equi-height histogram, so it may have
+    fewer buckets than asked for, and a value that is frequent enough gets
+    a bucket of its own.
+
+    @param mem_root      memory for the histogram
+    @param values        non-NULL values of the sample; sorted in place
+    @param num_values    number of elements in values
+    @param num_nulls     number of NULL values in the sample
+    @param max_buckets   largest number of buckets to use
+    @param data_type     real_type() of the column
+
+    @return the histogram, or NULL if out of memory
+  */
+  static Histogram *build(MEM_ROOT *mem_root, double *values,
+                          size_t num_values, size_t num_nulls,
+                          uint max_buckets, int data_type);
+
+  /**
+    Creates a histogram from the JSON text written by to_json().
+
+    @return the histogram, or NULL if the text is not a valid histogram
+            or out of memory
+  */
+  static Histogram *from_json(MEM_ROOT *mem_root, const char *text,
+                              size_t length);
+
+  /**
+    Appends the histogram as a JSON object to str.
+
+    @return true if out of memory
+  */
+  bool to_json(String *str) const;
+
+  enum_histogram_type get_type() const { return m_type; }
+  uint get_num_buckets() const { return m_num_buckets; }
+  const Bucket *get_bucket(uint i) const { return m_buckets + i; }
+  int get_data_type() const { return m_data_type; }
+
+  /** @return fraction of the rows that are NULL */
+  double get_null_values_fraction() const { return m_null_values; }
+
+  /** @return fraction of the rows that are not NULL */
+  double get_non_null_values_fraction() const
+  { return 1.0 - m_null_values; }
+
+  /*
+    Fractions of all rows, NULLs included, whose value compares as
+    named with the given value.
+  */
+  double get_equal_to_selectivity(double value) const;
+  double get_less_than_selectivity(double value) const;
+  double get_less_than_equal_selectivity(double value) const;
+  double get_greater_than_selectivity(double value) const;
+  double get_greater_than_equal_selectivity(double value) const;
+  double get_between_selectivity(double low, double high) const;
+
+private:
+  Histogram()
+    : m_type(SINGLETON), m_buckets(NULL), m_num_buckets(0),
+      m_null_values(0.0), m_data_type(0)
+  {}
+
+  /** @return the first bucket whose upper bound is >= value, or NULL */
+  const Bucket *find_bucket(double value) const;
+
+  /** @return cumulative frequency of the bucket before b */
+  double frequency_before(const Bucket *b) const
+  { return b == m_buckets ? 0.0 : b[-1].cumulative_frequency; }
+
+  enum_histogram_type m_type;
+  Bucket *m_buckets;
+  uint m_num_buckets;
+  double m_null_values;
+  int m_data_type;
+};
+
+
+/** @return whether a histogram can be built for the column */
+bool histogram_supports_field(const Field *field);
+
+/** @return the value of a non-NULL field as a histogram value */
+double histogram_field_value(Field *field);
+
+/**
+  Evaluates a constant item compared with field as a histogram value.
+
+  @param      field   column the histogram is for
+  @param      item    constant the column is compared with
+  @param[out] value   the value of item
+
+  @return true if the item can not be used, e.g. because it is NULL or
+          too expensive to evaluate during optimization
+*/
+bool histogram_item_value(const Field *field, Item *item, double *value);
+
+/**
+  @return the histogram of the column, or NULL if it has none or the
+          optimizer_switch flag histograms is off
+*/
+const Histogram *get_histogram(THD *thd, const Field *field);
+
+/**
+  Estimates the fraction of the rows of a table that lie in a range of
+  a column, given as key images like those of SEL_ARG.
+
+  @param      thd           thread handle
+  @param      field         the column
+  @param      min_key       image of the lower bound, or NULL if none
+  @param      include_min   whether the lower bound is in the range
+  @param      max_key       image of the upper bound, or NULL if none
+  @param      include_max   whether the upper bound is in the range
+  @param[out] selectivity   the fraction of rows
+
+  @return true if the column has no histogram
+*/
+bool get_histogram_range_selectivity(THD *thd, Field *field,
+                                     const uchar *min_key, bool include_min,
+                                     const uchar *max_key, bool include_max,
+                                     double *selectivity);
+
+/**
+  Builds histograms of columns of a table by sampling its rows.
+
+  @param      thd          thread handle
+  @param      table        open and locked table
+  @param      fields       columns to build histograms for
+  @param      num_fields   number of columns
+  @param      num_buckets  largest number of buckets per histogram
+  @param      mem_root     memory for the histograms
+  @param[out] histograms   one histogram for each column
+
+  @return true on error, which has been reported
+*/
+bool build_histograms(THD *thd, TABLE *table, Field **fields,
+                      uint num_fields, uint num_buckets, MEM_ROOT *mem_root,
+                      Histogram **histograms);
+
+/**
+  Writes histograms to mysql.column_stats and to the histogram cache.
+  The new histograms are used by the table once its TABLE_SHARE is
+  reopened, which is forced by removing the share from the table
+  definition cache.
+
+  @param thd          thread handle
+  @param db           database of the table
+  @param table_name   name of the table
+  @param columns      names of the columns
+  @param num_columns  number of columns
+  @param histograms   one histogram for each column
+
+  @return true on error, which has been reported
+*/
+bool store_histograms(THD *thd, const char *db, const char *table_name,
+                      const char **columns, uint num_columns,
+                      Histogram **histograms);
+
+/**
+  Removes the histograms of columns of a table from mysql.column_stats
+  and from the histogram cache.
+
+  @param      thd          thread handle
+  @param      db           database of the table
+  @param      table_name   name of the table
+  @param      columns      names of the columns
+  @param      num_columns  number of columns
+  @param[out] dropped      whether each column had a histogram
+
+  @return true on error, which has been reported
+*/
+bool drop_histograms(THD *thd, const char *db, const char *table_name,
+                     const char **columns, uint num_columns, bool *dropped);
+
+/*
+  Remove or rename the histograms of dropped or renamed tables, in
+  mysql.column_stats and in the histogram cache. Errors are written to
+  the error log only.
+*/
+void drop_table_histograms(const char *db, const char *table_name);
+void drop_database_histograms(const char *db);
+void rename_table_histograms(const char *db, const char *table_name,
+                             const char *new_db, const char *new_name);
+
+/** Sets TABLE_SHARE::histograms from the histogram cache. */
+void attach_histograms(TABLE_SHARE *share);
+
+void init_histogram_cache();
+/** Reads mysql.column_stats into the histogram cache at startup. */
+void load_histograms();
+void free_histogram_cache();
+
+#endif /* HISTOGRAM_INCLUDED */
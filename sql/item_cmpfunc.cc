@@ -35,6 +35,7 @@
 using std::min;
 using std::max;
 #include "aggregate_check.h"
+#include "histogram.h"                 // get_histogram
 
 static bool convert_constant_item(THD *, Item_field *, Item **);
 static longlong
@@ -805,6 +806,10 @@ int Arg_comparator::set_compare_func(Item_result_field *item, Item_result type)
                &Arg_comparator::compare_int_unsigned_signed);
       else if ((*b)->unsigned_flag)
         func= &Arg_comparator::compare_int_signed_unsigned;
+
+      if (func == &Arg_comparator::compare_int_signed ||
+          func == &Arg_comparator::compare_int_unsigned_signed)
+        (void) try_int_field_cmp_func();
     }
     else if (func== &Arg_comparator::compare_e_int)
     {
@@ -1860,6 +1865,169 @@ int Arg_comparator::compare_int_signed()
 }
 
 
+#ifndef WORDS_BIGENDIAN
+namespace {
+
+/*
+  Readers of the raw value of integer fields for compare_int_field().
+  They must return what Field::val_int() returns for the same field type.
+*/
+
+longlong read_int_field_tiny(const uchar *ptr)
+{
+  return (longlong) ((signed char*) ptr)[0];
+}
+
+longlong read_int_field_utiny(const uchar *ptr)
+{
+  return (longlong) ptr[0];
+}
+
+longlong read_int_field_short(const uchar *ptr)
+{
+  short j;
+  shortget(&j, ptr);
+  return (longlong) j;
+}
+
+longlong read_int_field_ushort(const uchar *ptr)
+{
+  short j;
+  shortget(&j, ptr);
+  return (longlong) (unsigned short) j;
+}
+
+longlong read_int_field_medium(const uchar *ptr)
+{
+  return (longlong) sint3korr(ptr);
+}
+
+longlong read_int_field_umedium(const uchar *ptr)
+{
+  return (longlong) uint3korr(ptr);
+}
+
+longlong read_int_field_long(const uchar *ptr)
+{
+  int32 j;
+  longget(&j, ptr);
+  return (longlong) j;
+}
+
+longlong read_int_field_ulong(const uchar *ptr)
+{
+  int32 j;
+  longget(&j, ptr);
+  return (longlong) (uint32) j;
+}
+
+longlong read_int_field_longlong(const uchar *ptr)
+{
+  longlong j;
+  longlongget(&j, ptr);
+  return j;
+}
+
+} // namespace
+#endif
+
+
+/**
+  Choose compare_int_field() for comparisons of an integer column with a
+  signed integer value, the most common form of WHERE predicates.
+
+  The column value is then read straight from the record buffer instead
+  of through Item_field::val_int() and Field::val_int(). Unsigned BIGINT
+  columns are left to the generic functions, as their values do not fit
+  into a longlong.
+
+  @return true if a specialized function was chosen
+*/
+
+bool Arg_comparator::try_int_field_cmp_func()
+{
+  DBUG_ASSERT(!(*b)->unsigned_flag);
+#ifdef WORDS_BIGENDIAN
+  /* Fields of tables with db_low_byte_first need other readers. */
+  return false;
+#else
+  if ((*a)->type() != Item::FIELD_ITEM)
+    return false;
+
+  Item_field *item= static_cast<Item_field*>(*a);
+  const bool is_unsigned= item->field->flags & UNSIGNED_FLAG;
+
+  switch (item->field->real_type())
+  {
+  case MYSQL_TYPE_TINY:
+    func= is_unsigned ?
+          &Arg_comparator::compare_int_field<read_int_field_utiny> :
+          &Arg_comparator::compare_int_field<read_int_field_tiny>;
+    break;
+  case MYSQL_TYPE_SHORT:
+    func= is_unsigned ?
+          &Arg_comparator::compare_int_field<read_int_field_ushort> :
+          &Arg_comparator::compare_int_field<read_int_field_short>;
+    break;
+  case MYSQL_TYPE_INT24:
+    func= is_unsigned ?
+          &Arg_comparator::compare_int_field<read_int_field_umedium> :
+          &Arg_comparator::compare_int_field<read_int_field_medium>;
+    break;
+  case MYSQL_TYPE_LONG:
+    func= is_unsigned ?
+          &Arg_comparator::compare_int_field<read_int_field_ulong> :
+          &Arg_comparator::compare_int_field<read_int_field_long>;
+    break;
+  case MYSQL_TYPE_LONGLONG:
+    if (is_unsigned)
+      return false;
+    func= &Arg_comparator::compare_int_field<read_int_field_longlong>;
+    break;
+  default:
+    return false;
+  }
+  int_field_item= item;
+  return true;
+#endif
+}
+
+
+/**
+  Compare an integer column with a signed integer value, reading the
+  column value with read_field.
+
+  The argument can be replaced after the comparator is set up, e.g. by
+  an Item_ref or a cache, in which case the generic function is used.
+*/
+
+template <longlong (*read_field)(const uchar *)>
+int Arg_comparator::compare_int_field()
+{
+  if (*a != int_field_item)
+    return (*a)->unsigned_flag ? compare_int_unsigned_signed() :
+                                 compare_int_signed();
+
+  Field *field= int_field_item->field;
+  if (!(int_field_item->null_value= field->is_null()))
+  {
+    const longlong val1= read_field(field->ptr);
+    const longlong val2= (*b)->val_int();
+    if (!(*b)->null_value)
+    {
+      if (set_null)
+        owner->null_value= 0;
+      if (val1 < val2)	return -1;
+      if (val1 == val2)   return 0;
+      return 1;
+    }
+  }
+  if (set_null)
+    owner->null_value= 1;
+  return -1;
+}
+
+
 /**
   Compare arguments using numeric packed temporal representation.
 */
@@ -2523,6 +2691,95 @@ longlong Item_func_equal::val_int()
   return cmp.compare();
 }
 
+/**
+  Estimates from the histogram of a column the fraction of rows for which
+  a comparison of the column with constants holds.
+
+  @param      fld            column compared
+  @param      type           EQ_FUNC, EQUAL_FUNC, NE_FUNC, LT_FUNC, LE_FUNC,
+                             GE_FUNC, GT_FUNC, BETWEEN, ISNULL_FUNC or
+                             ISNOTNULL_FUNC, with the column as the first
+                             operand
+  @param      value          value the column is compared with, if any
+  @param      value2         upper bound of BETWEEN
+  @param      rows_in_table  number of rows in the table
+  @param[out] filter         the filtering effect
+
+  @return true if the column has no histogram or the values can not be
+          used during optimization
+*/
+static bool histogram_filter(const Item_field *fld, Item_func::Functype type,
+                             Item *value, Item *value2,
+                             double rows_in_table, float *filter)
+{
+  const Field *field= fld->field;
+  const Histogram *histogram= get_histogram(current_thd, field);
+  double v1= 0.0, v2= 0.0;
+  if (histogram == NULL ||
+      (value != NULL && histogram_item_value(field, value, &v1)) ||
+      (value2 != NULL && histogram_item_value(field, value2, &v2)))
+    return true;
+
+  double selectivity;
+  switch (type)
+  {
+  case Item_func::EQ_FUNC:
+  case Item_func::EQUAL_FUNC:
+    selectivity= histogram->get_equal_to_selectivity(v1);
+    break;
+  case Item_func::NE_FUNC:
+    selectivity= histogram->get_non_null_values_fraction() -
+      histogram->get_equal_to_selectivity(v1);
+    break;
+  case Item_func::LT_FUNC:
+    selectivity= histogram->get_less_than_selectivity(v1);
+    break;
+  case Item_func::LE_FUNC:
+    selectivity= histogram->get_less_than_equal_selectivity(v1);
+    break;
+  case Item_func::GE_FUNC:
+    selectivity= histogram->get_greater_than_equal_selectivity(v1);
+    break;
+  case Item_func::GT_FUNC:
+    selectivity= histogram->get_greater_than_selectivity(v1);
+    break;
+  case Item_func::BETWEEN:
+    selectivity= histogram->get_between_selectivity(v1, v2);
+    break;
+  case Item_func::ISNULL_FUNC:
+    selectivity= histogram->get_null_values_fraction();
+    break;
+  case Item_func::ISNOTNULL_FUNC:
+    selectivity= histogram->get_non_null_values_fraction();
+    break;
+  default:
+    return true;
+  }
+
+  /*
+    Values that are missing from the sample may still exist, so never
+    estimate that no row at all qualifies.
+  */
+  *filter= static_cast<float>(std::min(std::max(selectivity,
+                                                1.0 / rows_in_table), 1.0));
+  return false;
+}
+
+
+bool Item_bool_func2::get_histogram_filter(const Item_field *fld,
+                                           double rows_in_table,
+                                           float *filter) const
+{
+  // "5 < col" is "col > 5"
+  const bool field_first= args[0]->real_item() == fld;
+  Functype type= functype();
+  if (!field_first && have_rev_func())
+    type= rev_functype();
+  return histogram_filter(fld, type, args[field_first ? 1 : 0], NULL,
+                          rows_in_table, filter);
+}
+
+
 float Item_func_ne::get_filtering_effect(table_map filter_for_table,
                                          table_map read_tables,
                                          const MY_BITMAP *fields_to_ignore,
@@ -2533,6 +2790,10 @@ float Item_func_ne::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!get_histogram_filter(fld, rows_in_table, &filter))
+    return filter;
+
   return 1.0f - fld->get_cond_filter_default_probability(rows_in_table,
                                                          COND_FILTER_EQUALITY);
 }
@@ -2554,6 +2815,10 @@ float Item_func_equal::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!get_histogram_filter(fld, rows_in_table, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_EQUALITY);
 }
@@ -2568,6 +2833,10 @@ float Item_func_ge::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!get_histogram_filter(fld, rows_in_table, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -2582,6 +2851,10 @@ float Item_func_lt::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!get_histogram_filter(fld, rows_in_table, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -2596,6 +2869,10 @@ float Item_func_le::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!get_histogram_filter(fld, rows_in_table, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -2610,6 +2887,10 @@ float Item_func_gt::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!get_histogram_filter(fld, rows_in_table, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -3097,9 +3378,12 @@ Item_func_between::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
-  const float filter=
-    fld->get_cond_filter_default_probability(rows_in_table,
-                                             COND_FILTER_BETWEEN);
+  float filter;
+  if (args[0]->real_item() != fld ||
+      histogram_filter(fld, BETWEEN, args[1], args[2], rows_in_table,
+                       &filter))
+    filter= fld->get_cond_filter_default_probability(rows_in_table,
+                                                     COND_FILTER_BETWEEN);
 
   return negated ? 1.0f - filter : filter;
 }
@@ -5198,7 +5482,27 @@ float Item_func_in::get_filtering_effect(table_map filter_for_table,
       arg_count includes the left hand side item
     */
     if (tmp_filt != COND_FILTER_ALLPASS)
+    {
       filter= min((arg_count - 1) * tmp_filt, in_max_filter);
+
+      /*
+        A histogram of the column estimates each value of the list,
+        which makes in_max_filter unnecessary.
+      */
+      const Item_field *fld= static_cast<Item_field*>(args[0]->real_item());
+      float histogram_sum= 0.0f;
+      uint i;
+      for (i= 1; i < arg_count; i++)
+      {
+        float value_filter;
+        if (histogram_filter(fld, EQ_FUNC, args[i], NULL, rows_in_table,
+                             &value_filter))
+          break;
+        histogram_sum+= value_filter;
+      }
+      if (i == arg_count)
+        filter= min(histogram_sum, 1.0f);
+    }
   }
 
   if (negated && filter != COND_FILTER_ALLPASS)
@@ -6289,6 +6593,11 @@ float Item_func_isnull::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!histogram_filter(fld, ISNULL_FUNC, NULL, NULL, rows_in_table,
+                        &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_EQUALITY);
 }
@@ -6363,6 +6672,11 @@ Item_func_isnotnull::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!histogram_filter(fld, ISNOTNULL_FUNC, NULL, NULL, rows_in_table,
+                        &filter))
+    return filter;
+
   return 1.0f - fld->get_cond_filter_default_probability(rows_in_table,
                                                          COND_FILTER_EQUALITY);
 }
@@ -7526,8 +7840,13 @@ float Item_equal::get_filtering_effect(table_map filter_for_table,
           cur_field->get_cond_filter_default_probability(rows_in_table,
                                                          COND_FILTER_EQUALITY);
 
+        // Use the histogram of the column if equal to a constant
+        const bool histogram_used=
+          const_item && !histogram_filter(cur_field, EQ_FUNC, const_item,
+                                          NULL, rows_in_table, &cur_filter);
+
         // Use index statistics if available for this field
-        if (!cur_field->field->key_start.is_clear_all())
+        if (!histogram_used && !cur_field->field->key_start.is_clear_all())
         { 
           // cur_field is indexed - there may be statistics for it.
           const TABLE *tab= cur_field->field->table;
@@ -7939,6 +8258,10 @@ float Item_func_eq::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (!get_histogram_filter(fld, rows_in_table, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_EQUALITY);
 }
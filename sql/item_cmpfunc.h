@@ -61,6 +61,13 @@ class Arg_comparator: public Sql_alloc
     SQL value to a JSON value.
   */
   Json_scalar_holder *json_scalar;
+  /**
+    Integer column compared by compare_int_field(). The raw field value
+    is read directly as long as *a still points to this item.
+  */
+  Item_field *int_field_item;
+  bool try_int_field_cmp_func();
+  template <longlong (*read_field)(const uchar *)> int compare_int_field();
 public:
   DTCollation cmp_collation;
   /* Allow owner function to use string buffers. */
@@ -68,12 +75,14 @@ public:
 
   Arg_comparator(): comparators(0), comparator_count(0),
     a_cache(0), b_cache(0), set_null(TRUE),
-    get_value_a_func(0), get_value_b_func(0), json_scalar(0)
+    get_value_a_func(0), get_value_b_func(0), json_scalar(0),
+    int_field_item(0)
   {}
   Arg_comparator(Item **a1, Item **a2): a(a1), b(a2),
     comparators(0), comparator_count(0),
     a_cache(0), b_cache(0), set_null(TRUE),
-    get_value_a_func(0), get_value_b_func(0), json_scalar(0)
+    get_value_a_func(0), get_value_b_func(0), json_scalar(0),
+    int_field_item(0)
   {}
 
   int set_compare_func(Item_result_field *owner, Item_result type);
@@ -475,6 +484,21 @@ public:
   }
 
   friend class  Arg_comparator;
+
+protected:
+  /**
+    Estimates the filtering effect of comparing a column with a constant
+    from the histogram of the column.
+
+    @param      fld            the column, as returned by
+                               contributes_to_filter()
+    @param      rows_in_table  number of rows in the table
+    @param[out] filter         the filtering effect
+
+    @return true if there is no histogram to use
+  */
+  bool get_histogram_filter(const Item_field *fld, double rows_in_table,
+                            float *filter) const;
 };
 
 class Item_bool_rowready_func2 :public Item_bool_func2
@@ -630,6 +654,9 @@ public:
   const char *func_name() const { return "<if>"; };
   bool const_item() const { return FALSE; }
   bool *get_trig_var() { return trig_var; }
+  enum_trig_type get_trig_type() const { return trig_type; }
+  /// Index of the table which is the source of trig_var, if any
+  plan_idx idx() const { return m_idx; }
   /* The following is needed for ICP: */
   table_map used_tables() const { return args[0]->used_tables(); }
   void print(String *str, enum_query_type query_type);
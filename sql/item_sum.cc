@@ -950,7 +950,7 @@ bool Aggregator_distinct::setup(THD *thd)
       }
       DBUG_ASSERT(tree == 0);
       tree= new Unique(compare_key, cmp_arg, tree_key_length,
-                       item_sum->ram_limitation(thd));
+                       item_sum->ram_limitation(thd), all_binary);
       /*
         The only time tree_key_length could be 0 is if someone does
         count(distinct) on a char(0) field - stupid thing to do,
@@ -1020,7 +1020,7 @@ bool Aggregator_distinct::setup(THD *thd)
       are converted to binary representation as well.
     */
     tree= new Unique(simple_raw_key_cmp, &tree_key_length, tree_key_length,
-                     item_sum->ram_limitation(thd));
+                     item_sum->ram_limitation(thd), true);
 
     DBUG_RETURN(tree == 0);
   }
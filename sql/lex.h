@@ -103,6 +103,7 @@ static const SYMBOL symbols[] = {
   { SYM("BOOLEAN",                  BOOLEAN_SYM)},
   { SYM("BOTH",                     BOTH)},
   { SYM("BTREE",                    BTREE_SYM)},
+  { SYM("BUCKETS",                  BUCKETS_SYM)},
   { SYM("BY",                       BY)},
   { SYM("BYTE",                     BYTE_SYM)},
   { SYM("CACHE",                    CACHE_SYM)},
@@ -270,6 +271,7 @@ static const SYMBOL symbols[] = {
   { SYM("GROUP",                    GROUP_SYM)},
   { SYM("HANDLER",                  HANDLER_SYM)},
   { SYM("HASH",                     HASH_SYM)},
+  { SYM("HISTOGRAM",                HISTOGRAM_SYM)},
   { SYM("HAVING",                   HAVING)},
   { SYM("HELP",                     HELP_SYM)},
   { SYM("HIGH_PRIORITY",            HIGH_PRIORITY)},
@@ -750,12 +752,14 @@ static const SYMBOL symbols[] = {
   { SYM_H("BNL",                    BNL_HINT)},
   { SYM_H("DUPSWEEDOUT",            DUPSWEEDOUT_HINT)},
   { SYM_H("FIRSTMATCH",             FIRSTMATCH_HINT)},
+  { SYM_H("HASH_JOIN",              HASH_JOIN_HINT)},
   { SYM_H("INTOEXISTS",             INTOEXISTS_HINT)},
   { SYM_H("LOOSESCAN",              LOOSESCAN_HINT)},
   { SYM_H("MATERIALIZATION",        MATERIALIZATION_HINT)},
   { SYM_H("MAX_EXECUTION_TIME",     MAX_EXECUTION_TIME_HINT)},
   { SYM_H("NO_BKA",                 NO_BKA_HINT)},
   { SYM_H("NO_BNL",                 NO_BNL_HINT)},
+  { SYM_H("NO_HASH_JOIN",           NO_HASH_JOIN_HINT)},
   { SYM_H("NO_ICP",                 NO_ICP_HINT)},
   { SYM_H("NO_MRR",                 NO_MRR_HINT)},
   { SYM_H("NO_RANGE_OPTIMIZATION",  NO_RANGE_OPTIMIZATION_HINT)},
@@ -461,6 +461,28 @@ public:
 
   typedef longlong fast_path_state_t;
 
+  /**
+    Number of shards of the "fast path" counters of MDL_lock objects
+    which have them (@sa MDL_lock::HAS_SHARDS).
+  */
+  static const uint FAST_PATH_SHARDS= 16;
+
+  /**
+    Number of failed compare-and-swap operations on m_fast_path_state
+    during "fast path" acquisition after which a table lock gets shards.
+  */
+  static const int32 FAST_PATH_SHARDING_THRESHOLD= 1000;
+
+  /**
+    One shard of the "fast path" counters, packed in the same way as
+    in m_fast_path_state, and padded to a cache line of its own.
+  */
+  struct Fast_path_shard
+  {
+    volatile fast_path_state_t m_state;
+    char m_pad[64 - sizeof(fast_path_state_t)];
+  };
+
   /**
     Helper struct which defines how different types of locks are handled
     for a specific MDL_lock. In practice we use only two strategies: "scoped"
@@ -806,7 +828,8 @@ public:
     MDL_lock::reinit(). So @sa MDL_lock::reiniti()
   */
   MDL_lock()
-    : m_obtrusive_locks_granted_waiting_count(0)
+    : m_obtrusive_locks_granted_waiting_count(0),
+      m_fast_path_shards(NULL)
   {
     mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock);
   }
@@ -816,6 +839,7 @@ public:
   ~MDL_lock()
   {
     mysql_prlock_destroy(&m_rwlock);
+    delete [] m_fast_path_shards;
   }
 
   inline static MDL_lock *create(const MDL_key *key);
@@ -872,6 +896,35 @@ public:
     synchronized with contents of MDL_lock::m_granted/m_waiting lists.
   */
   static const fast_path_state_t HAS_SLOW_PATH= 1ULL << 60;
+  /**
+    Flag in MDL_lock::m_fast_path_state that indicates that "fast path"
+    acquisitions go to the per-context shards in m_fast_path_shards
+    instead of m_fast_path_state.
+
+    With many connections using the same few tables, the compare-and-swap
+    on m_fast_path_state makes its cache line move between CPUs on every
+    statement. Table locks on which this compare-and-swap fails often get
+    shards, so that each connection only writes the cache line of its own
+    shard. Obtrusive lockers OR the shards with m_fast_path_state when
+    checking for conflicts.
+
+    A shard is incremented without holding m_rwlock and only then is the
+    HAS_OBTRUSIVE flag checked. If the flag is set, the increment is undone
+    under m_rwlock and the lock is acquired using "slow path". Since
+    obtrusive lockers set HAS_OBTRUSIVE before they read the shards, either
+    they see the increment or the acquirer sees the flag. So they may see
+    an increment which is about to be undone and wait for it, which is why
+    undoing it reschedules waiters.
+
+    While this flag is set m_fast_path_state is never 0, so the object is
+    not counted as unused. The flag is cleared when the last obtrusive lock
+    goes away and no shard has any locks. This lets the objects of dropped
+    tables be freed.
+
+    Set and cleared using atomic compare-and-swap AND under protection of
+    MDL_lock::m_rwlock lock.
+  */
+  static const fast_path_state_t HAS_SHARDS= 1ULL << 63;
   /**
     Combination of IS_DESTROYED/HAS_OBTRUSIVE/HAS_SLOW_PATH flags and packed
     counters of specific types of "unobtrusive" locks which were granted using
@@ -924,8 +977,9 @@ public:
       should happen under protection of MDL_lock::m_rwlock ([INV1]).
     */
 #if !defined(DBUG_OFF)
-    if (((*old_state & (IS_DESTROYED | HAS_OBTRUSIVE | HAS_SLOW_PATH)) !=
-         (new_state & (IS_DESTROYED | HAS_OBTRUSIVE | HAS_SLOW_PATH))) ||
+    const fast_path_state_t flags= IS_DESTROYED | HAS_OBTRUSIVE |
+                                   HAS_SLOW_PATH | HAS_SHARDS;
+    if (((*old_state & flags) != (new_state & flags)) ||
         *old_state & HAS_OBTRUSIVE)
     {
       mysql_prlock_assert_write_owner(&m_rwlock);
@@ -974,6 +1028,52 @@ public:
     my_atomic_store64(&m_fast_path_state, 0);
   }
 
+  /**
+    Shards of the "fast path" counters, NULL until the object gets
+    HAS_SHARDS set for the first time. Kept until the object is freed,
+    also when it is reused for another key, as acquirers which have not
+    noticed that HAS_SHARDS was cleared may still access them.
+  */
+  Fast_path_shard *m_fast_path_shards;
+
+  /** Failed "fast path" compare-and-swap operations on the object. */
+  volatile int32 m_fast_path_cas_failures;
+
+  /**
+    @returns bitwise OR of all shards of the "fast path" counters, which
+             has the counter of a lock type non-zero iff some shard has
+             locks of this type.
+  */
+  fast_path_state_t fast_path_shards_state() const
+  {
+    fast_path_state_t result= 0;
+    Fast_path_shard *shards= static_cast<Fast_path_shard *>(
+      my_atomic_loadptr(reinterpret_cast<void * volatile *>(
+        const_cast<Fast_path_shard **>(&m_fast_path_shards))));
+    if (shards)
+    {
+      for (uint i= 0; i < FAST_PATH_SHARDS; i++)
+        result|= my_atomic_load64(&shards[i].m_state);
+    }
+    return result;
+  }
+
+  /**
+    Changes a shard of the "fast path" counters in cases where this needs
+    to happen under protection of MDL_lock::m_rwlock.
+  */
+  void fast_path_shard_add(uint shard, fast_path_state_t value)
+  {
+    mysql_prlock_assert_write_owner(&m_rwlock);
+    my_atomic_add64(&m_fast_path_shards[shard].m_state, value);
+  }
+
+  inline fast_path_state_t fast_path_shard_acquire(uint shard,
+                                                   fast_path_state_t increment);
+  inline void fast_path_shard_release(uint shard,
+                                      fast_path_state_t increment);
+  void note_fast_path_contention(int32 cas_failures);
+
   /**
     Pointer to strategy object which defines how different types of lock
     requests should be handled for the namespace to which this lock belongs.
@@ -1016,7 +1116,8 @@ public:
   static bitmap_t object_lock_fast_path_granted_bitmap(const MDL_lock &lock)
   {
     bitmap_t result= 0;
-    fast_path_state_t fps= lock.m_fast_path_state;
+    fast_path_state_t fps= lock.m_fast_path_state |
+                           lock.fast_path_shards_state();
     if (fps & 0xFFFFFULL)
       result|= MDL_BIT(MDL_SHARED);
     if (fps & (0xFFFFFULL << 20))
@@ -1479,6 +1580,10 @@ void MDL_map::remove_random_unused(MDL_context *ctx, LF_PINS *pins,
 }
 
 
+/** Number of MDL_context objects created, to assign them shards. */
+static volatile int32 mdl_context_count= 0;
+
+
 /**
   Initialize a metadata locking context.
 
@@ -1492,7 +1597,10 @@ MDL_context::MDL_context()
   m_force_dml_deadlock_weight(false),
   m_waiting_for(NULL),
   m_pins(NULL),
-  m_rand_state(UINT_MAX32)
+  m_rand_state(UINT_MAX32),
+  m_fast_path_shard(static_cast<uint>(
+                      my_atomic_add32(&mdl_context_count, 1)) %
+                    MDL_lock::FAST_PATH_SHARDS)
 {
   mysql_prlock_init(key_MDL_context_LOCK_waiting_for, &m_LOCK_waiting_for);
 }
@@ -1651,6 +1759,7 @@ inline void MDL_lock::reinit(const MDL_key *mdl_key)
   m_piglet_lock_count= 0;
   m_current_waiting_incompatible_idx= 0;
   m_fast_path_state= 0;
+  m_fast_path_cas_failures= 0;
   /*
     Check that we have clean "m_granted" and "m_waiting" sets/lists in both
     cases when we have fresh and re-used object.
@@ -1658,6 +1767,114 @@ inline void MDL_lock::reinit(const MDL_key *mdl_key)
   DBUG_ASSERT(m_granted.is_empty() && m_waiting.is_empty());
   /* The same should be true for "m_obtrusive_locks_granted_waiting_count". */
   DBUG_ASSERT(m_obtrusive_locks_granted_waiting_count == 0);
+  /* And for shards of "fast path" counters which are kept on re-use. */
+  DBUG_ASSERT(fast_path_shards_state() == 0);
+}
+
+
+/**
+  Try to acquire "unobtrusive" lock using the shard of "fast path"
+  counters of the context.
+
+  @param shard      Shard of the context acquiring the lock.
+  @param increment  "Fast path" increment for the lock type.
+
+  @note The caller must have the object pinned.
+
+  @retval 0             Lock acquired.
+  @retval HAS_OBTRUSIVE Increment was undone because of "obtrusive" locks
+                        or because HAS_SHARDS was cleared, the lock needs
+                        to be acquired using "slow path".
+  @retval IS_DESTROYED  Increment was undone since the object has been
+                        destroyed, look-up needs to be retried.
+*/
+
+inline MDL_lock::fast_path_state_t
+MDL_lock::fast_path_shard_acquire(uint shard, fast_path_state_t increment)
+{
+  my_atomic_add64(&m_fast_path_shards[shard].m_state, increment);
+  /*
+    The above atomic operation is a full barrier, so we either see the
+    HAS_OBTRUSIVE flag which was set before the obtrusive locker looked at
+    the shards, or the obtrusive locker sees our increment.
+  */
+  fast_path_state_t state= my_atomic_load64(&m_fast_path_state);
+  if ((state & (IS_DESTROYED | HAS_OBTRUSIVE | HAS_SHARDS)) == HAS_SHARDS)
+    return 0;
+
+  fast_path_shard_release(shard, increment);
+  return (state & IS_DESTROYED) ? IS_DESTROYED : HAS_OBTRUSIVE;
+}
+
+
+/**
+  Release "unobtrusive" lock accounted for by the shard of "fast path"
+  counters of the context (or undo its acquisition).
+
+  @note The caller must have the object pinned, as once the shard is
+        decremented the object might be destroyed by somebody else.
+*/
+
+inline void MDL_lock::fast_path_shard_release(uint shard,
+                                              fast_path_state_t increment)
+{
+  my_atomic_add64(&m_fast_path_shards[shard].m_state, -increment);
+  if (my_atomic_load64(&m_fast_path_state) & HAS_OBTRUSIVE)
+  {
+    /*
+      Some "obtrusive" request might wait for our lock to go away. Such
+      request is added to the waiters list before it releases m_rwlock,
+      so rescheduling waiters under m_rwlock is enough for it to notice
+      the decrement.
+    */
+    mysql_prlock_wrlock(&m_rwlock);
+    if (m_obtrusive_locks_granted_waiting_count)
+      reschedule_waiters();
+    mysql_prlock_unlock(&m_rwlock);
+  }
+}
+
+
+/**
+  Account for failed compare-and-swap operations on m_fast_path_state
+  during "fast path" acquisition of a table lock, and give the object
+  shards of "fast path" counters once there were enough of them.
+
+  @note The caller must hold a "fast path" lock on the object, so it is
+        in use and m_fast_path_state is not 0.
+*/
+
+void MDL_lock::note_fast_path_contention(int32 cas_failures)
+{
+  if (my_atomic_add32(&m_fast_path_cas_failures, cas_failures) +
+      cas_failures < FAST_PATH_SHARDING_THRESHOLD)
+    return;
+
+  mysql_prlock_wrlock(&m_rwlock);
+  m_fast_path_cas_failures= 0;
+  if (m_fast_path_shards == NULL)
+  {
+    Fast_path_shard *shards=
+      new (std::nothrow) Fast_path_shard[FAST_PATH_SHARDS];
+    if (shards == NULL)
+    {
+      mysql_prlock_unlock(&m_rwlock);
+      return;
+    }
+    for (uint i= 0; i < FAST_PATH_SHARDS; i++)
+      shards[i].m_state= 0;
+    my_atomic_storeptr(reinterpret_cast<void * volatile *>(
+                         &m_fast_path_shards), shards);
+  }
+  /*
+    No point in sharding while there are "obtrusive" locks, as all
+    acquisitions go to "slow path" anyway.
+  */
+  fast_path_state_t old_state= m_fast_path_state;
+  while (! (old_state & (HAS_OBTRUSIVE | HAS_SHARDS)) &&
+         ! fast_path_state_cas(&old_state, old_state | HAS_SHARDS))
+  { }
+  mysql_prlock_unlock(&m_rwlock);
 }
 
 
@@ -2656,6 +2873,16 @@ void MDL_lock::remove_ticket(MDL_context *ctx, LF_PINS *pins,
   {
     fast_path_state_t old_state= m_fast_path_state;
     fast_path_state_t new_state;
+    /*
+      Once the last "obtrusive" lock is gone and no shard has locks we also
+      clear HAS_SHARDS, so that objects of dropped or no longer hot tables
+      can become unused. This has to happen in the same compare-and-swap
+      which clears HAS_OBTRUSIVE, as concurrent shard acquisitions which
+      we don't see in the shards are undone only if they see one of these
+      flags set or HAS_SHARDS cleared.
+    */
+    bool clear_shards= last_obtrusive && (old_state & MDL_lock::HAS_SHARDS) &&
+                       fast_path_shards_state() == 0;
     do
     {
       new_state= old_state;
@@ -2663,6 +2890,8 @@ void MDL_lock::remove_ticket(MDL_context *ctx, LF_PINS *pins,
         new_state&= ~MDL_lock::HAS_SLOW_PATH;
       if (last_obtrusive)
         new_state&= ~MDL_lock::HAS_OBTRUSIVE;
+      if (clear_shards)
+        new_state&= ~MDL_lock::HAS_SHARDS;
     }
     while (! fast_path_state_cas(&old_state, new_state));
 
@@ -2961,7 +3190,16 @@ void MDL_context::materialize_fast_path_locks()
           This needs to happen under protection of MDL_lock::m_rwlock to make
           it atomic with addition of ticket to MDL_lock::m_granted list and
           to enforce invariant [INV1].
+          For sharded tickets the counter is in the shard of our context,
+          m_fast_path_state can't become 0 as HAS_SHARDS is set.
         */
+        if (ticket->m_is_sharded_fast_path)
+        {
+          lock->fast_path_shard_add(m_fast_path_shard,
+                                    -unobtrusive_lock_increment);
+          ticket->m_is_sharded_fast_path= false;
+          unobtrusive_lock_increment= 0;
+        }
         MDL_lock::fast_path_state_t old_state= lock->m_fast_path_state;
         while (! lock->fast_path_state_cas(&old_state,
                          ((old_state - unobtrusive_lock_increment) |
@@ -3164,9 +3402,12 @@ retry:
     */
     MDL_lock::fast_path_state_t old_state= lock->m_fast_path_state;
     bool first_use;
+    int32 cas_failures= -1;
 
     do
     {
+      cas_failures++;
+
       /*
         Check if hash look-up returned object marked as destroyed or
         it was marked as such while it was pinned by us. If yes we
@@ -3189,6 +3430,29 @@ retry:
       if (old_state & MDL_lock::HAS_OBTRUSIVE)
         goto slow_path;
 
+      /*
+        Hot table lock, the counter for our lock type is in the shard of
+        our context (@sa MDL_lock::HAS_SHARDS). The object is in use while
+        HAS_SHARDS is set, so this is never its first use.
+      */
+      if (old_state & MDL_lock::HAS_SHARDS)
+      {
+        MDL_lock::fast_path_state_t state=
+          lock->fast_path_shard_acquire(m_fast_path_shard,
+                                        unobtrusive_lock_increment);
+        if (state & MDL_lock::IS_DESTROYED)
+        {
+          if (pinned)
+            lf_hash_search_unpin(m_pins);
+          goto retry;
+        }
+        if (state)
+          goto slow_path;
+        ticket->m_is_sharded_fast_path= true;
+        first_use= false;
+        break;
+      }
+
       /*
         If m_fast_path_state doesn't have HAS_SLOW_PATH set and all "fast"
         path counters are 0 then we are about to use an unused MDL_lock
@@ -3218,6 +3482,15 @@ retry:
       threshold.
     */
 
+    /*
+      Concurrent acquisitions and releases made our compare-and-swap fail.
+      If this happens often, the table is hot and its counters are sharded.
+    */
+    DBUG_EXECUTE_IF("mdl_shard_fast_path_counters",
+                    cas_failures= MDL_lock::FAST_PATH_SHARDING_THRESHOLD;);
+    if (cas_failures > 0 && key->mdl_namespace() == MDL_key::TABLE)
+      lock->note_fast_path_contention(cas_failures);
+
     if (pinned)
       lf_hash_search_unpin(m_pins);
 
@@ -3998,8 +4271,15 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
       MDL_lock::m_rwlock, so nobody will see results of this decrement until
       m_rwlock is released.
     */
-    lock->fast_path_state_add(
-            -lock->get_unobtrusive_lock_increment(mdl_ticket->m_type));
+    if (mdl_ticket->m_is_sharded_fast_path)
+    {
+      lock->fast_path_shard_add(m_fast_path_shard,
+              -lock->get_unobtrusive_lock_increment(mdl_ticket->m_type));
+      mdl_ticket->m_is_sharded_fast_path= false;
+    }
+    else
+      lock->fast_path_state_add(
+              -lock->get_unobtrusive_lock_increment(mdl_ticket->m_type));
     mdl_ticket->m_is_fast_path= false;
   }
   else
@@ -4335,7 +4615,22 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
   if (ticket->m_hton_notified)
     key_for_hton.mdl_key_init(&lock->key);
 
-  if (ticket->m_is_fast_path)
+  if (ticket->m_is_sharded_fast_path)
+  {
+    /*
+      We are releasing ticket which represents lock request which was
+      satisfied using the shard of our context. This shard keeps HAS_SHARDS
+      set and so the object in use. Pin the object before decrementing the
+      shard, as fast_path_shard_release() still accesses the object after
+      that. Since HAS_SHARDS is only cleared under MDL_lock::m_rwlock when
+      the shards are empty, the object can't become unused here.
+    */
+    lf_pin(m_pins, 2, lock);
+    lock->fast_path_shard_release(m_fast_path_shard,
+                   lock->get_unobtrusive_lock_increment(ticket->get_type()));
+    lf_hash_search_unpin(m_pins);
+  }
+  else if (ticket->m_is_fast_path)
   {
     /*
       We are releasing ticket which represents lock request which was
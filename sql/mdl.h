@@ -672,6 +672,7 @@ public:
   }
   enum_mdl_type get_type() const { return m_type; }
   MDL_lock *get_lock() const { return m_lock; }
+  bool is_sharded_fast_path() const { return m_is_sharded_fast_path; }
   const MDL_key *get_key() const;
   void downgrade_lock(enum_mdl_type type);
 
@@ -706,6 +707,7 @@ private:
      m_ctx(ctx_arg),
      m_lock(NULL),
      m_is_fast_path(false),
+     m_is_sharded_fast_path(false),
      m_hton_notified(false),
      m_psi(NULL)
   {}
@@ -749,6 +751,13 @@ private:
   */
   bool m_is_fast_path;
 
+  /**
+    Indicates that ticket corresponds to "fast path" lock which is
+    accounted for by the shard of the owner context in
+    MDL_lock::m_fast_path_shards instead of MDL_lock::m_fast_path_state.
+  */
+  bool m_is_sharded_fast_path;
+
   /**
     Indicates that ticket corresponds to lock request which required
     storage engine notification during its acquisition and requires
@@ -1115,6 +1124,12 @@ private:
     when searching for unused objects to free.
   */
   uint m_rand_state;
+  /**
+    Shard of "fast path" counters of hot MDL_lock objects used by this
+    context (@sa MDL_lock::HAS_SHARDS). Assigned round-robin, so that
+    concurrent connections mostly use different shards.
+  */
+  uint m_fast_path_shard;
 
 private:
   MDL_ticket *find_ticket(MDL_request *mdl_req,
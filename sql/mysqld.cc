@@ -95,6 +95,8 @@
 #include "sql_callback.h"
 #include "opt_trace_context.h"
 #include "opt_costconstantcache.h"
+#include "histogram.h"                          // init_histogram_cache
+#include "frm_cache.h"                          // frm_cache_init
 #include "sql_plugin.h"                         // plugin_shutdown
 #include "sql_initialize.h"
 #include "log_event.h"
@@ -133,6 +135,7 @@
 #include "sp_rcontext.h"
 #include "sql_reload.h"  // reload_acl_and_cache
 #include "sp_head.h"  // init_sp_psi_keys
+#include "sp.h"       // sp_definition_cache_init
 #include "event_data_objects.h" //init_scheduler_psi_keys
 #include "my_timer.h"    // my_timer_init, my_timer_deinit
 #include "table_cache.h"                // table_cache_manager
@@ -1210,6 +1213,9 @@ static void mysqld_exit(int exit_code)
   Srv_session::module_deinit();
 #endif
   delete_optimizer_cost_module();
+  free_histogram_cache();
+  sp_definition_cache_free();
+  frm_cache_free();
   clean_up_mutexes();
   my_end(opt_endinfo ? MY_CHECK_ERROR | MY_GIVE_INFO : 0);
   destroy_error_log();
@@ -1361,6 +1367,9 @@ void clean_up(bool print_message)
   table_def_start_shutdown();
   plugin_shutdown();
   delete_optimizer_cost_module();
+  free_histogram_cache();
+  sp_definition_cache_free();
+  frm_cache_free();
   ha_end();
   if (tc_log)
   {
@@ -4654,6 +4663,9 @@ a file name for --log-bin-index option", opt_binlog_index_name);
 
   /* Initialize the optimizer cost module */
   init_optimizer_cost_module(true);
+  init_histogram_cache();
+  sp_definition_cache_init();
+  frm_cache_init();
   ft_init_stopwords();
 
   init_max_user_conn();
@@ -5325,7 +5337,11 @@ int mysqld_main(int argc, char **argv)
 
   /* Read the optimizer cost model configuration tables */
   if (!opt_bootstrap)
+  {
     reload_optimizer_cost_constants();
+    load_histograms();
+    frm_cache_prewarm();
+  }
 
   if (mysql_rm_tmp_tables() || acl_init(opt_noacl) ||
       my_tz_init((THD *)0, default_tz_name, opt_bootstrap) ||
@@ -6772,6 +6788,39 @@ static int show_prepared_stmt_count(THD *thd, SHOW_VAR *var, char *buff)
   return 0;
 }
 
+/*
+  The query cache frees the queries of changed tables lazily; free them
+  before reading the counters, so that these do not count stale queries.
+*/
+static int show_qcache_value(SHOW_VAR *var, char *buff, const ulong &value)
+{
+  query_cache.free_invalidated_queries();
+  var->type= SHOW_LONG;
+  var->value= buff;
+  *((long *)buff)= (long)value;
+  return 0;
+}
+
+static int show_qcache_free_blocks(THD *thd, SHOW_VAR *var, char *buff)
+{
+  return show_qcache_value(var, buff, query_cache.free_memory_blocks);
+}
+
+static int show_qcache_free_memory(THD *thd, SHOW_VAR *var, char *buff)
+{
+  return show_qcache_value(var, buff, query_cache.free_memory);
+}
+
+static int show_qcache_queries_in_cache(THD *thd, SHOW_VAR *var, char *buff)
+{
+  return show_qcache_value(var, buff, query_cache.queries_in_cache);
+}
+
+static int show_qcache_total_blocks(THD *thd, SHOW_VAR *var, char *buff)
+{
+  return show_qcache_value(var, buff, query_cache.total_blocks);
+}
+
 static int show_table_definitions(THD *thd, SHOW_VAR *var, char *buff)
 {
   var->type= SHOW_LONG;
@@ -7274,15 +7323,17 @@ SHOW_VAR status_vars[]= {
   {"Opened_files",             (char*) &my_file_total_opened,                         SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
   {"Opened_tables",            (char*) offsetof(STATUS_VAR, opened_tables),           SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
   {"Opened_table_definitions", (char*) offsetof(STATUS_VAR, opened_shares),           SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
+  {"Plan_cache_hits",          (char*) offsetof(STATUS_VAR, plan_cache_hits),         SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
+  {"Plan_cache_misses",        (char*) offsetof(STATUS_VAR, plan_cache_misses),       SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
   {"Prepared_stmt_count",      (char*) &show_prepared_stmt_count,                     SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
-  {"Qcache_free_blocks",       (char*) &query_cache.free_memory_blocks,               SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
-  {"Qcache_free_memory",       (char*) &query_cache.free_memory,                      SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
+  {"Qcache_free_blocks",       (char*) &show_qcache_free_blocks,                      SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
+  {"Qcache_free_memory",       (char*) &show_qcache_free_memory,                      SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
   {"Qcache_hits",              (char*) &query_cache.hits,                             SHOW_LONG,               SHOW_SCOPE_GLOBAL},
   {"Qcache_inserts",           (char*) &query_cache.inserts,                          SHOW_LONG,               SHOW_SCOPE_GLOBAL},
   {"Qcache_lowmem_prunes",     (char*) &query_cache.lowmem_prunes,                    SHOW_LONG,               SHOW_SCOPE_GLOBAL},
   {"Qcache_not_cached",        (char*) &query_cache.refused,                          SHOW_LONG,               SHOW_SCOPE_GLOBAL},
-  {"Qcache_queries_in_cache",  (char*) &query_cache.queries_in_cache,                 SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
-  {"Qcache_total_blocks",      (char*) &query_cache.total_blocks,                     SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
+  {"Qcache_queries_in_cache",  (char*) &show_qcache_queries_in_cache,                 SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
+  {"Qcache_total_blocks",      (char*) &show_qcache_total_blocks,                     SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
   {"Queries",                  (char*) &show_queries,                                 SHOW_FUNC,               SHOW_SCOPE_ALL},
   {"Questions",                (char*) offsetof(STATUS_VAR, questions),               SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
   {"Select_full_join",         (char*) offsetof(STATUS_VAR, select_full_join_count),  SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
@@ -9094,7 +9145,8 @@ PSI_mutex_key
   key_structure_guard_mutex, key_TABLE_SHARE_LOCK_ha_data,
   key_LOCK_error_messages,
   key_LOCK_log_throttle_qni, key_LOCK_query_plan, key_LOCK_thd_query,
-  key_LOCK_cost_const, key_LOCK_current_cond,
+  key_LOCK_cost_const, key_LOCK_current_cond, key_LOCK_histograms,
+  key_LOCK_sp_definition_cache, key_LOCK_frm_cache,
   key_LOCK_keyring_operations;
 PSI_mutex_key key_RELAYLOG_LOCK_commit;
 PSI_mutex_key key_RELAYLOG_LOCK_commit_queue;
@@ -9206,6 +9258,9 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_query_plan, "THD::LOCK_query_plan", PSI_FLAG_VOLATILITY_SESSION},
   { &key_LOCK_cost_const, "Cost_constant_cache::LOCK_cost_const",
     PSI_FLAG_GLOBAL},  
+  { &key_LOCK_histograms, "LOCK_histograms", PSI_FLAG_GLOBAL},
+  { &key_LOCK_sp_definition_cache, "LOCK_sp_definition_cache", PSI_FLAG_GLOBAL},
+  { &key_LOCK_frm_cache, "LOCK_frm_cache", PSI_FLAG_GLOBAL},
   { &key_LOCK_current_cond, "THD::LOCK_current_cond", PSI_FLAG_VOLATILITY_SESSION},
   { &key_mts_temp_table_LOCK, "key_mts_temp_table_LOCK", 0},
   { &key_LOCK_reset_gtid_table, "LOCK_reset_gtid_table", PSI_FLAG_GLOBAL},
@@ -9334,6 +9389,8 @@ PSI_thread_key key_thread_bootstrap, key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
   key_thread_compress_gtid_table, key_thread_parser_service;
 PSI_thread_key key_thread_timer_notifier;
+PSI_thread_key key_thread_frm_cache_prewarm;
+PSI_thread_key key_thread_sort;
 
 static PSI_thread_info all_server_threads[]=
 {
@@ -9351,6 +9408,8 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_compress_gtid_table, "compress_gtid_table", PSI_FLAG_GLOBAL},
   { &key_thread_parser_service, "parser_service", PSI_FLAG_GLOBAL},
+  { &key_thread_frm_cache_prewarm, "frm_cache_prewarm", 0},
+  { &key_thread_sort, "sort", 0},
 };
 
 PSI_file_key key_file_map;
@@ -9727,6 +9786,7 @@ PSI_memory_key key_memory_TABLE;
 PSI_memory_key key_memory_frm_extra_segment_buff;
 PSI_memory_key key_memory_frm_form_pos;
 PSI_memory_key key_memory_frm_string;
+PSI_memory_key key_memory_frm_cache;
 PSI_memory_key key_memory_LOG_name;
 PSI_memory_key key_memory_DATE_TIME_FORMAT;
 PSI_memory_key key_memory_DDL_LOG_MEMORY_ENTRY;
@@ -9889,6 +9949,7 @@ static PSI_memory_info all_server_memory[]=
   { &key_memory_frm_extra_segment_buff, "frm::extra_segment_buff", 0},
   { &key_memory_frm_form_pos, "frm::form_pos", 0},
   { &key_memory_frm_string, "frm::string", 0},
+  { &key_memory_frm_cache, "frm::cache", PSI_FLAG_GLOBAL},
   { &key_memory_LOG_name, "LOG_name", 0},
   { &key_memory_DATE_TIME_FORMAT, "DATE_TIME_FORMAT", 0},
   { &key_memory_DDL_LOG_MEMORY_ENTRY, "DDL_LOG_MEMORY_ENTRY", 0},
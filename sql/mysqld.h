@@ -459,7 +459,8 @@ extern PSI_mutex_key
   key_structure_guard_mutex, key_TABLE_SHARE_LOCK_ha_data,
   key_LOCK_error_messages,
   key_LOCK_log_throttle_qni, key_LOCK_query_plan, key_LOCK_thd_query,
-  key_LOCK_cost_const, key_LOCK_current_cond,
+  key_LOCK_cost_const, key_LOCK_current_cond, key_LOCK_histograms,
+  key_LOCK_sp_definition_cache, key_LOCK_frm_cache,
   key_LOCK_keyring_operations;
 extern PSI_mutex_key key_RELAYLOG_LOCK_commit;
 extern PSI_mutex_key key_RELAYLOG_LOCK_commit_queue;
@@ -523,6 +524,8 @@ extern PSI_thread_key key_thread_bootstrap,
   key_thread_one_connection, key_thread_signal_hand,
   key_thread_compress_gtid_table, key_thread_parser_service;
 extern PSI_thread_key key_thread_timer_notifier;
+extern PSI_thread_key key_thread_frm_cache_prewarm;
+extern PSI_thread_key key_thread_sort;
 
 extern PSI_file_key key_file_map;
 extern PSI_file_key key_file_binlog, key_file_binlog_cache,
@@ -662,6 +665,7 @@ extern PSI_memory_key key_memory_string_iterator;
 extern PSI_memory_key key_memory_frm_extra_segment_buff;
 extern PSI_memory_key key_memory_frm_form_pos;
 extern PSI_memory_key key_memory_frm_string;
+extern PSI_memory_key key_memory_frm_cache;
 extern PSI_memory_key key_memory_Unique_sort_buffer;
 extern PSI_memory_key key_memory_Unique_merge_buffer;
 extern PSI_memory_key key_memory_shared_memory_name;
@@ -19,11 +19,12 @@
 #include "mutex_lock.h"              // Mutex_lock
 #include "debug_sync.h"              // DEBUG_SYNC_C
 #include "sql_class.h"               // THD
+#include "sql_parse.h"               // Find_thd_with_id
 
 #include <functional>
 #include <algorithm>
 
-int Global_THD_manager::global_thd_count= 0;
+volatile int32 Global_THD_manager::global_thd_count= 0;
 Global_THD_manager *Global_THD_manager::thd_manager = NULL;
 
 /**
@@ -75,8 +76,8 @@ static PSI_mutex_key key_LOCK_thread_ids;
 
 static PSI_mutex_info all_thd_manager_mutexes[]=
 {
-  { &key_LOCK_thd_list, "LOCK_thd_list", PSI_FLAG_GLOBAL},
-  { &key_LOCK_thd_remove, "LOCK_thd_remove", PSI_FLAG_GLOBAL},
+  { &key_LOCK_thd_list, "LOCK_thd_list", 0},
+  { &key_LOCK_thd_remove, "LOCK_thd_remove", 0},
   { &key_LOCK_thread_ids, "LOCK_thread_ids", PSI_FLAG_GLOBAL }
 };
 
@@ -84,7 +85,7 @@ static PSI_cond_key key_COND_thd_list;
 
 static PSI_cond_info all_thd_manager_conds[]=
 {
-  { &key_COND_thd_list, "COND_thd_list", PSI_FLAG_GLOBAL}
+  { &key_COND_thd_list, "COND_thd_list", 0}
 };
 #endif // HAVE_PSI_INTERFACE
 
@@ -92,8 +93,7 @@ static PSI_cond_info all_thd_manager_conds[]=
 const my_thread_id Global_THD_manager::reserved_thread_id= 0;
 
 Global_THD_manager::Global_THD_manager()
-  : thd_list(PSI_INSTRUMENT_ME),
-    thread_ids(PSI_INSTRUMENT_ME),
+  : thread_ids(PSI_INSTRUMENT_ME),
     num_thread_running(0),
     thread_created(0),
     thread_id_counter(reserved_thread_id + 1),
@@ -107,13 +107,17 @@ Global_THD_manager::Global_THD_manager()
   mysql_cond_register("sql", all_thd_manager_conds, count);
 #endif
 
-  mysql_mutex_init(key_LOCK_thd_list, &LOCK_thd_list,
-                   MY_MUTEX_INIT_FAST);
-  mysql_mutex_init(key_LOCK_thd_remove,
-                   &LOCK_thd_remove, MY_MUTEX_INIT_FAST);
+  for (uint i= 0; i < NUM_PARTITIONS; i++)
+  {
+    thd_list[i]= new THD_array(PSI_INSTRUMENT_ME);
+    mysql_mutex_init(key_LOCK_thd_list, &LOCK_thd_list[i],
+                     MY_MUTEX_INIT_FAST);
+    mysql_mutex_init(key_LOCK_thd_remove,
+                     &LOCK_thd_remove[i], MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_COND_thd_list, &COND_thd_list[i]);
+  }
   mysql_mutex_init(key_LOCK_thread_ids,
                    &LOCK_thread_ids, MY_MUTEX_INIT_FAST);
-  mysql_cond_init(key_COND_thd_list, &COND_thd_list);
 
   // The reserved thread ID should never be used by normal threads,
   // so mark it as in-use. This ID is used by temporary THDs never
@@ -125,12 +129,16 @@ Global_THD_manager::Global_THD_manager()
 Global_THD_manager::~Global_THD_manager()
 {
   thread_ids.erase_unique(reserved_thread_id);
-  DBUG_ASSERT(thd_list.empty());
   DBUG_ASSERT(thread_ids.empty());
-  mysql_mutex_destroy(&LOCK_thd_list);
-  mysql_mutex_destroy(&LOCK_thd_remove);
+  for (uint i= 0; i < NUM_PARTITIONS; i++)
+  {
+    DBUG_ASSERT(thd_list[i]->empty());
+    delete thd_list[i];
+    mysql_mutex_destroy(&LOCK_thd_list[i]);
+    mysql_mutex_destroy(&LOCK_thd_remove[i]);
+    mysql_cond_destroy(&COND_thd_list[i]);
+  }
   mysql_mutex_destroy(&LOCK_thread_ids);
-  mysql_cond_destroy(&COND_thd_list);
 }
 
 
@@ -158,25 +166,27 @@ void Global_THD_manager::add_thd(THD *thd)
   DBUG_PRINT("info", ("Global_THD_manager::add_thd %p", thd));
   // Should have an assigned ID before adding to the list.
   DBUG_ASSERT(thd->thread_id() != reserved_thread_id);
-  mysql_mutex_lock(&LOCK_thd_list);
+  const uint partition= get_partition(thd->thread_id());
+  mysql_mutex_lock(&LOCK_thd_list[partition]);
   // Technically it is not supported to compare pointers, but it works.
   std::pair<THD_array::iterator, bool> insert_result=
-    thd_list.insert_unique(thd);
+    thd_list[partition]->insert_unique(thd);
   if (insert_result.second)
   {
-    ++global_thd_count;
+    my_atomic_add32(&global_thd_count, 1);
   }
   // Adding the same THD twice is an error.
   DBUG_ASSERT(insert_result.second);
-  mysql_mutex_unlock(&LOCK_thd_list);
+  mysql_mutex_unlock(&LOCK_thd_list[partition]);
 }
 
 
 void Global_THD_manager::remove_thd(THD *thd)
 {
   DBUG_PRINT("info", ("Global_THD_manager::remove_thd %p", thd));
-  mysql_mutex_lock(&LOCK_thd_remove);
-  mysql_mutex_lock(&LOCK_thd_list);
+  const uint partition= get_partition(thd->thread_id());
+  mysql_mutex_lock(&LOCK_thd_remove[partition]);
+  mysql_mutex_lock(&LOCK_thd_list[partition]);
 
   if (!unit_test)
     DBUG_ASSERT(thd->release_resources_done());
@@ -188,14 +198,14 @@ void Global_THD_manager::remove_thd(THD *thd)
   */
   DBUG_EXECUTE_IF("sleep_after_lock_thread_count_before_delete_thd", sleep(5););
 
-  const size_t num_erased= thd_list.erase_unique(thd);
+  const size_t num_erased= thd_list[partition]->erase_unique(thd);
   if (num_erased == 1)
-    --global_thd_count;
+    my_atomic_add32(&global_thd_count, -1);
   // Removing a THD that was never added is an error.
   DBUG_ASSERT(1 == num_erased);
-  mysql_mutex_unlock(&LOCK_thd_remove);
-  mysql_cond_broadcast(&COND_thd_list);
-  mysql_mutex_unlock(&LOCK_thd_list);
+  mysql_mutex_unlock(&LOCK_thd_remove[partition]);
+  mysql_cond_broadcast(&COND_thd_list[partition]);
+  mysql_mutex_unlock(&LOCK_thd_list[partition]);
 }
 
 
@@ -232,13 +242,16 @@ void Global_THD_manager::set_thread_id_counter(my_thread_id new_id)
 
 void Global_THD_manager::wait_till_no_thd()
 {
-  mysql_mutex_lock(&LOCK_thd_list);
-  while (get_thd_count() > 0)
+  for (uint i= 0; i < NUM_PARTITIONS; i++)
   {
-    mysql_cond_wait(&COND_thd_list, &LOCK_thd_list);
-    DBUG_PRINT("quit", ("One thread died (count=%u)", get_thd_count()));
+    mysql_mutex_lock(&LOCK_thd_list[i]);
+    while (thd_list[i]->size() > 0)
+    {
+      mysql_cond_wait(&COND_thd_list[i], &LOCK_thd_list[i]);
+      DBUG_PRINT("quit", ("One thread died (count=%u)", get_thd_count()));
+    }
+    mysql_mutex_unlock(&LOCK_thd_list[i]);
   }
-  mysql_mutex_unlock(&LOCK_thd_list);
 }
 
 
@@ -246,45 +259,71 @@ void Global_THD_manager::do_for_all_thd_copy(Do_THD_Impl *func)
 {
   Do_THD doit(func);
 
-  mysql_mutex_lock(&LOCK_thd_remove);
-  mysql_mutex_lock(&LOCK_thd_list);
+  for (uint i= 0; i < NUM_PARTITIONS; i++)
+  {
+    mysql_mutex_lock(&LOCK_thd_remove[i]);
+    mysql_mutex_lock(&LOCK_thd_list[i]);
 
-  /* Take copy of global_thread_list. */
-  THD_array thd_list_copy(thd_list);
+    /* Take copy of the partition of global_thread_list. */
+    THD_array thd_list_copy(*thd_list[i]);
 
-  /*
-    Allow inserts to global_thread_list. Newly added thd
-    will not be accounted for when executing func.
-  */
-  mysql_mutex_unlock(&LOCK_thd_list);
+    /*
+      Allow inserts to the partition. Newly added thd
+      will not be accounted for when executing func.
+    */
+    mysql_mutex_unlock(&LOCK_thd_list[i]);
 
-  /* Execute func for all existing threads. */
-  std::for_each(thd_list_copy.begin(), thd_list_copy.end(), doit);
+    /* Execute func for all existing threads of the partition. */
+    std::for_each(thd_list_copy.begin(), thd_list_copy.end(), doit);
 
-  DEBUG_SYNC_C("inside_do_for_all_thd_copy");
-  mysql_mutex_unlock(&LOCK_thd_remove);
+    if (i == NUM_PARTITIONS - 1)
+      DEBUG_SYNC_C("inside_do_for_all_thd_copy");
+    mysql_mutex_unlock(&LOCK_thd_remove[i]);
+  }
 }
 
 
 void Global_THD_manager::do_for_all_thd(Do_THD_Impl *func)
 {
   Do_THD doit(func);
-  mysql_mutex_lock(&LOCK_thd_list);
-  std::for_each(thd_list.begin(), thd_list.end(), doit);
-  mysql_mutex_unlock(&LOCK_thd_list);
+  for (uint i= 0; i < NUM_PARTITIONS; i++)
+  {
+    mysql_mutex_lock(&LOCK_thd_list[i]);
+    std::for_each(thd_list[i]->begin(), thd_list[i]->end(), doit);
+    mysql_mutex_unlock(&LOCK_thd_list[i]);
+  }
 }
 
 
 THD* Global_THD_manager::find_thd(Find_THD_Impl *func)
 {
   Find_THD find_thd(func);
-  mysql_mutex_lock(&LOCK_thd_list);
+  THD* ret= NULL;
+  for (uint i= 0; i < NUM_PARTITIONS && ret == NULL; i++)
+  {
+    mysql_mutex_lock(&LOCK_thd_list[i]);
+    THD_array::const_iterator it=
+      std::find_if(thd_list[i]->begin(), thd_list[i]->end(), find_thd);
+    if (it != thd_list[i]->end())
+      ret= *it;
+    mysql_mutex_unlock(&LOCK_thd_list[i]);
+  }
+  return ret;
+}
+
+
+THD* Global_THD_manager::find_thd(Find_thd_with_id *func)
+{
+  Find_THD find_thd(func);
+  const uint partition= get_partition(func->get_id());
+  mysql_mutex_lock(&LOCK_thd_list[partition]);
   THD_array::const_iterator it=
-    std::find_if(thd_list.begin(), thd_list.end(), find_thd);
+    std::find_if(thd_list[partition]->begin(), thd_list[partition]->end(),
+                 find_thd);
   THD* ret= NULL;
-  if (it != thd_list.end())
+  if (it != thd_list[partition]->end())
     ret= *it;
-  mysql_mutex_unlock(&LOCK_thd_list);
+  mysql_mutex_unlock(&LOCK_thd_list[partition]);
   return ret;
 }
 
@@ -295,17 +334,25 @@ void inc_thread_created()
 }
 
 
+/*
+  Locks all partitions of the THD list, always in the same order.
+*/
 void thd_lock_thread_count(THD *)
 {
-  mysql_mutex_lock(&Global_THD_manager::get_instance()->LOCK_thd_list);
+  Global_THD_manager *thd_manager= Global_THD_manager::get_instance();
+  for (uint i= 0; i < Global_THD_manager::NUM_PARTITIONS; i++)
+    mysql_mutex_lock(&thd_manager->LOCK_thd_list[i]);
 }
 
 
 void thd_unlock_thread_count(THD *)
 {
   Global_THD_manager *thd_manager= Global_THD_manager::get_instance();
-  mysql_cond_broadcast(&thd_manager->COND_thd_list);
-  mysql_mutex_unlock(&thd_manager->LOCK_thd_list);
+  for (uint i= 0; i < Global_THD_manager::NUM_PARTITIONS; i++)
+  {
+    mysql_cond_broadcast(&thd_manager->COND_thd_list[i]);
+    mysql_mutex_unlock(&thd_manager->LOCK_thd_list[i]);
+  }
 }
 
 
@@ -22,6 +22,7 @@
 #include "prealloced_array.h"
 
 class THD;
+class Find_thd_with_id;
 
 #ifdef __cplusplus
 extern "C" {
@@ -78,6 +79,11 @@ public:
   add_thd() inserts a THD into the set, and increments the counter.
   remove_thd() removes a THD from the set, and decrements the counter.
   Method remove_thd() also broadcasts COND_thd_list.
+
+  The set is split into NUM_PARTITIONS partitions by thread id, each with
+  its own list, mutexes and condition variable, so that connects and
+  disconnects of different threads do not serialize on one mutex.
+  Operations on all THDs visit the partitions one at a time.
 */
 
 class Global_THD_manager
@@ -90,6 +96,9 @@ public:
   */
   static const my_thread_id reserved_thread_id;
 
+  /** Number of partitions of the THD list. */
+  static const uint NUM_PARTITIONS= 8;
+
   /**
     Retrieves singleton instance
   */
@@ -234,8 +243,14 @@ public:
   */
   THD* find_thd(Find_THD_Impl *func);
 
+  /**
+    Like find_thd(Find_THD_Impl*), but only searches the partition the
+    thread id belongs to.
+  */
+  THD* find_thd(Find_thd_with_id *func);
+
   // Declared static as it is referenced in handle_fatal_signal()
-  static int global_thd_count;
+  static volatile int32 global_thd_count;
 
 private:
   Global_THD_manager();
@@ -244,20 +259,27 @@ private:
   // Singleton instance.
   static Global_THD_manager *thd_manager;
 
-  // Array of current THDs. Protected by LOCK_thd_list.
-  typedef Prealloced_array<THD*, 500, true> THD_array;
-  THD_array thd_list;
+  /** @return the partition of the THD list a thread id belongs to */
+  static uint get_partition(my_thread_id thread_id)
+  {
+    return thread_id % NUM_PARTITIONS;
+  }
+
+  // Arrays of current THDs, one per partition.
+  // Protected by the LOCK_thd_list of the partition.
+  typedef Prealloced_array<THD*, 60, true> THD_array;
+  THD_array *thd_list[NUM_PARTITIONS];
 
   // Array of thread ID in current use. Protected by LOCK_thread_ids.
   typedef Prealloced_array<my_thread_id, 1000, true> Thread_id_array;
   Thread_id_array thread_ids;
 
-  mysql_cond_t COND_thd_list;
+  mysql_cond_t COND_thd_list[NUM_PARTITIONS];
 
-  // Mutex that guards thd_list
-  mysql_mutex_t LOCK_thd_list;
-  // Mutex used to guard removal of elements from thd list.
-  mysql_mutex_t LOCK_thd_remove;
+  // Mutexes that guard thd_list
+  mysql_mutex_t LOCK_thd_list[NUM_PARTITIONS];
+  // Mutexes used to guard removal of elements from thd list.
+  mysql_mutex_t LOCK_thd_remove[NUM_PARTITIONS];
   // Mutex protecting thread_ids
   mysql_mutex_t LOCK_thread_ids;
 
@@ -19,6 +19,7 @@
 #include <stddef.h>
 #include "sql_const.h"                          // MAX_FIELD_WIDTH
 #include "field.h"                              // Field
+#include "handler.h"                            // ha_statistics_changed
 #include "log.h"                                // sql_print_warning
 #include "m_string.h"                           // LEX_CSTRING
 #include "my_dbug.h"                            // DBUG_ASSERT
@@ -505,5 +506,9 @@ void delete_optimizer_cost_module()
 void reload_optimizer_cost_constants()
 {
   if (cost_constant_cache)
+  {
     cost_constant_cache->reload();
+    // Plans cached with the old cost constants must be chosen anew
+    ha_statistics_changed();
+  }
 }
@@ -1598,6 +1598,11 @@ bool Explain_join::explain_extra()
         if (push_extra(ET_USING_INDEX_FOR_GROUP_BY, buff))
           return true;
       }
+      else if (quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN)
+      {
+        if (push_extra(ET_USING_INDEX_FOR_SKIP_SCAN))
+          return true;
+      }
       else
       {
         if (push_extra(ET_USING_INDEX))
@@ -1670,6 +1675,8 @@ bool Explain_join::explain_extra()
         buff.append("Batched Key Access");
       else if (t == JOIN_CACHE::ALG_BKA_UNIQUE)
         buff.append("Batched Key Access (unique)");
+      else if (t == JOIN_CACHE::ALG_HASH)
+        buff.append("Hash Join");
       else
         DBUG_ASSERT(0); /* purecov: inspected */
       if (push_extra(ET_USING_JOIN_BUFFER, buff))
@@ -65,6 +65,7 @@ enum Extra_tag
   ET_IMPOSSIBLE_ON_CONDITION,
   ET_PUSHED_JOIN,
   ET_FT_HINTS,
+  ET_USING_INDEX_FOR_SKIP_SCAN,
   //------------------------------------
   ET_total
 };
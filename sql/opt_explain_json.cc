@@ -54,7 +54,8 @@ static const char *json_extra_tags[ET_total]=
   "unique_row_not_found",               // ET_UNIQUE_ROW_NOT_FOUND
   "impossible_on_condition",            // ET_IMPOSSIBLE_ON_CONDITION
   "pushed_join",                        // ET_PUSHED_JOIN
-  "ft_hints"                            // ET_FT_HINTS
+  "ft_hints",                           // ET_FT_HINTS
+  "using_index_for_skip_scan"           // ET_USING_INDEX_FOR_SKIP_SCAN
 };
 
 
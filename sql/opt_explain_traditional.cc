@@ -53,7 +53,8 @@ static const char *traditional_extra_tags[ET_total]=
   "unique row not found",              // ET_UNIQUE_ROW_NOT_FOUND
   "Impossible ON condition",           // ET_IMPOSSIBLE_ON_CONDITION
   "",                                  // ET_PUSHED_JOIN
-  "Ft_hints:"                          // ET_FT_HINTS
+  "Ft_hints:",                         // ET_FT_HINTS
+  "Using index for skip scan"          // ET_USING_INDEX_FOR_SKIP_SCAN
 };
 
 static const char *mod_type_name[]=
@@ -34,6 +34,7 @@ struct st_opt_hint_info opt_hint_info[]=
 {
   {"BKA", true, true},
   {"BNL", true, true},
+  {"HASH_JOIN", true, true},
   {"ICP", true, true},
   {"MRR", true, true},
   {"NO_RANGE_OPTIMIZATION", true, true},
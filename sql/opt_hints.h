@@ -44,6 +44,7 @@ enum opt_hints_enum
 {
   BKA_HINT_ENUM= 0,
   BNL_HINT_ENUM,
+  HASH_JOIN_HINT_ENUM,
   ICP_HINT_ENUM,
   MRR_HINT_ENUM,
   NO_RANGE_HINT_ENUM,
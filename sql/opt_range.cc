@@ -110,6 +110,7 @@
 
 #include "opt_range.h"
 
+#include "histogram.h"           // get_histogram_range_selectivity
 #include "item_sum.h"            // Item_sum
 #include "key.h"                 // is_key_used
 #include "log.h"                 // sql_print_error
@@ -1083,6 +1084,7 @@ class TABLE_READ_PLAN;
   class TRP_ROR_UNION;
   class TRP_INDEX_MERGE;
   class TRP_GROUP_MIN_MAX;
+  class TRP_SKIP_SCAN;
 
 struct st_ror_scan_info;
 
@@ -1116,6 +1118,8 @@ TABLE_READ_PLAN *get_best_disjunct_quick(PARAM *param, SEL_IMERGE *imerge,
 static
 TRP_GROUP_MIN_MAX *get_best_group_min_max(PARAM *param, SEL_TREE *tree,
                                           const Cost_estimate *cost_est);
+static
+TRP_SKIP_SCAN *get_best_skip_scan(PARAM *param, SEL_TREE *tree);
 #ifndef DBUG_OFF
 static void print_sel_tree(PARAM *param, SEL_TREE *tree, key_map *tree_map,
                            const char *msg);
@@ -2665,6 +2669,62 @@ void TRP_GROUP_MIN_MAX::trace_basic_info(const PARAM *param,
 #endif
 }
 
+
+/*
+  Plan for a QUICK_SKIP_SCAN_SELECT scan.
+*/
+
+class TRP_SKIP_SCAN : public TABLE_READ_PLAN
+{
+private:
+  KEY *index_info;          ///< The index chosen for data access
+  uint index;               ///< The id of the chosen index
+  uint prefix_key_parts;    ///< Number of key parts skipped over
+  uint prefix_len;          ///< Length of the skipped key parts
+  SEL_ARG *index_tree;      ///< Ranges over key part prefix_key_parts
+public:
+  void trace_basic_info(const PARAM *param,
+                        Opt_trace_object *trace_object) const;
+
+  TRP_SKIP_SCAN(KEY *index_info_arg, uint index_arg,
+                uint prefix_key_parts_arg, uint prefix_len_arg,
+                SEL_ARG *index_tree_arg)
+  : index_info(index_info_arg), index(index_arg),
+    prefix_key_parts(prefix_key_parts_arg), prefix_len(prefix_len_arg),
+    index_tree(index_tree_arg)
+    {}
+  virtual ~TRP_SKIP_SCAN() {}                 /* Remove gcc warning */
+
+  QUICK_SELECT_I *make_quick(PARAM *param, bool retrieve_full_rows,
+                             MEM_ROOT *parent_alloc);
+};
+
+void TRP_SKIP_SCAN::trace_basic_info(const PARAM *param,
+                                     Opt_trace_object *trace_object) const
+{
+#ifdef OPTIMIZER_TRACE
+  const KEY_PART_INFO *key_part= index_info->key_part;
+  trace_object->add_alnum("type", "skip_scan").
+    add_utf8("index", index_info->name).
+    add_utf8("range_attribute",
+             key_part[prefix_key_parts].field->field_name).
+    add("rows", records).
+    add("cost", cost_est);
+
+  Opt_trace_context * const trace= &param->thd->opt_trace;
+  {
+    Opt_trace_array trace_keyparts(trace, "key_parts_skipped");
+    for (uint partno= 0; partno < prefix_key_parts; partno++)
+      trace_keyparts.add_utf8(key_part[partno].field->field_name);
+  }
+  Opt_trace_array trace_range(trace, "ranges");
+  String range_info;
+  range_info.set_charset(system_charset_info);
+  append_range_all_keyparts(&trace_range, NULL,
+                            &range_info, index_tree, key_part, false);
+#endif
+}
+
 /*
   Fill param->needed_fields with bitmap of fields used in the query.
   SYNOPSIS
@@ -3066,6 +3126,33 @@ int test_quick_select(THD *thd, key_map keys_to_use,
         grp_summary.add("chosen", false).add_alnum("cause", "cost");
     }
 
+    /*
+      Try to construct a QUICK_SKIP_SCAN_SELECT for ranges that do not
+      start at the first key part of an index.
+    */
+    if (tree && thd->optimizer_switch_flag(OPTIMIZER_SWITCH_SKIP_SCAN))
+    {
+      TRP_SKIP_SCAN *skip_trp= get_best_skip_scan(&param, tree);
+      if (skip_trp)
+      {
+        Opt_trace_object skip_summary(trace,
+                                      "best_skip_scan_summary",
+                                      Opt_trace_context::RANGE_OPTIMIZER);
+        if (unlikely(trace->is_started()))
+          skip_trp->trace_basic_info(&param, &skip_summary);
+        if (skip_trp->cost_est < best_cost)
+        {
+          skip_summary.add("chosen", true);
+          best_trp= skip_trp;
+          best_cost= best_trp->cost_est;
+          param.table->quick_condition_rows=
+            min(skip_trp->records, param.table->quick_condition_rows);
+        }
+        else
+          skip_summary.add("chosen", false).add_alnum("cause", "cost");
+      }
+    }
+
     if (tree)
     {
       /*
@@ -11769,6 +11856,13 @@ void QUICK_GROUP_MIN_MAX_SELECT::add_info_string(String *str)
   str->append(')');
 }
 
+void QUICK_SKIP_SCAN_SELECT::add_info_string(String *str)
+{
+  str->append(STRING_WITH_LEN("index_for_skip_scan("));
+  str->append(index_info->name);
+  str->append(')');
+}
+
 void QUICK_RANGE_SELECT::add_keys_and_lengths(String *key_names,
                                               String *used_lengths)
 {
@@ -14575,6 +14669,589 @@ void QUICK_GROUP_MIN_MAX_SELECT::add_keys_and_lengths(String *key_names,
 }
 
 
+/*
+  Test if an index skip scan can be used, and if so build a plan for it.
+
+  SYNOPSIS
+    get_best_skip_scan()
+    param    Parameter from test_quick_select
+    tree     Range tree of the WHERE condition
+
+  DESCRIPTION
+    An index skip scan reads the ranges over key part k of an index
+    separately for every distinct value of the first k key parts, jumping
+    from one such prefix to the next through the index (see
+    QUICK_SKIP_SCAN_SELECT). It is considered for every index for which
+    the following holds:
+
+    SK1. The query is a plain SELECT without locking reads, and the
+         requested order is not descending.
+    SK2. The range tree is a single conjunction, i.e. it is not an index
+         merge.
+    SK3. The ranges over the index start at key part k > 0, so that there
+         is no usable range over the first key part, and none of the
+         ranges over key part k is unbounded at both ends.
+    SK4. The index is covering, supports ordered reads, and is not a
+         spatial index.
+
+    Ranges over key parts after k are not used for access; the conditions
+    they come from are evaluated on the rows returned by the scan.
+
+  NOTES
+    The cost is made up of one index dive per prefix to find the next
+    prefix and one per prefix and range to start the range, and of
+    reading the rows in the ranges. The number of prefixes is estimated
+    from the records per key of key part k-1, the number of rows from the
+    records per key of key part k for equality ranges, and from the
+    default filtering effects of the range predicates otherwise.
+
+  RETURN
+    The cheapest skip scan plan over all indexes, or NULL if none
+    applies.
+*/
+
+static TRP_SKIP_SCAN *get_best_skip_scan(PARAM *param, SEL_TREE *tree)
+{
+  THD *thd= param->thd;
+  TABLE *table= param->table;
+  TRP_SKIP_SCAN *best_trp= NULL;
+  Cost_estimate best_read_cost;
+  Opt_trace_context * const trace= &thd->opt_trace;
+  DBUG_ENTER("get_best_skip_scan");
+
+  Opt_trace_object trace_skip(trace, "skip_scan_range",
+                              Opt_trace_context::RANGE_OPTIMIZER);
+  const char* cause= NULL;
+  best_read_cost.set_max_cost();
+
+  /* Check (SK1) and (SK2). */
+  const thr_lock_type lock_type= table->reginfo.lock_type;
+  if (thd->lex->sql_command != SQLCOM_SELECT)
+    cause= "not_select";
+  else if (lock_type == TL_READ_WITH_SHARED_LOCKS ||
+           lock_type >= TL_READ_NO_INSERT)
+    cause= "locking_read";
+  else if (param->order_direction == ORDER::ORDER_DESC)
+    cause= "cannot_do_reverse_ordering";
+  else if (!tree->merges.is_empty())
+    cause= "disjuntive_predicate_present";
+  if (cause != NULL)
+  {
+    trace_skip.add("chosen", false).add_alnum("cause", cause);
+    DBUG_RETURN(NULL);
+  }
+
+  const ha_rows table_records= table->file->stats.records;
+  const Cost_model_table *const cost_model= table->cost_model();
+  Opt_trace_array trace_indexes(trace, "potential_skip_scan_indexes");
+  for (uint idx= 0; idx < param->keys; idx++)
+  {
+    SEL_ARG *const key_tree= tree->keys[idx];
+    /* Check (SK3): only ranges that do not start at the first key part. */
+    if (!key_tree || key_tree->type != SEL_ARG::KEY_RANGE ||
+        key_tree->part == 0)
+      continue;
+
+    const uint keynr= param->real_keynr[idx];
+    KEY *const index_info= &table->key_info[keynr];
+    const uint prefix_key_parts= key_tree->part;
+    Opt_trace_object trace_idx(trace);
+    trace_idx.add_utf8("index", index_info->name);
+
+    /* Check (SK4). */
+    if (!table->covering_keys.is_set(keynr))
+      cause= "not_covering";
+    else if (index_info->flags & HA_SPATIAL)
+      cause= "spatial_index";
+    else if (!(table->file->index_flags(keynr, prefix_key_parts, true) &
+               HA_READ_ORDER))
+      cause= "no_ordered_index_read";
+    if (cause != NULL)
+    {
+      trace_idx.add("usable", false).add_alnum("cause", cause);
+      cause= NULL;
+      continue;
+    }
+
+    uint prefix_len= 0;
+    for (uint i= 0; i < prefix_key_parts; i++)
+      prefix_len+= index_info->key_part[i].store_length;
+
+    /* Compute the number of keys per prefix, and per prefix and value. */
+    rec_per_key_t keys_per_group;
+    if (index_info->has_records_per_key(prefix_key_parts - 1))
+      keys_per_group= index_info->records_per_key(prefix_key_parts - 1);
+    else
+      keys_per_group= guess_rec_per_key(table, index_info, prefix_key_parts);
+    set_if_bigger(keys_per_group, 1.0f);
+
+    rec_per_key_t keys_per_subgroup;
+    if (index_info->has_records_per_key(prefix_key_parts))
+      keys_per_subgroup= index_info->records_per_key(prefix_key_parts);
+    else
+      keys_per_subgroup= guess_rec_per_key(table, index_info,
+                                           prefix_key_parts + 1);
+    set_if_smaller(keys_per_subgroup, keys_per_group);
+
+    const double num_groups= table_records / keys_per_group + 1;
+
+    /* Estimate the rows in the ranges; check the rest of (SK3). */
+    uint n_ranges= 0;
+    double rows= 0.0;
+    for (const SEL_ARG *range= key_tree->first(); range; range= range->next)
+    {
+      const uint range_flag= range->min_flag | range->max_flag;
+      if ((range_flag & NO_MIN_RANGE) && (range_flag & NO_MAX_RANGE))
+      {
+        cause= "unbounded_range";
+        break;
+      }
+      if (range_flag & GEOM_FLAG)
+      {
+        cause= "spatial_range";
+        break;
+      }
+      n_ranges++;
+      double selectivity;
+      if (range->is_singlepoint())
+        rows+= num_groups * keys_per_subgroup;
+      else if (!get_histogram_range_selectivity(
+                 param->thd, range->field,
+                 (range_flag & NO_MIN_RANGE) ? NULL : range->min_value,
+                 !(range->min_flag & NEAR_MIN),
+                 (range_flag & NO_MAX_RANGE) ? NULL : range->max_value,
+                 !(range->max_flag & NEAR_MAX), &selectivity))
+        rows+= table_records * selectivity;
+      else if (range_flag & (NO_MIN_RANGE | NO_MAX_RANGE))
+        rows+= table_records * COND_FILTER_INEQUALITY;
+      else
+        rows+= table_records * COND_FILTER_BETWEEN;
+    }
+    if (cause != NULL)
+    {
+      trace_idx.add("usable", false).add_alnum("cause", cause);
+      cause= NULL;
+      continue;
+    }
+    rows= min(rows, static_cast<double>(table_records));
+    set_if_bigger(rows, 1.0);
+
+    /*
+      One dive per prefix to find the next prefix and one per prefix and
+      range to start the range, plus the blocks holding the rows read.
+    */
+    const uint keys_per_block= (table->file->stats.block_size / 2 /
+                                (index_info->key_length +
+                                 table->file->ref_length) + 1);
+    const double num_blocks= (double) (table_records / keys_per_block) + 1;
+    const double io_blocks= min(num_groups * n_ranges + rows / keys_per_block,
+                                num_blocks);
+    const double tree_height= table_records == 0 ?
+                              1.0 :
+                              ceil(log(double(table_records)) /
+                                   log(double(keys_per_block + 1)));
+    const double tree_traversal_cost=
+      cost_model->key_compare_cost(tree_height);
+
+    Cost_estimate cur_read_cost;
+    cur_read_cost.add_io(cost_model->page_read_cost_index(keynr, io_blocks));
+    cur_read_cost.add_cpu(num_groups * (n_ranges + 1) * tree_traversal_cost +
+                          cost_model->row_evaluate_cost(rows));
+    const ha_rows cur_records= static_cast<ha_rows>(rows);
+
+    trace_idx.add("prefix_key_parts", prefix_key_parts).
+      add("prefixes", num_groups).
+      add("rows", cur_records).
+      add("cost", cur_read_cost);
+
+    if (cur_read_cost < best_read_cost)
+    {
+      best_trp= new (param->mem_root) TRP_SKIP_SCAN(index_info, keynr,
+                                                    prefix_key_parts,
+                                                    prefix_len, key_tree);
+      if (!best_trp)
+        DBUG_RETURN(NULL);
+      best_trp->cost_est= cur_read_cost;
+      best_trp->records= cur_records;
+      best_read_cost= cur_read_cost;
+    }
+  }
+
+  DBUG_RETURN(best_trp);
+}
+
+
+/*
+  Construct a new quick select for an index skip scan.
+
+  SYNOPSIS
+    TRP_SKIP_SCAN::make_quick()
+    param              Parameter from test_quick_select
+    retrieve_full_rows ignored
+    parent_alloc       ignored
+
+  NOTES
+    Make_quick ignores the retrieve_full_rows parameter because
+    QUICK_SKIP_SCAN_SELECT always performs 'index only' scans.
+
+  RETURN
+    New QUICK_SKIP_SCAN_SELECT object if successfully created,
+    NULL otherwise.
+*/
+
+QUICK_SELECT_I *
+TRP_SKIP_SCAN::make_quick(PARAM *param, bool retrieve_full_rows,
+                          MEM_ROOT *parent_alloc)
+{
+  QUICK_SKIP_SCAN_SELECT *quick;
+  DBUG_ENTER("TRP_SKIP_SCAN::make_quick");
+
+  quick= new QUICK_SKIP_SCAN_SELECT(param->thd, param->table, index_info,
+                                    index, prefix_key_parts, prefix_len,
+                                    &cost_est, records);
+  if (!quick)
+    DBUG_RETURN(NULL);
+
+  if (quick->init())
+  {
+    delete quick;
+    DBUG_RETURN(NULL);
+  }
+
+  /* Create an array of QUICK_RANGEs for the key part after the prefix. */
+  for (SEL_ARG *range= index_tree->first(); range; range= range->next)
+  {
+    if (quick->add_range(range))
+    {
+      delete quick;
+      DBUG_RETURN(NULL);
+    }
+  }
+
+  DBUG_RETURN(quick);
+}
+
+
+/*
+  Construct a new quick select for an index skip scan.
+
+  SYNOPSIS
+    QUICK_SKIP_SCAN_SELECT::QUICK_SKIP_SCAN_SELECT()
+    thd               Thread handle
+    table             The table being accessed
+    index_info        The index chosen for data access
+    use_index         The id of index_info
+    prefix_key_parts  Number of key parts skipped over
+    prefix_len        Length of the skipped key parts
+    read_cost         Cost of this access method
+    records           Number of records returned
+
+  RETURN
+    None
+*/
+
+QUICK_SKIP_SCAN_SELECT::
+QUICK_SKIP_SCAN_SELECT(THD *thd, TABLE *table, KEY *index_info_arg,
+                       uint use_index, uint prefix_key_parts_arg,
+                       uint prefix_len_arg, const Cost_estimate *read_cost_arg,
+                       ha_rows records_arg)
+  :index_info(index_info_arg), prefix_key_parts(prefix_key_parts_arg),
+   prefix_len(prefix_len_arg),
+   range_key_part(index_info_arg->key_part + prefix_key_parts_arg),
+   prefix(NULL), min_key(NULL), max_key(NULL), seen_first_key(false),
+   in_range(false), cur_range(0), ranges(PSI_INSTRUMENT_ME)
+{
+  head=       table;
+  index=      use_index;
+  record=     head->record[0];
+  cost_est= *read_cost_arg;
+  records= records_arg;
+  used_key_parts= prefix_key_parts + 1;
+  max_used_key_length= prefix_len + range_key_part->store_length;
+
+  init_sql_alloc(key_memory_quick_range_select_root,
+                 &alloc, thd->variables.range_alloc_block_size, 0);
+  thd->mem_root= &alloc;
+}
+
+
+/*
+  Do post-constructor initialization.
+
+  SYNOPSIS
+    QUICK_SKIP_SCAN_SELECT::init()
+
+  DESCRIPTION
+    Allocates the buffers for the current prefix and for the search keys
+    of the current range.
+
+  RETURN
+    0      OK
+    other  Error code
+*/
+
+int QUICK_SKIP_SCAN_SELECT::init()
+{
+  if (prefix) /* Already initialized. */
+    return 0;
+
+  if (!(prefix= (uchar*) alloc_root(&alloc, prefix_len)) ||
+      !(min_key= (uchar*) alloc_root(&alloc, max_used_key_length)) ||
+      !(max_key= (uchar*) alloc_root(&alloc, max_used_key_length)))
+    return 1;
+  return 0;
+}
+
+
+QUICK_SKIP_SCAN_SELECT::~QUICK_SKIP_SCAN_SELECT()
+{
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::~QUICK_SKIP_SCAN_SELECT");
+  if (head->file->inited)
+    /*
+      We may have used this object for index access during
+      create_sort_index() and then switched to rnd access for the rest
+      of execution. Since we don't do cleanup until now, we must call
+      ha_*_end() for whatever is the current access method.
+    */
+    head->file->ha_index_or_rnd_end();
+
+  free_root(&alloc,MYF(0));
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Create and add a new quick range object for the key part after the
+  prefix.
+
+  SYNOPSIS
+    QUICK_SKIP_SCAN_SELECT::add_range()
+    sel_range  Range object from which a QUICK_RANGE is constructed
+
+  NOTES
+    Ranges must be added in key order. get_best_skip_scan() has made
+    sure that no range is unbounded at both ends.
+
+  RETURN
+    FALSE on success
+    TRUE  otherwise
+*/
+
+bool QUICK_SKIP_SCAN_SELECT::add_range(SEL_ARG *sel_range)
+{
+  QUICK_RANGE *range;
+  uint range_flag= sel_range->min_flag | sel_range->max_flag;
+  const uint length= range_key_part->store_length;
+
+  DBUG_ASSERT(!((range_flag & NO_MIN_RANGE) && (range_flag & NO_MAX_RANGE)));
+  if (!(sel_range->min_flag & NO_MIN_RANGE) &&
+      !(sel_range->max_flag & NO_MAX_RANGE))
+  {
+    if (sel_range->maybe_null &&
+        sel_range->min_value[0] && sel_range->max_value[0])
+      range_flag|= NULL_RANGE; /* IS NULL condition */
+    else if (sel_range->is_singlepoint())
+      range_flag|= EQ_RANGE;  /* equality condition */
+  }
+  range= new (&alloc) QUICK_RANGE(sel_range->min_value, length,
+                                  make_keypart_map(sel_range->part),
+                                  sel_range->max_value, length,
+                                  make_keypart_map(sel_range->part),
+                                  range_flag, HA_READ_INVALID);
+  if (!range)
+    return TRUE;
+  if (ranges.push_back(range))
+    return TRUE;
+  return FALSE;
+}
+
+
+int QUICK_SKIP_SCAN_SELECT::reset(void)
+{
+  int result;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::reset");
+
+  seen_first_key= false;
+  in_range= false;
+  cur_range= ranges.size();
+  head->set_keyread(TRUE); /* We need only the key attributes */
+  if ((result= head->file->ha_index_init(index, true)))
+  {
+    head->file->print_error(result, MYF(0));
+    DBUG_RETURN(result);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Get the next row in the ranges of the current or a following prefix.
+
+  SYNOPSIS
+    QUICK_SKIP_SCAN_SELECT::get_next()
+
+  DESCRIPTION
+    Reads the ranges in key order within the current prefix. When the last
+    range of a prefix has been read, moves on to the next prefix and
+    starts again with the first range.
+
+  RETURN
+    0                  on success
+    HA_ERR_END_OF_FILE if returned all keys
+    other              if some error occurred
+*/
+
+int QUICK_SKIP_SCAN_SELECT::get_next()
+{
+  int result;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::get_next");
+
+  for (;;)
+  {
+    if (in_range)
+    {
+      result= head->file->read_range_next();
+      if (result != HA_ERR_END_OF_FILE)
+        DBUG_RETURN(result);
+      in_range= false;
+      cur_range++;
+    }
+
+    if (cur_range == ranges.size())
+    {
+      if ((result= next_prefix()))
+        DBUG_RETURN(result);
+      cur_range= 0;
+    }
+
+    result= read_range_first();
+    if (result == 0)
+    {
+      in_range= true;
+      DBUG_RETURN(0);
+    }
+    if (result != HA_ERR_END_OF_FILE)
+      DBUG_RETURN(result);
+    cur_range++;
+  }
+}
+
+
+/*
+  Move to the first key of the next distinct prefix.
+
+  SYNOPSIS
+    QUICK_SKIP_SCAN_SELECT::next_prefix()
+
+  DESCRIPTION
+    Reads the first key of the index, or the first key after the current
+    prefix, and saves its prefix.
+
+  RETURN
+    0                  on success
+    HA_ERR_END_OF_FILE if there are no more prefixes
+    other              if some error occurred
+*/
+
+int QUICK_SKIP_SCAN_SELECT::next_prefix()
+{
+  handler *const file= head->file;
+  int result;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::next_prefix");
+
+  /* The end of the last range must not stop the search for the prefix. */
+  file->set_end_range(NULL, handler::RANGE_SCAN_ASC);
+  if (!seen_first_key)
+  {
+    result= file->ha_index_first(record);
+    seen_first_key= true;
+  }
+  else
+    result= file->ha_index_read_map(record, prefix,
+                                    make_prev_keypart_map(prefix_key_parts),
+                                    HA_READ_AFTER_KEY);
+  if (result)
+    DBUG_RETURN(result == HA_ERR_KEY_NOT_FOUND ? HA_ERR_END_OF_FILE : result);
+
+  /* Save the prefix of this group for subsequent calls. */
+  key_copy(prefix, record, index_info, prefix_len);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Start reading the current range within the current prefix.
+
+  SYNOPSIS
+    QUICK_SKIP_SCAN_SELECT::read_range_first()
+
+  DESCRIPTION
+    Builds the search keys from the current prefix and the bounds of the
+    current range. An unbounded end of the range is bounded by the prefix.
+
+  RETURN
+    0                  on success
+    HA_ERR_END_OF_FILE if the range is empty in this prefix
+    other              if some error occurred
+*/
+
+int QUICK_SKIP_SCAN_SELECT::read_range_first()
+{
+  const QUICK_RANGE *const range= ranges[cur_range];
+  const key_part_map prefix_map= make_prev_keypart_map(prefix_key_parts);
+  key_range start_key, end_key;
+
+  memcpy(min_key, prefix, prefix_len);
+  start_key.key= min_key;
+  if (range->flag & NO_MIN_RANGE)
+  {
+    start_key.length= prefix_len;
+    start_key.keypart_map= prefix_map;
+    start_key.flag= HA_READ_KEY_EXACT;
+  }
+  else
+  {
+    memcpy(min_key + prefix_len, range->min_key, range->min_length);
+    start_key.length= prefix_len + range->min_length;
+    start_key.keypart_map= prefix_map | range->min_keypart_map;
+    start_key.flag= (range->flag & (EQ_RANGE | NULL_RANGE)) ?
+                    HA_READ_KEY_EXACT : (range->flag & NEAR_MIN) ?
+                    HA_READ_AFTER_KEY : HA_READ_KEY_OR_NEXT;
+  }
+
+  memcpy(max_key, prefix, prefix_len);
+  end_key.key= max_key;
+  if (range->flag & NO_MAX_RANGE)
+  {
+    end_key.length= prefix_len;
+    end_key.keypart_map= prefix_map;
+    end_key.flag= HA_READ_AFTER_KEY;
+  }
+  else
+  {
+    memcpy(max_key + prefix_len, range->max_key, range->max_length);
+    end_key.length= prefix_len + range->max_length;
+    end_key.keypart_map= prefix_map | range->max_keypart_map;
+    end_key.flag= (range->flag & NEAR_MAX) ?
+                  HA_READ_BEFORE_KEY : HA_READ_AFTER_KEY;
+  }
+
+  return head->file->read_range_first(&start_key, &end_key,
+                                      (range->flag & EQ_RANGE) != 0, true);
+}
+
+
+void QUICK_SKIP_SCAN_SELECT::add_keys_and_lengths(String *key_names,
+                                                  String *used_lengths)
+{
+  char buf[64];
+  size_t length;
+  key_names->append(index_info->name);
+  length= longlong2str(max_used_key_length, buf, 10) - buf;
+  used_lengths->append(buf, length);
+}
+
+
 
 /**
   Traverse the R-B range tree for this and later keyparts to see if
@@ -15299,5 +15976,15 @@ void QUICK_GROUP_MIN_MAX_SELECT::dbug_dump(int indent, bool verbose)
 }
 
 
+void QUICK_SKIP_SCAN_SELECT::dbug_dump(int indent, bool verbose)
+{
+  fprintf(DBUG_FILE,
+          "%*squick_skip_scan_select: index %s (%d), length: %d\n",
+          indent, "", index_info->name, index, max_used_key_length);
+  fprintf(DBUG_FILE, "%*sskipping %d key parts, %d quick_ranges\n",
+          indent, "", prefix_key_parts, static_cast<int>(ranges.size()));
+}
+
+
 #endif /* !DBUG_OFF */
 #endif /* OPT_RANGE_CC_INCLUDED */
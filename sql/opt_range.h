@@ -301,7 +301,8 @@ public:
     QS_TYPE_FULLTEXT   = 3,
     QS_TYPE_ROR_INTERSECT = 4,
     QS_TYPE_ROR_UNION = 5,
-    QS_TYPE_GROUP_MIN_MAX = 6
+    QS_TYPE_GROUP_MIN_MAX = 6,
+    QS_TYPE_SKIP_SCAN = 7
   };
 
   /* Get type of this quick select - one of the QS_TYPE_* values */
@@ -975,6 +976,78 @@ public:
 };
 
 
+/*
+  Index skip scan for conditions on a non-first key part.
+
+  This class provides an index access method for single-table queries of
+  the form
+
+       SELECT A_1,...,A_k, B, [C_1,...,C_m]
+         FROM T
+        WHERE RNG(B) [AND <other conditions>]
+
+  over an index (A_1,...,A_k,B,...) that covers all columns of the query,
+  where RNG(B) is a set of ranges over B and there is no usable range
+  over A_1. Instead of scanning the whole index, the scan jumps from one
+  distinct value of the prefix (A_1,...,A_k) to the next, and reads the
+  ranges over B within each prefix. This pays off when the prefix has few
+  distinct values. The conditions of the query are still evaluated on the
+  returned rows.
+
+  The conditions the query must satisfy are given in the description of
+  get_best_skip_scan() in opt_range.cc.
+*/
+
+class QUICK_SKIP_SCAN_SELECT : public QUICK_SELECT_I
+{
+private:
+  KEY  *index_info;       /* The index chosen for data access */
+  uchar *record;          /* Buffer where the next record is returned. */
+  const uint prefix_key_parts; /* Number of key parts skipped over */
+  const uint prefix_len;  /* Length of the skipped key parts */
+  KEY_PART_INFO *range_key_part; /* The key part the ranges are on */
+  uchar *prefix;          /* Key prefix of the current group */
+  uchar *min_key;         /* Prefix and range start of the current range */
+  uchar *max_key;         /* Prefix and range end of the current range */
+  bool seen_first_key;    /* Denotes whether the first key was retrieved.*/
+  bool in_range;          /* The current range has been started */
+  size_t cur_range;       /* Index of the current range in ranges */
+  Quick_ranges ranges;    /* Ranges over range_key_part, in key order */
+
+  int next_prefix();
+  int read_range_first();
+public:
+  MEM_ROOT alloc; /* Memory pool for this quick select's data. */
+
+  QUICK_SKIP_SCAN_SELECT(THD *thd, TABLE *table, KEY *index_info,
+                         uint use_index, uint prefix_key_parts,
+                         uint prefix_len, const Cost_estimate *cost_est,
+                         ha_rows records);
+  ~QUICK_SKIP_SCAN_SELECT();
+  bool add_range(SEL_ARG *sel_range);
+  int init();
+  void need_sorted_output() { /* always do it */ }
+  int reset();
+  int get_next();
+  bool reverse_sorted() const { return false; }
+  bool reverse_sort_possible() const { return false; }
+  bool unique_key_range() { return false; }
+  int get_type() const { return QS_TYPE_SKIP_SCAN; }
+  virtual bool is_loose_index_scan() const { return false; }
+  virtual bool is_agg_loose_index_scan() const { return false; }
+  void add_keys_and_lengths(String *key_names, String *used_lengths);
+#ifndef DBUG_OFF
+  void dbug_dump(int indent, bool verbose);
+#endif
+  virtual void get_fields_used(MY_BITMAP *used_fields)
+  {
+    for (uint i= 0; i < used_key_parts; i++)
+      bitmap_set_bit(used_fields, index_info->key_part[i].field->field_index);
+  }
+  void add_info_string(String *str);
+};
+
+
 class QUICK_SELECT_DESC: public QUICK_RANGE_SELECT
 {
 public:
@@ -315,7 +315,7 @@ int mysql_parser_get_statement_digest(MYSQL_THD thd, uchar *digest)
 {
   if (thd->m_digest == NULL)
     return true;
-  compute_digest_md5(&thd->m_digest->m_digest_storage, digest);
+  compute_digest_hash(&thd->m_digest->m_digest_storage, digest);
   return false;
 }
 
@@ -29,6 +29,7 @@
 
 static int rr_quick(READ_RECORD *info);
 int rr_sequential(READ_RECORD *info);
+static int rr_sequential_batch(READ_RECORD *info);
 static int rr_from_tempfile(READ_RECORD *info);
 template<bool> static int rr_unpack_from_tempfile(READ_RECORD *info);
 template<bool> static int rr_unpack_from_buffer(READ_RECORD *info);
@@ -534,6 +535,90 @@ int rr_sequential(READ_RECORD *info)
 }
 
 
+/*
+  Batches of rr_sequential_batch() start small, so that scans which are
+  stopped early read few rows ahead, and double up to the size of
+  read_buffer_size.
+*/
+static const uint MIN_READ_BATCH_ROWS= 8;
+static const uint MAX_READ_BATCH_ROWS= 1024;
+
+/**
+  Make a table scan set up by init_read_record() read rows from the
+  handler in batches, see handler::ha_rnd_next_batch().
+
+  The handler is positioned after the rows read ahead, so the caller
+  must not need the position of the current row, nor lock rows.
+
+  @param info    READ_RECORD structure of the scan
+  @param buffer  Buffer for the rows. If it points to NULL, a buffer is
+                 allocated on the THD mem_root, and can be reused by later
+                 scans of the same table in the statement.
+
+  @retval true   Rows are read in batches
+  @retval false  The table is read row by row
+*/
+
+bool init_read_record_batch(READ_RECORD *info, uchar **buffer)
+{
+  TABLE *const table= info->table;
+
+  /* BLOB and generated column values are kept outside of the record. */
+  if (info->read_record != rr_sequential ||
+      !(table->file->ha_table_flags() & HA_CAN_READ_BATCH) ||
+      table->s->blob_fields || table->has_gcol())
+    return false;
+
+  const uint rec_length= table->s->rec_buff_length;
+  ulong max_rows= info->thd->variables.read_buff_size / rec_length;
+  set_if_smaller(max_rows, MAX_READ_BATCH_ROWS);
+  if (max_rows < MIN_READ_BATCH_ROWS)
+    return false;
+
+  if (*buffer == NULL &&
+      !(*buffer= static_cast<uchar*>(info->thd->alloc(max_rows * rec_length))))
+    return false;
+
+  info->batch= *buffer;
+  info->batch_rows= MIN_READ_BATCH_ROWS;
+  info->max_batch_rows= max_rows;
+  info->batch_error= 0;
+  info->cache_pos= info->cache_end= info->batch;
+  info->reclength= table->s->reclength;
+  info->read_record= rr_sequential_batch;
+  return true;
+}
+
+
+static int rr_sequential_batch(READ_RECORD *info)
+{
+  TABLE *const table= info->table;
+
+  if (info->cache_pos == info->cache_end)
+  {
+    uint n_rows;
+
+    if (info->batch_error)
+      return rr_handle_error(info, info->batch_error);
+
+    info->batch_error= table->file->ha_rnd_next_batch(info->batch,
+                                                      info->batch_rows,
+                                                      &n_rows);
+    if (n_rows == 0)
+      return rr_handle_error(info, info->batch_error);
+
+    info->cache_pos= info->batch;
+    info->cache_end= info->batch + n_rows * table->s->rec_buff_length;
+    info->batch_rows= std::min(info->batch_rows * 2, info->max_batch_rows);
+  }
+
+  memcpy(info->record, info->cache_pos, info->reclength);
+  info->cache_pos+= table->s->rec_buff_length;
+  table->status= 0;
+  return 0;
+}
+
+
 static int rr_from_tempfile(READ_RECORD *info)
 {
   int tmp;
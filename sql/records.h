@@ -70,6 +70,14 @@ struct READ_RECORD
   struct st_io_cache *io_cache;
   bool print_error, ignore_not_found_rows;
 
+  /*
+    Rows read ahead by rr_sequential_batch(), between cache_pos and
+    cache_end. See init_read_record_batch().
+  */
+  uchar *batch;
+  uint batch_rows, max_batch_rows;
+  int batch_error;                        /* Error that ended the batch */
+
 public:
   READ_RECORD() {}
 };
@@ -81,6 +89,7 @@ bool init_read_record(READ_RECORD *info, THD *thd,
 bool init_read_record_idx(READ_RECORD *info, THD *thd, TABLE *table,
                           bool print_error, uint idx, bool reverse);
 void end_read_record(READ_RECORD *info);
+bool init_read_record_batch(READ_RECORD *info, uchar **buffer);
 
 void rr_unlock_row(QEP_TAB *tab);
 int rr_sequential(READ_RECORD *info);
@@ -33,6 +33,10 @@
 #include "sql_show.h"     // append_identifier
 #include "sql_table.h"    // write_bin_log
 
+#include <map>
+#include <string>
+#include <vector>
+
 /* Used in error handling only */
 #define SP_TYPE_STRING(LP) \
     ((LP)->sphead->m_type == SP_TYPE_FUNCTION ? "FUNCTION" : "PROCEDURE")
@@ -184,7 +188,8 @@ class Stored_routine_creation_ctx : public Stored_program_creation_ctx,
 {
 public:
   static Stored_routine_creation_ctx *
-  load_from_db(THD *thd, const sp_name *name, TABLE *proc_tbl);
+  load_from_db(THD *thd, const sp_name *name, TABLE *proc_tbl,
+               bool *invalid_ctx= NULL);
 
 public:
   virtual Stored_program_creation_ctx *clone(MEM_ROOT *mem_root)
@@ -272,7 +277,8 @@ bool load_collation(MEM_ROOT *mem_root,
 Stored_routine_creation_ctx *
 Stored_routine_creation_ctx::load_from_db(THD *thd,
                                          const sp_name *name,
-                                         TABLE *proc_tbl)
+                                         TABLE *proc_tbl,
+                                         bool *invalid_ctx)
 {
   /* Load character set/collation attributes. */
 
@@ -324,6 +330,9 @@ Stored_routine_creation_ctx::load_from_db(THD *thd,
     invalid_creation_ctx= TRUE;
   }
 
+  if (invalid_ctx)
+    *invalid_ctx= invalid_creation_ctx;
+
   if (invalid_creation_ctx)
   {
     push_warning_printf(thd,
@@ -558,6 +567,292 @@ db_find_routine_aux(THD *thd, enum_sp_type type, sp_name *name, TABLE *table)
 }
 
 
+/*************************************************************************
+  Routine definition cache.
+
+  Keeps the definitions of stored routines, as read from mysql.proc, for
+  all threads. A thread that does not have a routine in its sp_cache
+  compiles it from the cached definition instead of reading mysql.proc.
+  A definition is valid as long as sp_cache_version() has not changed
+  since it was read, so sp_cache_invalidate() also invalidates this
+  cache. Direct changes to mysql.proc invalidate it when the table is
+  closed, see close_thread_table().
+
+  A compiled sp_head is used by one thread at a time, as its
+  instructions are changed during execution. When a thread exits, the
+  routines in its sp_cache are kept with their definition, and a thread
+  that needs the routine later takes one over instead of compiling it.
+*************************************************************************/
+
+/** Definition of a stored routine as stored in mysql.proc */
+struct Sp_definition
+{
+  /// sp_cache_version() before the definition was read
+  int64 version;
+  sql_mode_t sql_mode;
+  const char *params;
+  const char *returns;
+  const char *body;
+  const char *definer;
+  st_sp_chistics chistics;
+  longlong created;
+  longlong modified;
+  Stored_program_creation_ctx *creation_ctx;
+};
+
+
+/**
+  Copies a routine definition, allocating strings and the creation
+  context on mem_root.
+
+  @return true if out of memory
+*/
+
+static bool copy_sp_definition(MEM_ROOT *mem_root, const Sp_definition *from,
+                               Sp_definition *to)
+{
+  *to= *from;
+  to->params= strdup_root(mem_root, from->params);
+  to->returns= strdup_root(mem_root, from->returns);
+  to->body= strdup_root(mem_root, from->body);
+  to->definer= strdup_root(mem_root, from->definer);
+  to->chistics.comment.str= strmake_root(mem_root, from->chistics.comment.str,
+                                         from->chistics.comment.length);
+  to->creation_ctx= from->creation_ctx->clone(mem_root);
+  return (to->params == NULL || to->returns == NULL || to->body == NULL ||
+          to->definer == NULL || to->chistics.comment.str == NULL ||
+          to->creation_ctx == NULL);
+}
+
+
+/** Compiled routines kept for each definition, see sp_cache_release() */
+static const size_t SP_DEFINITION_MAX_IDLE= 8;
+
+
+/**
+  A cached routine definition, the memory it is allocated on and the
+  compiled routines no thread uses.
+*/
+class Sp_definition_entry
+{
+public:
+  Sp_definition_entry()
+  {
+    init_sql_alloc(key_memory_sp_cache, &mem_root, 1024, 0);
+  }
+  ~Sp_definition_entry()
+  {
+    for (size_t i= 0; i < idle.size(); i++)
+      delete idle[i];
+    free_root(&mem_root, MYF(0));
+  }
+
+  MEM_ROOT mem_root;
+  Sp_definition def;
+  std::vector<sp_head *> idle;
+};
+
+typedef std::map<std::string, Sp_definition_entry *> Sp_definition_map;
+
+static Sp_definition_map *sp_definition_cache= NULL;
+static mysql_mutex_t LOCK_sp_definition_cache;
+
+
+void sp_definition_cache_init()
+{
+  DBUG_ASSERT(sp_definition_cache == NULL);
+  mysql_mutex_init(key_LOCK_sp_definition_cache, &LOCK_sp_definition_cache,
+                   MY_MUTEX_INIT_FAST);
+  sp_definition_cache= new Sp_definition_map;
+}
+
+
+static void sp_definition_cache_clear()
+{
+  mysql_mutex_assert_owner(&LOCK_sp_definition_cache);
+  for (Sp_definition_map::iterator it= sp_definition_cache->begin();
+       it != sp_definition_cache->end(); ++it)
+    delete it->second;
+  sp_definition_cache->clear();
+}
+
+
+void sp_definition_cache_free()
+{
+  if (sp_definition_cache == NULL)
+    return;
+  mysql_mutex_lock(&LOCK_sp_definition_cache);
+  sp_definition_cache_clear();
+  mysql_mutex_unlock(&LOCK_sp_definition_cache);
+  delete sp_definition_cache;
+  sp_definition_cache= NULL;
+  mysql_mutex_destroy(&LOCK_sp_definition_cache);
+}
+
+
+static std::string sp_definition_key(enum_sp_type type,
+                                     const LEX_CSTRING &db,
+                                     const LEX_CSTRING &name)
+{
+  std::string key(1, static_cast<char>(type));
+  key.append(db.str, db.length);
+  key.append(1, '\0');
+  key.append(name.str, name.length);
+  return key;
+}
+
+
+/**
+  Finds the valid cached definition for a key, dropping it if it is
+  out of date.
+
+  @return the definition, or NULL if there is none
+*/
+
+static Sp_definition_entry *sp_definition_cache_find(const std::string &key)
+{
+  mysql_mutex_assert_owner(&LOCK_sp_definition_cache);
+
+  Sp_definition_map::iterator it= sp_definition_cache->find(key);
+  if (it == sp_definition_cache->end())
+    return NULL;
+  if (it->second->def.version != sp_cache_version())
+  {
+    delete it->second;
+    sp_definition_cache->erase(it);
+    return NULL;
+  }
+  return it->second;
+}
+
+
+/**
+  Takes over a compiled routine that another thread has released.
+
+  @return the routine, or NULL if none is available
+*/
+
+static sp_head *sp_definition_cache_take(THD *thd, enum_sp_type type,
+                                         const sp_name *name)
+{
+  if (sp_definition_cache == NULL)
+    return NULL;
+
+  const std::string key= sp_definition_key(type, name->m_db,
+                                           to_lex_cstring(name->m_name));
+  sp_head *sp= NULL;
+
+  mysql_mutex_lock(&LOCK_sp_definition_cache);
+  Sp_definition_entry *entry= sp_definition_cache_find(key);
+  if (entry != NULL && !entry->idle.empty())
+  {
+    sp= entry->idle.back();
+    entry->idle.pop_back();
+  }
+  mysql_mutex_unlock(&LOCK_sp_definition_cache);
+
+  if (sp != NULL)
+    sp->set_thd(thd);
+  return sp;
+}
+
+
+/**
+  Keeps a routine released by an exiting thread with its definition,
+  for another thread to take over. The routine is deleted if it is out
+  of date, its definition is not cached or enough copies are kept.
+
+  @param sp  Routine, of which the cache takes ownership.
+*/
+
+void sp_definition_cache_release(sp_head *sp)
+{
+  if (sp_definition_cache == NULL || sp->is_invoked() ||
+      sp->sp_cache_version() != sp_cache_version())
+  {
+    delete sp;
+    return;
+  }
+
+  const std::string key= sp_definition_key(sp->m_type,
+                                           to_lex_cstring(sp->m_db),
+                                           to_lex_cstring(sp->m_name));
+
+  mysql_mutex_lock(&LOCK_sp_definition_cache);
+  Sp_definition_entry *entry= sp_definition_cache_find(key);
+  if (entry != NULL && entry->idle.size() < SP_DEFINITION_MAX_IDLE)
+  {
+    entry->idle.push_back(sp);
+    sp= NULL;
+  }
+  mysql_mutex_unlock(&LOCK_sp_definition_cache);
+
+  delete sp;
+}
+
+
+/**
+  Copies the cached definition of a routine to mem_root.
+
+  @return true if the routine has no valid definition in the cache
+*/
+
+static bool sp_definition_cache_get(enum_sp_type type, const sp_name *name,
+                                    MEM_ROOT *mem_root, Sp_definition *def)
+{
+  if (sp_definition_cache == NULL)
+    return true;
+
+  const std::string key= sp_definition_key(type, name->m_db,
+                                           to_lex_cstring(name->m_name));
+  bool error= true;
+
+  mysql_mutex_lock(&LOCK_sp_definition_cache);
+  Sp_definition_entry *entry= sp_definition_cache_find(key);
+  if (entry != NULL)
+    error= copy_sp_definition(mem_root, &entry->def, def);
+  mysql_mutex_unlock(&LOCK_sp_definition_cache);
+  return error;
+}
+
+
+/**
+  Adds the definition of a routine read from mysql.proc to the cache,
+  unless the cache has been invalidated since the definition was read.
+*/
+
+static void sp_definition_cache_put(enum_sp_type type, const sp_name *name,
+                                    const Sp_definition *def)
+{
+  if (sp_definition_cache == NULL || def->version != sp_cache_version())
+    return;
+
+  Sp_definition_entry *entry= new (std::nothrow) Sp_definition_entry;
+  if (entry == NULL)
+    return;
+  if (copy_sp_definition(&entry->mem_root, def, &entry->def))
+  {
+    delete entry;
+    return;
+  }
+
+  const std::string key= sp_definition_key(type, name->m_db,
+                                           to_lex_cstring(name->m_name));
+
+  mysql_mutex_lock(&LOCK_sp_definition_cache);
+  if (sp_definition_cache->size() >= stored_program_cache_size)
+    sp_definition_cache_clear();
+  std::pair<Sp_definition_map::iterator, bool> res=
+    sp_definition_cache->insert(std::make_pair(key, entry));
+  if (!res.second)
+  {
+    delete res.first->second;
+    res.first->second= entry;
+  }
+  mysql_mutex_unlock(&LOCK_sp_definition_cache);
+}
+
+
 /**
   Find routine definition in mysql.proc table and create corresponding
   sp_head object for it.
@@ -596,12 +891,34 @@ db_find_routine(THD *thd, enum_sp_type type, sp_name *name, sp_head **sphp)
   sql_mode_t sql_mode, saved_mode= thd->variables.sql_mode;
   Open_tables_backup open_tables_state_backup;
   Stored_program_creation_ctx *creation_ctx;
+  bool invalid_creation_ctx;
+  Sp_definition def;
 
   DBUG_ENTER("db_find_routine");
   DBUG_PRINT("enter", ("type: %d name: %.*s",
 		       type, (int) name->m_name.length, name->m_name.str));
 
   *sphp= 0;                                     // In case of errors
+
+  if ((*sphp= sp_definition_cache_take(thd, type, name)))
+  {
+    DBUG_PRINT("info", ("taken over from routine definition cache"));
+    DBUG_RETURN(SP_OK);
+  }
+
+  if (!sp_definition_cache_get(type, name, thd->mem_root, &def))
+  {
+    DBUG_PRINT("info", ("found in routine definition cache"));
+    DBUG_RETURN(db_load_routine(thd, type, name, sphp,
+                                def.sql_mode, def.params, def.returns,
+                                def.body, def.chistics, def.definer,
+                                def.created, def.modified,
+                                def.creation_ctx));
+  }
+
+  /* Read before the row, so that a concurrent change is not missed. */
+  def.version= sp_cache_version();
+
   if (!(table= open_proc_table_for_read(thd, &open_tables_state_backup)))
     DBUG_RETURN(SP_OPEN_TABLE_FAILED);
 
@@ -700,7 +1017,8 @@ db_find_routine(THD *thd, enum_sp_type type, sp_name *name, sp_head **sphp)
   chistics.comment.str= ptr;
   chistics.comment.length= length;
 
-  creation_ctx= Stored_routine_creation_ctx::load_from_db(thd, name, table);
+  creation_ctx= Stored_routine_creation_ctx::load_from_db(thd, name, table,
+                                                        &invalid_creation_ctx);
 
   close_nontrans_system_tables(thd, &open_tables_state_backup);
   table= 0;
@@ -708,6 +1026,24 @@ db_find_routine(THD *thd, enum_sp_type type, sp_name *name, sp_head **sphp)
   ret= db_load_routine(thd, type, name, sphp,
                        sql_mode, params, returns, body, chistics,
                        definer, created, modified, creation_ctx);
+
+  /*
+    A definition with an invalid creation context depends on the session
+    character set and produces warnings, so it is always read again.
+  */
+  if (ret == SP_OK && !invalid_creation_ctx)
+  {
+    def.sql_mode= sql_mode;
+    def.params= params;
+    def.returns= returns;
+    def.body= body;
+    def.definer= definer;
+    def.chistics= chistics;
+    def.created= created;
+    def.modified= modified;
+    def.creation_ctx= creation_ctx;
+    sp_definition_cache_put(type, name, &def);
+  }
  done:
   /* 
     Restore the time zone flag as the timezone usage in proc table
@@ -104,6 +104,14 @@ int sp_cache_routine(THD *thd, enum_sp_type type, sp_name *name,
 
 bool sp_exist_routines(THD *thd, TABLE_LIST *procs, bool is_proc);
 
+/*
+  Routine definition cache, shared by all threads. See
+  sp_definition_cache_get() in sp.cc.
+*/
+void sp_definition_cache_init();
+void sp_definition_cache_free();
+void sp_definition_cache_release(sp_head *sp);
+
 bool sp_show_create_routine(THD *thd, enum_sp_type type, sp_name *name);
 
 bool sp_create_routine(THD *thd, sp_head *sp);
@@ -17,6 +17,7 @@
 #include "sp_cache.h"
 
 #include "my_atomic.h"
+#include "sp.h"                                 // sp_definition_cache_release
 #include "sp_head.h"
 
 
@@ -94,6 +95,20 @@ public:
       my_hash_reset(&m_hashtable);
   }
 
+  /**
+    Hand all routines over to the routine definition cache, which takes
+    ownership of them, and empty the cache.
+  */
+  void release()
+  {
+    for (ulong i= 0; i < m_hashtable.records; i++)
+      sp_definition_cache_release((sp_head *) my_hash_element(&m_hashtable,
+                                                              i));
+    /* The routines are no longer ours to free. */
+    m_hashtable.free= NULL;
+    my_hash_reset(&m_hashtable);
+  }
+
 private:
   /* All routines in this cache */
   HASH m_hashtable;
@@ -126,6 +141,27 @@ void sp_cache_clear(sp_cache **cp)
 }
 
 
+/**
+  Clear the cache *cp at thread exit and set *cp to NULL. Routines that
+  are up to date are kept by the routine definition cache, so that other
+  threads need not compile them again.
+
+  @param cp  Pointer to cache to release
+*/
+
+void sp_cache_release(sp_cache **cp)
+{
+  sp_cache *c= *cp;
+
+  if (c)
+  {
+    c->release();
+    delete c;
+    *cp= NULL;
+  }
+}
+
+
 /*
   Insert a routine into the cache.
 
@@ -45,10 +45,11 @@ class sp_name;
     sp_cache_flush_obsolete();
 
   2. Before thread exit:
-    sp_cache_clear();
+    sp_cache_release();
 */
 
 void sp_cache_clear(sp_cache **cp);
+void sp_cache_release(sp_cache **cp);
 void sp_cache_insert(sp_cache **cp, sp_head *sp);
 sp_head *sp_cache_lookup(sp_cache **cp, sp_name *name);
 void sp_cache_invalidate();
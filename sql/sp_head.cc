@@ -505,6 +505,19 @@ sp_head::~sp_head()
 }
 
 
+void sp_head::set_thd(THD *thd)
+{
+  DBUG_ASSERT(!is_invoked());
+
+  for (sp_head *sp= this; sp; sp= sp->m_next_cached_sp)
+  {
+    sp_instr *i;
+    for (uint ip= 0; (i= sp->get_instr(ip)); ip++)
+      i->set_thd(thd);
+  }
+}
+
+
 Field *sp_head::create_result_field(size_t field_max_length,
                                     const char *field_name,
                                     TABLE *table)
@@ -627,6 +627,14 @@ public:
   void set_creation_ctx(Stored_program_creation_ctx *creation_ctx)
   { m_creation_ctx= creation_ctx->clone(mem_root); }
 
+  /**
+    Make this routine and its recursion instances refer to another
+    thread. The routine must not be running.
+
+    @param thd  Thread that takes the routine over.
+  */
+  void set_thd(THD *thd);
+
   /// Set the body-definition start position.
   void set_body_start(THD *thd, const char *begin_ptr);
 
@@ -813,6 +813,18 @@ void sp_lex_instr::free_lex()
 }
 
 
+void sp_lex_instr::set_thd(THD *thd)
+{
+  if (!m_lex)
+    return;
+
+  m_lex->thd= thd;
+  for (SELECT_LEX *sl= m_lex->all_selects_list; sl;
+       sl= sl->next_select_in_list())
+    sl->master_unit()->thd= thd;
+}
+
+
 void sp_lex_instr::cleanup_before_parsing(THD *thd)
 {
   /*
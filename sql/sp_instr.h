@@ -155,6 +155,13 @@ public:
   virtual SQL_I_List<Item_trigger_field>* get_instr_trig_field_list()
   { return NULL; }
 
+  /**
+    Make the instruction refer to another thread. Used when a compiled
+    routine is handed over from a thread that has finished with it.
+  */
+  virtual void set_thd(THD *thd)
+  { }
+
 protected:
   /// Show if this instruction is reachable within the SP
   /// (used by SP-optimizer).
@@ -243,6 +250,8 @@ public:
     return m_lex ? &m_lex->prepared_stmt_name : NULL;
   }
 
+  virtual void set_thd(THD *thd);
+
 private:
   /**
     Prepare LEX and thread for execution of instruction, if requested open
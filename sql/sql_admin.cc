@@ -33,10 +33,36 @@
 #include "log.h"
 #include "myisam.h"                          // TT_USEFRM
 #include "sql_alter_instance.h"              // Alter_instance
+#include "histogram.h"                       // build_histograms
 
 #include "pfs_file_provider.h"
 #include "mysql/psi/mysql_file.h"
 
+/**
+  Sends the metadata of the result set of table maintenance statements.
+
+  @return true if sending failed
+*/
+static bool send_admin_result_metadata(THD *thd)
+{
+  List<Item> field_list;
+  Item *item;
+
+  field_list.push_back(item = new Item_empty_string("Table", NAME_CHAR_LEN*2));
+  item->maybe_null = 1;
+  field_list.push_back(item = new Item_empty_string("Op", 10));
+  item->maybe_null = 1;
+  field_list.push_back(item = new Item_empty_string("Msg_type", 10));
+  item->maybe_null = 1;
+  field_list.push_back(item = new Item_empty_string("Msg_text",
+                                                    SQL_ADMIN_MSG_TEXT_SIZE));
+  item->maybe_null = 1;
+  return thd->send_result_metadata(&field_list,
+                                   Protocol::SEND_NUM_ROWS |
+                                   Protocol::SEND_EOF);
+}
+
+
 static int send_check_errmsg(THD *thd, TABLE_LIST* table,
 			     const char* operator_name, const char* errmsg)
 
@@ -285,8 +311,6 @@ static bool mysql_admin_table(THD* thd, TABLE_LIST* tables,
 
   TABLE_LIST *table;
   SELECT_LEX *select= thd->lex->select_lex;
-  List<Item> field_list;
-  Item *item;
   Protocol *protocol= thd->get_protocol();
   LEX *lex= thd->lex;
   int result_code;
@@ -297,17 +321,7 @@ static bool mysql_admin_table(THD* thd, TABLE_LIST* tables,
   bool ignore_grl_on_analyze= operator_func == &handler::ha_analyze;
   DBUG_ENTER("mysql_admin_table");
 
-  field_list.push_back(item = new Item_empty_string("Table", NAME_CHAR_LEN*2));
-  item->maybe_null = 1;
-  field_list.push_back(item = new Item_empty_string("Op", 10));
-  item->maybe_null = 1;
-  field_list.push_back(item = new Item_empty_string("Msg_type", 10));
-  item->maybe_null = 1;
-  field_list.push_back(item = new Item_empty_string("Msg_text",
-                                                    SQL_ADMIN_MSG_TEXT_SIZE));
-  item->maybe_null = 1;
-  if (thd->send_result_metadata(&field_list,
-                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+  if (send_admin_result_metadata(thd))
     DBUG_RETURN(TRUE);
 
   /*
@@ -1217,9 +1231,12 @@ bool Sql_cmd_analyze_table::execute(THD *thd)
     goto error;
 
   thd->set_slow_log_for_admin_command();
-  res= mysql_admin_table(thd, first_table, &thd->lex->check_opt,
-                         "analyze", lock_type, 1, 0, 0, 0,
-                         &handler::ha_analyze, 0);
+  if (m_histogram_command != HISTOGRAM_NONE)
+    res= handle_histogram_command(thd, first_table);
+  else
+    res= mysql_admin_table(thd, first_table, &thd->lex->check_opt,
+                           "analyze", lock_type, 1, 0, 0, 0,
+                           &handler::ha_analyze, 0);
   /* ! we write after unlocking the table */
   if (!res && !thd->lex->no_write_to_binlog)
   {
@@ -1236,6 +1253,175 @@ error:
 }
 
 
+/**
+  Sends a row of the result set of ANALYZE TABLE ... HISTOGRAM.
+
+  @return true if sending failed
+*/
+static bool send_histogram_message(THD *thd, const char *table_name,
+                                   const char *msg_type, const char *msg)
+{
+  Protocol *protocol= thd->get_protocol();
+  protocol->start_row();
+  protocol->store(table_name, system_charset_info);
+  protocol->store(STRING_WITH_LEN("histogram"), system_charset_info);
+  protocol->store(msg_type, system_charset_info);
+  protocol->store(msg, system_charset_info);
+  return protocol->end_row();
+}
+
+
+bool Sql_cmd_analyze_table::handle_histogram_command(THD *thd,
+                                                     TABLE_LIST *table)
+{
+  Disable_autocommit_guard autocommit_guard(thd);
+  char table_name[NAME_LEN*2+2];
+  char msg[MYSQL_ERRMSG_SIZE];
+  const uint max_columns= m_histogram_columns->elements;
+  const bool update= m_histogram_command == HISTOGRAM_UPDATE;
+  const uint num_buckets= m_histogram_buckets ?
+    static_cast<uint>(m_histogram_buckets) : HISTOGRAM_DEFAULT_BUCKETS;
+  Field **fields;
+  const char **columns;
+  Histogram **histograms;
+  bool *dropped;
+  uint num_columns= 0;
+  bool error;
+  DBUG_ENTER("Sql_cmd_analyze_table::handle_histogram_command");
+
+  if (table->next_local != NULL)
+  {
+    my_error(ER_WRONG_USAGE, MYF(0), "HISTOGRAM", "multiple tables");
+    DBUG_RETURN(true);
+  }
+  if (update && m_histogram_buckets > HISTOGRAM_MAX_BUCKETS)
+  {
+    my_error(ER_WRONG_ARGUMENTS, MYF(0), "WITH BUCKETS");
+    DBUG_RETURN(true);
+  }
+
+  if (!multi_alloc_root(thd->mem_root,
+                        &fields, max_columns * sizeof(Field*),
+                        &columns, max_columns * sizeof(char*),
+                        &histograms, max_columns * sizeof(Histogram*),
+                        &dropped, max_columns * sizeof(bool),
+                        NullS))
+    DBUG_RETURN(true);                          /* purecov: inspected */
+
+  /* Close the pre-opened temporary tables, as mysql_admin_table() does. */
+  close_thread_tables(thd);
+  table->table= NULL;
+  /*
+    Sample the rows with a consistent read, like CHECKSUM TABLE, so that
+    building histograms neither blocks nor is blocked by writers.
+  */
+  table->lock_type= TL_READ;
+  table->mdl_request.set_type(MDL_SHARED_READ);
+  if (open_temporary_tables(thd, table) || open_and_lock_tables(thd, table, 0))
+    goto err;
+  if (table->is_view() || table->table->s->tmp_table != NO_TMP_TABLE)
+  {
+    my_error(ER_WRONG_OBJECT, MYF(0), table->db, table->table_name,
+             "BASE TABLE");
+    goto err;
+  }
+
+  strxmov(table_name, table->db, ".", table->table_name, NullS);
+  if (send_admin_result_metadata(thd))
+    goto err;
+
+  {
+    List_iterator<String> it(*m_histogram_columns);
+    String *name;
+    while ((name= it++))
+    {
+      Field *field= find_field_in_table_sef(table->table, name->c_ptr_safe());
+      const char *column= field ? field->field_name : name->c_ptr_safe();
+      bool duplicate= false;
+      for (uint i= 0; i < num_columns && !duplicate; i++)
+        duplicate= !my_strcasecmp(system_charset_info, columns[i], column);
+      if (duplicate)
+        continue;
+
+      if (update && field == NULL)
+      {
+        my_snprintf(msg, sizeof(msg), "The column '%s' does not exist.",
+                    column);
+        if (send_histogram_message(thd, table_name, "error", msg))
+          goto err;
+        continue;
+      }
+      if (update && !histogram_supports_field(field))
+      {
+        my_snprintf(msg, sizeof(msg),
+                    "The column '%s' has an unsupported data type.", column);
+        if (send_histogram_message(thd, table_name, "error", msg))
+          goto err;
+        continue;
+      }
+      /*
+        Field names live in the TABLE_SHARE, which may go away once the
+        table is closed.
+      */
+      if (!(columns[num_columns]= thd->mem_strdup(column)))
+        goto err;                               /* purecov: inspected */
+      fields[num_columns++]= field;
+    }
+  }
+
+  if (update && num_columns > 0 &&
+      build_histograms(thd, table->table, fields, num_columns, num_buckets,
+                       thd->mem_root, histograms))
+    goto err;
+
+  trans_commit_stmt(thd);
+  close_thread_tables(thd);
+  thd->mdl_context.release_transactional_locks();
+  table->table= NULL;
+  table->mdl_request.ticket= NULL;
+
+  if (num_columns > 0)
+  {
+    error= update ?
+      store_histograms(thd, table->db, table->table_name, columns,
+                       num_columns, histograms) :
+      drop_histograms(thd, table->db, table->table_name, columns,
+                      num_columns, dropped);
+    if (error)
+      DBUG_RETURN(true);
+  }
+
+  for (uint i= 0; i < num_columns; i++)
+  {
+    if (update)
+      my_snprintf(msg, sizeof(msg),
+                  "Histogram statistics created for column '%s'.",
+                  columns[i]);
+    else if (dropped[i])
+      my_snprintf(msg, sizeof(msg),
+                  "Histogram statistics removed for column '%s'.",
+                  columns[i]);
+    else
+      my_snprintf(msg, sizeof(msg),
+                  "No histogram statistics found for column '%s'.",
+                  columns[i]);
+    if (send_histogram_message(thd, table_name, "status", msg))
+      DBUG_RETURN(true);
+  }
+
+  my_eof(thd);
+  DBUG_RETURN(false);
+
+err:
+  trans_rollback_stmt(thd);
+  close_thread_tables(thd);
+  thd->mdl_context.release_transactional_locks();
+  table->table= NULL;
+  table->mdl_request.ticket= NULL;
+  DBUG_RETURN(true);
+}
+
+
 bool Sql_cmd_check_table::execute(THD *thd)
 {
   TABLE_LIST *first_table= thd->lex->select_lex->get_table_list();
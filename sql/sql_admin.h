@@ -19,8 +19,10 @@
 #include "my_global.h"
 #include "sql_cmd.h"       // Sql_cmd
 
+class String;
 class THD;
 struct TABLE_LIST;
+template <class T> class List;
 typedef struct st_key_cache KEY_CACHE;
 typedef struct st_mysql_lex_string LEX_STRING;
 
@@ -39,10 +41,28 @@ int reassign_keycache_tables(THD* thd, KEY_CACHE *src_cache,
 class Sql_cmd_analyze_table : public Sql_cmd
 {
 public:
+  /** Histogram clause of the statement */
+  enum enum_histogram_command
+  {
+    HISTOGRAM_NONE,
+    /** UPDATE HISTOGRAM ON columns [WITH n BUCKETS] */
+    HISTOGRAM_UPDATE,
+    /** DROP HISTOGRAM ON columns */
+    HISTOGRAM_DROP
+  };
+
   /**
     Constructor, used to represent a ANALYZE TABLE statement.
+
+    @param command      histogram clause, if any
+    @param columns      columns of the histogram clause
+    @param num_buckets  number of buckets of UPDATE HISTOGRAM, or 0 for
+                        the default
   */
-  Sql_cmd_analyze_table()
+  Sql_cmd_analyze_table(enum_histogram_command command= HISTOGRAM_NONE,
+                        List<String> *columns= NULL, ulong num_buckets= 0)
+    : m_histogram_command(command), m_histogram_columns(columns),
+      m_histogram_buckets(num_buckets)
   {}
 
   ~Sql_cmd_analyze_table()
@@ -54,6 +74,17 @@ public:
   {
     return SQLCOM_ANALYZE;
   }
+
+private:
+  /**
+    Builds or drops the histograms of the statement instead of updating
+    the index statistics.
+  */
+  bool handle_histogram_command(THD *thd, TABLE_LIST *table);
+
+  enum_histogram_command m_histogram_command;
+  List<String> *m_histogram_columns;
+  ulong m_histogram_buckets;
 };
 
 
@@ -54,6 +54,8 @@
 #include "log.h"
 #include "binlog.h"
 #include "sql_audit.h"  // mysql_audit_table_access_notify
+#include "histogram.h"  // attach_histograms
+#include "frm_cache.h"  // frm_cache_invalidate
 
 #ifdef HAVE_REPLICATION
 #include "rpl_rli.h"    //Relay_log_information
@@ -729,6 +731,8 @@ TABLE_SHARE *get_table_share(THD *thd, TABLE_LIST *table_list,
   mysql_mutex_unlock(&LOCK_open);
   DEBUG_SYNC(thd, "get_share_before_open");
   open_table_err= open_table_def(thd, share, db_flags);
+  if (!open_table_err)
+    attach_histograms(share);
 
   /*
     Get back LOCK_open before continuing. Notify all waiters that the
@@ -1179,6 +1183,7 @@ bool close_cached_tables(THD *thd, TABLE_LIST *tables,
     /* Free table shares which were not freed implicitly by loop above. */
     while (oldest_unused_share->next)
       (void) my_hash_delete(&table_def_cache, (uchar*) oldest_unused_share);
+    frm_cache_flush();
   }
   else
   {
@@ -1744,6 +1749,15 @@ void close_thread_table(THD *thd, TABLE **table_ptr)
   table->mdl_ticket= NULL;
   table->pos_in_table_list= NULL;
 
+  /*
+    Stored routine DDL invalidates the routine caches itself, but
+    direct changes to mysql.proc do not go through it.
+  */
+  if (table->reginfo.lock_type >= TL_WRITE_ALLOW_WRITE &&
+      table->s->table_category == TABLE_CATEGORY_SYSTEM &&
+      !my_strcasecmp(system_charset_info, table->s->table_name.str, "proc"))
+    sp_cache_invalidate();
+
   mysql_mutex_lock(&thd->LOCK_thd_data);
 
   if(unlikely(opt_userstat && table->file))
@@ -4420,6 +4434,39 @@ err:
 }
 
 
+/**
+  Get the .TRG file of a table from its TABLE_SHARE, reading the file
+  if this is the first TABLE opened for the share.
+
+  @param      share    share of the table
+  @param[out] trg_def  the file, NULL if the table has no triggers
+
+  @return true on error, which has been reported
+*/
+
+static bool get_share_trg_def(TABLE_SHARE *share, const File_parser **trg_def)
+{
+  bool error= false;
+
+  mysql_mutex_lock(&share->LOCK_ha_data);
+  if (!share->trg_def_loaded)
+  {
+    if (Trigger_loader::trg_file_exists(share->db.str, share->table_name.str))
+    {
+      share->trg_def= Trigger_loader::read_trg_file(&share->mem_root,
+                                                    share->db.str,
+                                                    share->table_name.str);
+      error= (share->trg_def == NULL);
+    }
+    share->trg_def_loaded= !error;
+  }
+  *trg_def= share->trg_def;
+  mysql_mutex_unlock(&share->LOCK_ha_data);
+
+  return error;
+}
+
+
 /**
    Finalize the process of TABLE creation by loading table triggers
    and taking action if a HEAP table content was emptied implicitly.
@@ -4427,11 +4474,16 @@ err:
 
 static bool open_table_entry_fini(THD *thd, TABLE_SHARE *share, TABLE *entry)
 {
-  if (Trigger_loader::trg_file_exists(share->db.str, share->table_name.str))
+  const File_parser *trg_def;
+
+  if (get_share_trg_def(share, &trg_def))
+    return true;
+
+  if (trg_def)
   {
     Table_trigger_dispatcher *d= Table_trigger_dispatcher::create(entry);
 
-    if (!d || d->check_n_load(thd, false))
+    if (!d || d->check_n_load(thd, false, trg_def))
     {
       delete d;
       return true;
@@ -9978,6 +10030,14 @@ void tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
     }
   }
 
+  /*
+    The .frm may be rewritten within the resolution of its modification
+    time, so do not rely on the checks of the frm cache alone.
+  */
+  char path[FN_REFLEN + 1];
+  build_table_filename(path, sizeof(path) - 1, db, table_name, reg_ext, 0);
+  frm_cache_invalidate(path);
+
   if (! has_lock)
     table_cache_manager.unlock_all_and_tdc();
 }
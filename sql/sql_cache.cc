@@ -106,8 +106,23 @@ allocated.
 5. Table of database table lists.
 
 For quick invalidation of queries all query are linked in lists on used
-database tables basis (when table will be changed (insert/delete/...)
-this queries will be removed from cache).
+database tables basis (when a whole database is dropped this queries
+will be removed from cache).
+
+When a single table is changed (insert/delete/...) only its generation
+number (Query_cache::table_generations) is incremented. Every query
+remembers the generation numbers of its tables in its table list when
+it is registered. A lookup never serves a query whose generation
+numbers have changed. Threads that lock the cache to look up or to store
+a query also sweep the cached tables a few at a time and free the
+queries of changed tables (Query_cache::free_invalidated_queries_internal),
+so that the cache does not prune live queries to make room for them.
+This way writers do not take structure_guard_mutex, and a lookup does a
+bounded amount of sweeping however many tables are cached.
+
+The Qcache_queries_in_cache, Qcache_free_memory, Qcache_free_blocks and
+Qcache_total_blocks status variables finish the sweep before they are
+read, so they do not count queries of changed tables.
 
 Root of such list is table block:
 
@@ -288,8 +303,11 @@ functions:
  4. Query_cache::invalidate
     Query_cache::invalidate_locked_for_write
        - Called from various places to invalidate query cache based on data-
-         base, table and myisam file name. During an on going invalidation
-         the query cache is temporarily disabled.
+         base, table and myisam file name. Tables are invalidated by
+         incrementing their generation number, the stale queries are freed
+         by Query_cache::free_invalidated_queries_internal. During an on
+         going invalidation of a database the query cache is temporarily
+         disabled.
  5. Query_cache::flush
        - Used when a RESET QUERY CACHE is issued. This clears the entire
          cache block by block.
@@ -339,6 +357,8 @@ TODO list:
 #include <m_ctype.h>
 #include <my_dir.h>
 #include <hash.h>
+#include "my_atomic.h"
+#include "my_murmur3.h"                         // murmur3_32
 #include "../storage/myisammrg/ha_myisammrg.h"
 #include "../storage/myisammrg/myrg_def.h"
 #include "probes_mysql.h"
@@ -1395,6 +1415,10 @@ Query_cache::Query_cache(ulong query_cache_limit_arg,
    def_table_hash_size(ALIGN_SIZE(def_table_hash_size_arg)),
    initialized(0)
 {
+  for (uint i= 0; i < QUERY_CACHE_TABLE_GENERATIONS; i++)
+    table_generations[i]= 0;
+  m_invalidations_pending= 0;
+  m_sweep_cursor= NULL;
   ulong min_needed= (ALIGN_SIZE(sizeof(Query_cache_block)) +
 		     ALIGN_SIZE(sizeof(Query_cache_block_table)) +
 		     ALIGN_SIZE(sizeof(Query_cache_query)) + 3);
@@ -1593,6 +1617,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
       unlock();
       DBUG_VOID_RETURN;
     }
+    free_invalidated_queries_internal(thd, QUERY_CACHE_SWEEP_TABLES);
     DUMP(this);
 
     if (ask_handler_allowance(thd, tables_used))
@@ -1945,6 +1970,8 @@ int Query_cache::send_result_to_client(THD *thd, const LEX_CSTRING &sql)
   if (query_cache_size == 0)
     goto err_unlock;
 
+  free_invalidated_queries_internal(thd, QUERY_CACHE_SWEEP_TABLES);
+
   Query_cache_block *query_block;
   LEX_CSTRING stripped_query;
   if(opt_query_cache_strip_comments)
@@ -2086,6 +2113,22 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
     TABLE *tmptable;
     Query_cache_table *table = block_table->parent;
 
+    /*
+      The table has been changed since the query was registered, so the
+      result is stale. It is freed here rather than by the writer.
+    */
+    if (block_table->generation !=
+        my_atomic_load64(table_generation(table->data(),
+                                          table->key_length())))
+    {
+      DBUG_PRINT("qcache", ("Table %s.%s changed, freeing stale query",
+                            table->db(), table->table()));
+      BLOCK_UNLOCK_RD(query_block);
+      BLOCK_LOCK_WR(query_block);
+      free_query(query_block);
+      goto err_unlock;
+    }
+
     /*
       Check that we have not temporary tables with same names of tables
       of this query. If we have such tables, we will not send data from
@@ -2805,6 +2848,7 @@ void Query_cache::make_disabled()
   first_block= 0;
   total_blocks= 0;
   tables_blocks= 0;
+  m_sweep_cursor= NULL;
   DBUG_VOID_RETURN;
 }
 
@@ -3296,20 +3340,117 @@ void Query_cache::invalidate_table(THD *thd, uchar * key, size_t key_length)
   DEBUG_SYNC(thd, "wait_in_query_cache_invalidate1");
 
   /*
-    Lock the query cache and queue all invalidation attempts to avoid
-    the risk of a race between invalidation, cache inserts and flushes.
+    Queries registered before this point see a new generation number and
+    are never sent again. Queries registered after it are not affected,
+    as when they were inserted after an invalidation under the lock.
+    The pending flag is set after the increment, so that a sweep which
+    clears it before reading the generation numbers sees the increment.
   */
-  lock();
+  my_atomic_add64(table_generation(key, key_length), 1);
+  my_atomic_store32(&m_invalidations_pending, 1);
+}
 
-  DEBUG_SYNC(thd, "wait_in_query_cache_invalidate2");
+
+/**
+  Finish freeing the queries of the tables invalidated since the last
+  sweep, so that the statistics do not count them.
+*/
+
+void Query_cache::free_invalidated_queries()
+{
+  if (is_disabled() || my_atomic_load32(&m_invalidations_pending) == 0)
+    return;
+
+  if (try_lock())
+    return;
 
   if (query_cache_size > 0)
-    invalidate_table_internal(thd, key, key_length);
+    free_invalidated_queries_internal(current_thd, ~0UL);
 
   unlock();
 }
 
 
+/**
+  Free the cached queries registered before the last change of one of
+  their tables, checking at most max_tables tables.
+
+  A sweep starts when a generation number has been incremented and
+  visits every cached table once; it continues from m_sweep_cursor in
+  the next call. The queries of a table are linked newest first and the
+  generation numbers only grow, so the stale queries are found at the
+  end of the list and the check costs one comparison for an unchanged
+  table.
+
+  @pre the cache is locked and query_cache_size > 0.
+*/
+
+void Query_cache::free_invalidated_queries_internal(THD *thd,
+                                                    ulong max_tables)
+{
+  DBUG_ENTER("Query_cache::free_invalidated_queries_internal");
+
+  if (m_sweep_cursor == NULL)
+  {
+    if (my_atomic_load32(&m_invalidations_pending) == 0)
+      DBUG_VOID_RETURN;
+
+    my_atomic_store32(&m_invalidations_pending, 0);
+
+    DEBUG_SYNC(thd, "wait_in_query_cache_invalidate2");
+
+    m_sweep_cursor= tables_blocks;
+  }
+
+  for (ulong n= 0; m_sweep_cursor != NULL && n < max_tables; n++)
+  {
+    Query_cache_block *table_block= m_sweep_cursor;
+    Query_cache_block *next= table_block->next;
+    Query_cache_table *table= table_block->table();
+    Query_cache_block_table *list_root= table_block->table(0);
+    const int64 generation=
+      my_atomic_load64(table_generation(table->data(),
+                                        table->key_length()));
+
+    /*
+      Freeing a query frees the tables used only by it, which moves the
+      cursor back to the first table, see unlink_table().
+    */
+    m_sweep_cursor= next == tables_blocks ? NULL : next;
+
+    if (list_root->next->generation != generation)
+    {
+      /* Even the newest query is stale */
+      invalidate_query_block_list(thd, list_root);
+    }
+    else
+    {
+      /* The newest query keeps the table block in the cache */
+      while (list_root->prev->generation != generation)
+      {
+        Query_cache_block *query_block= list_root->prev->block();
+        BLOCK_LOCK_WR(query_block);
+        free_query(query_block);
+      }
+    }
+  }
+
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  @return the generation number of the table with the given key
+*/
+
+volatile int64 *Query_cache::table_generation(const uchar *key,
+                                              size_t key_length)
+{
+  const uint32 hash= murmur3_32(key, key_length, 0);
+  return &table_generations[hash & (QUERY_CACHE_TABLE_GENERATIONS - 1)];
+}
+
+
 /**
   Try to locate and invalidate a table by name.
   The caller must ensure that no other thread is trying to work with
@@ -3598,6 +3739,8 @@ Query_cache::insert_table(size_t key_len, const char *key,
   node->next->prev= node;
   node->prev= list_root;
   node->parent= table_block->table();
+  node->generation= my_atomic_load64(table_generation((const uchar *) key,
+                                                      key_len));
   /*
     Increase the counter to keep track on how long this chain
     of queries is.
@@ -3634,6 +3777,9 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
                                &tables_blocks);
     my_hash_delete(&tables,(uchar *) table_block);
     free_memory_block(table_block);
+    /* The block may have been the next one to sweep */
+    if (m_sweep_cursor != NULL)
+      m_sweep_cursor= tables_blocks;
   }
   DBUG_VOID_RETURN;
 }
@@ -4358,6 +4504,8 @@ my_bool Query_cache::move_by_type(uchar **border,
     relink(block, new_block, next, prev, pnext, pprev);
     if (tables_blocks == block)
       tables_blocks = new_block;
+    if (m_sweep_cursor == block)
+      m_sweep_cursor= new_block;
 
     Query_cache_block_table *nlist_root = new_block->table(0);
     nlist_root->n = 0;
@@ -70,6 +70,18 @@ typedef ulonglong sql_mode_t;
 
 #define TABLE_COUNTER_TYPE size_t
 
+/*
+  number of table generation numbers (power of 2), see
+  Query_cache::table_generations
+*/
+#define QUERY_CACHE_TABLE_GENERATIONS		16384
+
+/*
+  number of cached tables checked for invalidated queries per lookup or
+  store, see Query_cache::free_invalidated_queries_internal
+*/
+#define QUERY_CACHE_SWEEP_TABLES		16
+
 struct Query_cache_block;
 struct Query_cache_block_table;
 struct Query_cache_table;
@@ -113,6 +125,12 @@ struct Query_cache_block_table
   */
   Query_cache_table *parent;
 
+  /**
+    Generation number of the table when the query was registered. The
+    query is stale once the generation number has changed.
+  */
+  int64 generation;
+
   /**
     A method to calculate the address of the query cache block
     owning this node. The purpose of this calculation is to 
@@ -300,6 +318,33 @@ private:
 
   bool m_query_cache_is_disabled;
 
+  /*
+    Generation numbers of tables, indexed by a hash of the table key.
+    Invalidating a table increments its generation number without taking
+    structure_guard_mutex; the queries using the table are freed by the
+    threads that lock the cache for a lookup or a store, see
+    free_invalidated_queries_internal().
+
+    Tables whose keys hash to the same slot share a generation number,
+    so changing one of them also invalidates the cached queries of the
+    others. With the number of slots much larger than the number of
+    tables in use such false invalidations are rare, and they only cost
+    a cache miss.
+  */
+  volatile int64 table_generations[QUERY_CACHE_TABLE_GENERATIONS];
+
+  /* Set when a generation number was incremented since the last sweep */
+  volatile int32 m_invalidations_pending;
+
+  /*
+    Next table block to check for invalidated queries, or NULL if no
+    sweep is in progress. Moved back to the first table block when a
+    table block is freed.
+  */
+  Query_cache_block *m_sweep_cursor;
+
+  volatile int64 *table_generation(const uchar *key, size_t key_length);
+  void free_invalidated_queries_internal(THD *thd, ulong max_tables);
   void free_query_internal(Query_cache_block *point);
   void invalidate_table_internal(THD *thd, uchar *key, size_t key_length);
   void disable_query_cache(void) { m_query_cache_is_disabled= TRUE; }
@@ -482,6 +527,9 @@ protected:
   /* Remove all queries that uses any of the listed following table */
   void invalidate_by_MyISAM_filename(const char *filename);
 
+  /* Free the queries of tables invalidated since the last sweep */
+  void free_invalidated_queries();
+
   void flush();
   void pack(ulong join_limit = QUERY_CACHE_PACK_LIMIT,
 	    uint iteration_limit = QUERY_CACHE_PACK_ITERATION);
@@ -1968,8 +1968,8 @@ void THD::cleanup(void)
   */
   user_var_events.clear();
   close_temporary_tables(this);
-  sp_cache_clear(&sp_proc_cache);
-  sp_cache_clear(&sp_func_cache);
+  sp_cache_release(&sp_proc_cache);
+  sp_cache_release(&sp_func_cache);
 
   /*
     Actions above might generate events for the binary log, so we
@@ -485,6 +485,7 @@ typedef struct system_variables
   ulong max_length_for_sort_data;
   ulong max_points_in_geometry;
   ulong max_sort_length;
+  ulong max_sort_threads;
   ulong max_tmp_tables;
   ulong max_insert_delayed_threads;
   ulong min_examined_row_limit;
@@ -684,6 +685,9 @@ typedef struct system_status_var
   ulonglong filesort_range_count;
   ulonglong filesort_rows;
   ulonglong filesort_scan_count;
+  /* Join orders reused from, and not found in, the plan cache. */
+  ulonglong plan_cache_hits;
+  ulonglong plan_cache_misses;
   /* Prepared statements and binary protocol. */
   ulonglong com_stmt_prepare;
   ulonglong com_stmt_reprepare;
@@ -5490,6 +5494,17 @@ public:
   */
   bool can_use_pk_for_unique;
 
+  /**
+    State of end_update() for runs of rows in the same group: the group
+    key of the previous row, and the group record as stored in the table
+    before its aggregates were updated in record[1], followed by room
+    for one more record. While last_group_pending is set, the table row
+    is not up to date.
+  */
+  uchar *last_group_key;
+  uchar *last_group_record;
+  bool last_group_pending;
+
   Temp_table_param()
     :copy_field(NULL), copy_field_end(NULL),
      group_buff(NULL),
@@ -5504,7 +5519,8 @@ public:
      using_outer_summary_function(false),
      table_charset(NULL),
      schema_table(false), precomputed_group_by(false), force_copy_fields(false),
-     skip_create_table(false), bit_fields_as_long(false), can_use_pk_for_unique(true)
+     skip_create_table(false), bit_fields_as_long(false), can_use_pk_for_unique(true),
+     last_group_key(NULL), last_group_record(NULL), last_group_pending(false)
   {}
   ~Temp_table_param()
   {
@@ -32,6 +32,7 @@
 #include <mysys_err.h>
 #include "sp.h"
 #include "events.h"
+#include "histogram.h"                 // drop_database_histograms
 #include <my_dir.h>
 #include <m_ctype.h>
 #include "log.h"
@@ -889,6 +890,7 @@ bool mysql_rm_db(THD *thd,const LEX_CSTRING &db,bool if_exists, bool silent)
     tmp_disable_binlog(thd);
     query_cache.invalidate(db.str);
     (void) sp_drop_db_routines(thd, db.str); /* @todo Do not ignore errors */
+    drop_database_histograms(db.str);
 #ifndef EMBEDDED_LIBRARY
     Events::drop_schema_events(thd, db.str);
 #endif
@@ -20,6 +20,7 @@
 #include "my_global.h"
 #include "my_sys.h"
 #include "my_md5.h"
+#include "my_murmur3.h"
 #include "sql_lex.h"
 #include "sql_signal.h"
 #include "sql_get_diagnostics.h"
@@ -47,6 +48,8 @@ ulong get_max_digest_length()
   return max_digest_length;
 }
 
+ulong digest_hash_algorithm= DIGEST_HASH_MD5;
+
 /**
   Read a single token from token array.
 */
@@ -159,9 +162,16 @@ inline void store_token_identifier(sql_digest_storage* digest_storage,
   }
 }
 
-void compute_digest_md5(const sql_digest_storage *digest_storage, unsigned char *md5)
+void compute_digest_hash(const sql_digest_storage *digest_storage, unsigned char *hash)
 {
-  compute_md5_hash((char *) md5,
+  if (digest_hash_algorithm == DIGEST_HASH_MURMUR3)
+  {
+    compile_time_assert(MURMUR3_128_HASH_SIZE == MD5_HASH_SIZE);
+    murmur3_x64_128(digest_storage->m_token_array,
+                    digest_storage->m_byte_count, 0, hash);
+    return;
+  }
+  compute_md5_hash((char *) hash,
                    (const char *) digest_storage->m_token_array,
                    digest_storage->m_byte_count);
 }
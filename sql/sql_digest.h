@@ -24,6 +24,23 @@
 
 ulong get_max_digest_length();
 
+/** Hash functions for statement digests */
+enum enum_digest_hash_algorithm
+{
+  /** MD5, as in earlier versions */
+  DIGEST_HASH_MD5,
+  /** MurmurHash3 x64 128-bit, a faster non-cryptographic hash */
+  DIGEST_HASH_MURMUR3
+};
+
+/**
+  Hash function used for statement digests, one of
+  enum_digest_hash_algorithm. Both produce MD5_HASH_SIZE bytes.
+  Only set at startup, as digests computed with different hash
+  functions never match.
+*/
+extern ulong digest_hash_algorithm;
+
 /**
   Structure to store token count/array for a statement
   on which digest is to be calculated.
@@ -105,11 +122,11 @@ struct sql_digest_storage
 typedef struct sql_digest_storage sql_digest_storage;
 
 /**
-  Compute a digest hash.
+  Compute a digest hash, using the hash function in @c digest_hash_algorithm.
   @param digest_storage The digest
-  @param [out] md5 The computed digest hash. This parameter is a buffer of size @c MD5_HASH_SIZE.
+  @param [out] hash The computed digest hash. This parameter is a buffer of size @c MD5_HASH_SIZE.
 */
-void compute_digest_md5(const sql_digest_storage *digest_storage, unsigned char *md5);
+void compute_digest_hash(const sql_digest_storage *digest_storage, unsigned char *hash);
 
 /**
   Compute a digest text.
@@ -2446,6 +2446,30 @@ int read_first_record_seq(QEP_TAB *tab)
 }
 
 
+/**
+  Let a table scan of a SELECT read rows from the handler in batches.
+
+  Batches are only used when nothing needs the handler position of the
+  current row, and rows are not locked. Stored routines are excluded,
+  as they could change rows that were already read ahead.
+*/
+
+static void init_read_batch(QEP_TAB *tab)
+{
+  THD *const thd= tab->join()->thd;
+  const thr_lock_type lock_type= tab->table()->reginfo.lock_type;
+
+  if (tab->keep_current_rowid ||
+      thd->lex->sql_command != SQLCOM_SELECT ||
+      thd->lex->uses_stored_routines() ||
+      lock_type == TL_READ_WITH_SHARED_LOCKS ||
+      lock_type >= TL_WRITE_ALLOW_WRITE)
+    return;
+
+  (void) init_read_record_batch(&tab->read_record, &tab->read_batch);
+}
+
+
 /**
   @brief Prepare table for reading rows and read first record.
   @details
@@ -2483,6 +2507,7 @@ int join_init_read_record(QEP_TAB *tab)
   if (init_read_record(&tab->read_record, tab->join()->thd, NULL, tab,
                        1, 1, FALSE))
     return 1;
+  init_read_batch(tab);
 
   return (*tab->read_record.read_record)(&tab->read_record);
 }
@@ -3408,8 +3433,46 @@ end:
 }
 
 
+/**
+  Write the group record kept in record[1] by end_update() to the table.
+
+  ha_update_row() takes the new row in record[0] and the stored row in
+  record[1], so the rows are moved there for the call, and record[0] is
+  restored afterwards.
+
+  @return 0 or handler error code
+*/
+
+static int write_last_group(TABLE *table, Temp_table_param *tmp_tbl)
+{
+  if (!tmp_tbl->last_group_pending)
+    return 0;
+  tmp_tbl->last_group_pending= false;
+
+  const size_t reclength= table->s->reclength;
+  uchar *const saved_record= tmp_tbl->last_group_record + reclength;
+  memcpy(saved_record, table->record[0], reclength);
+  restore_record(table, record[1]);
+  memcpy(table->record[1], tmp_tbl->last_group_record, reclength);
+  const int error= table->file->ha_update_row(table->record[1],
+                                              table->record[0]);
+  memcpy(table->record[0], saved_record, reclength);
+  // Old and new records are the same, ok to ignore
+  return error == HA_ERR_RECORD_IS_THE_SAME ? 0 : error;
+}
+
+
 /* ARGSUSED */
-/** Group by searching after group record and updating it if possible. */
+/**
+  Group by searching after group record and updating it if possible.
+
+  Rows of the same group often arrive one after another. The first row
+  of such a run still looks the group up in the table; the group record
+  is then kept in record[1] while the aggregates of the following rows
+  of the run are added to it, and written back once when a row of
+  another group arrives, or at the end. This saves one index lookup and
+  one row update for every row of a run but the first.
+*/
 
 static enum_nested_loop_state
 end_update(JOIN *join, QEP_TAB *const qep_tab, bool end_of_records)
@@ -3420,15 +3483,22 @@ end_update(JOIN *join, QEP_TAB *const qep_tab, bool end_of_records)
   bool group_found= false;
   DBUG_ENTER("end_update");
 
+  Temp_table_param *const tmp_tbl= qep_tab->tmp_table_param;
   if (end_of_records)
+  {
+    if ((error= write_last_group(table, tmp_tbl)))
+    {
+      table->file->print_error(error, MYF(0));   /* purecov: inspected */
+      DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
+    }
     DBUG_RETURN(NESTED_LOOP_OK);
+  }
   if (join->thd->killed)			// Aborted by user
   {
     join->thd->send_kill_message();
     DBUG_RETURN(NESTED_LOOP_KILLED);             /* purecov: inspected */
   }
 
-  Temp_table_param *const tmp_tbl= qep_tab->tmp_table_param;
   join->found_records++;
   if (copy_fields(tmp_tbl, join->thd))	// Groups are copied twice.
     DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
@@ -3459,11 +3529,48 @@ end_update(JOIN *join, QEP_TAB *const qep_tab, bool end_of_records)
         group->buff[-1]= (char) group->field->is_null();
     }
     const uchar *key= tmp_tbl->group_buff;
+    if (tmp_tbl->last_group_pending &&
+        !memcmp(key, tmp_tbl->last_group_key, tmp_tbl->group_length))
+    {
+      /* Same group as the previous row, its record is in record[1] */
+      restore_record(table, record[1]);
+      update_tmptable_sum_func(join->sum_funcs, table);
+      store_record(table, record[1]);
+      DBUG_RETURN(NESTED_LOOP_OK);
+    }
+    if ((error= write_last_group(table, tmp_tbl)))
+    {
+      table->file->print_error(error, MYF(0));   /* purecov: inspected */
+      DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
+    }
     if (!table->file->ha_index_read_map(table->record[1],
                                         key,
                                         HA_WHOLE_KEY,
                                         HA_READ_KEY_EXACT))
       group_found= true;
+    /*
+      BLOB values in record[1] may point to buffers that the next row
+      overwrites, so such groups are written back at once.
+    */
+    if (group_found && table->s->blob_fields == 0)
+    {
+      if (tmp_tbl->last_group_record == NULL &&
+          !(tmp_tbl->last_group_record=
+              (uchar*) join->thd->alloc(2 * table->s->reclength)))
+        DBUG_RETURN(NESTED_LOOP_ERROR);         /* purecov: inspected */
+      if (tmp_tbl->last_group_key == NULL &&
+          !(tmp_tbl->last_group_key=
+              (uchar*) join->thd->alloc(tmp_tbl->group_length)))
+        DBUG_RETURN(NESTED_LOOP_ERROR);         /* purecov: inspected */
+      memcpy(tmp_tbl->last_group_record, table->record[1],
+             table->s->reclength);
+      memcpy(tmp_tbl->last_group_key, key, tmp_tbl->group_length);
+      restore_record(table, record[1]);
+      update_tmptable_sum_func(join->sum_funcs, table);
+      store_record(table, record[1]);
+      tmp_tbl->last_group_pending= true;
+      DBUG_RETURN(NESTED_LOOP_OK);
+    }
   }
   if (group_found)
   {
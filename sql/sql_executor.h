@@ -360,6 +360,7 @@ public:
     used_uneven_bit_fields(false),
     keep_current_rowid(false),
     copy_current_rowid(NULL),
+    read_batch(NULL),
     distinct(false),
     not_used_in_distinct(false),
     cache_idx_cond(NULL),
@@ -573,6 +574,9 @@ public:
   bool keep_current_rowid;
   st_cache_field *copy_current_rowid;
 
+  /** Buffer of table scans that read rows in batches, see init_read_batch() */
+  uchar *read_batch;
+
   /** TRUE <=> remove duplicates on this table. */
   bool distinct;
 
@@ -47,11 +47,13 @@
 %token BNL_HINT
 %token DUPSWEEDOUT_HINT
 %token FIRSTMATCH_HINT
+%token HASH_JOIN_HINT
 %token INTOEXISTS_HINT
 %token LOOSESCAN_HINT
 %token MATERIALIZATION_HINT
 %token NO_BKA_HINT
 %token NO_BNL_HINT
+%token NO_HASH_JOIN_HINT
 %token NO_ICP_HINT
 %token NO_MRR_HINT
 %token NO_RANGE_OPTIMIZATION_HINT
@@ -366,6 +368,10 @@ table_level_hint_type_on:
           {
             $$= BNL_HINT_ENUM;
           }
+        | HASH_JOIN_HINT
+          {
+            $$= HASH_JOIN_HINT_ENUM;
+          }
         ;
 
 table_level_hint_type_off:
@@ -377,6 +383,10 @@ table_level_hint_type_off:
           {
             $$= BNL_HINT_ENUM;
           }
+        | NO_HASH_JOIN_HINT
+          {
+            $$= HASH_JOIN_HINT_ENUM;
+          }
         ;
 
 key_level_hint_type_on:
@@ -2122,6 +2122,400 @@ enum_nested_loop_state JOIN_CACHE_BNL::join_matching_records(bool skip_last)
 }
 
 
+/**
+  Check whether an operand of an equality can be part of a hash join key.
+
+  Only columns are accepted, and only of types for which values that are
+  equal under the comparison of the equality are guaranteed to have equal
+  hashes: integer columns, compared as integers, and character columns,
+  compared with the collation of the column.
+
+  @param item       operand of the equality
+  @param collation  collation the equality compares strings with
+
+  @return INT_RESULT or STRING_RESULT if the operand can be hashed as
+          such, ROW_RESULT otherwise
+*/
+
+static Item_result hash_key_part_type(Item *item, const CHARSET_INFO *collation)
+{
+  Item *real= item->real_item();
+  if (real->type() != Item::FIELD_ITEM)
+    return ROW_RESULT;
+
+  Field *field= static_cast<Item_field *>(real)->field;
+  switch (field->type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    return INT_RESULT;
+  case MYSQL_TYPE_VARCHAR:
+  case MYSQL_TYPE_VAR_STRING:
+  case MYSQL_TYPE_STRING:
+  case MYSQL_TYPE_BLOB:
+    if (field->charset() != collation)
+      return ROW_RESULT;
+    return STRING_RESULT;
+  default:
+    return ROW_RESULT;
+  }
+}
+
+
+/**
+  Collect the top level conjuncts of a condition attached to a table.
+
+  The join condition of an outer join is attached to its first inner table
+  under a guard that turns it off for the NULL-complemented row. Such a
+  guard is looked through, as matches for the first inner table are only
+  searched for while the guard is on. Guards of any other kind, or of
+  other tables, are kept as they are.
+
+  @param cond        condition attached to the table
+  @param idx         position of the table in the join order
+  @param conjuncts   list to append the conjuncts to
+*/
+
+static void collect_conjuncts(Item *cond, plan_idx idx, List<Item> *conjuncts)
+{
+  if (cond->type() == Item::COND_ITEM &&
+      static_cast<Item_cond *>(cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List_iterator<Item> it(*static_cast<Item_cond *>(cond)->argument_list());
+    Item *item;
+    while ((item= it++))
+      collect_conjuncts(item, idx, conjuncts);
+    return;
+  }
+  if (cond->type() == Item::FUNC_ITEM &&
+      static_cast<Item_func *>(cond)->functype() == Item_func::TRIG_COND_FUNC)
+  {
+    Item_func_trig_cond *trig= static_cast<Item_func_trig_cond *>(cond);
+    if (trig->get_trig_type() == Item_func_trig_cond::IS_NOT_NULL_COMPL &&
+        trig->idx() == idx)
+    {
+      collect_conjuncts(trig->arguments()[0], idx, conjuncts);
+      return;
+    }
+  }
+  conjuncts->push_back(cond);
+}
+
+
+/**
+  Collect the equalities a hash join key can be built from.
+
+  The equalities are looked for among the top level conjuncts of the
+  condition pushed down to the joined table, see collect_conjuncts().
+  An equality qualifies if one operand refers only to the joined table
+  and the other one only to the tables whose records are stored in the
+  join buffer.
+
+  @param cond            condition attached to the joined table
+  @param inner_idx       position of the joined table in the join order
+  @param inner_map       map of the joined table
+  @param outer_map       map of the tables stored in the join buffer
+  @param[out] outer_args operands referring to the buffered tables
+  @param[out] inner_args operands referring to the joined table
+  @param[out] key_collations  collation to hash each string part with,
+                         NULL for integer parts
+
+  @return number of collected key parts, at most MAX_REF_PARTS
+*/
+
+uint JOIN_CACHE_HASH::collect_key_parts(Item *cond, plan_idx inner_idx,
+                                        table_map inner_map,
+                                        table_map outer_map,
+                                        Item **outer_args, Item **inner_args,
+                                        const CHARSET_INFO **key_collations)
+{
+  uint parts= 0;
+  if (cond == NULL)
+    return 0;
+
+  List<Item> conjuncts;
+  collect_conjuncts(cond, inner_idx, &conjuncts);
+
+  List_iterator<Item> it(conjuncts);
+  Item *item;
+  while ((item= it++) && parts < MAX_REF_PARTS)
+  {
+    if (item->type() != Item::FUNC_ITEM ||
+        static_cast<Item_func *>(item)->functype() != Item_func::EQ_FUNC)
+      continue;
+
+    Item_func_eq *eq= static_cast<Item_func_eq *>(item);
+    Item **args= eq->arguments();
+    const table_map used0= args[0]->used_tables();
+    const table_map used1= args[1]->used_tables();
+    uint inner_idx;
+    if (used0 == inner_map && used1 && !(used1 & ~outer_map))
+      inner_idx= 0;
+    else if (used1 == inner_map && used0 && !(used0 & ~outer_map))
+      inner_idx= 1;
+    else
+      continue;
+
+    const CHARSET_INFO *collation= eq->compare_collation();
+    const Item_result type= hash_key_part_type(args[0], collation);
+    if (type == ROW_RESULT ||
+        type != hash_key_part_type(args[1], collation))
+      continue;
+
+    inner_args[parts]= args[inner_idx];
+    outer_args[parts]= args[1 - inner_idx];
+    key_collations[parts]= type == STRING_RESULT ? collation : NULL;
+    parts++;
+  }
+  return parts;
+}
+
+
+/*
+  Initialize a hash join cache
+
+  The equalities the hash key is built from are collected before the
+  buffer is sized, as the hash table takes its space from the buffer.
+  If no equality qualifies, the cache works exactly as a BNL cache.
+  Reference JOIN_CACHE_BNL::init() for the rest.
+*/
+
+int JOIN_CACHE_HASH::init()
+{
+  DBUG_ENTER("JOIN_CACHE_HASH::init");
+
+  JOIN_CACHE *first_cache= this;
+  while (first_cache->prev_cache)
+    first_cache= first_cache->prev_cache;
+  QEP_TAB *const first_qep_tab= first_cache->qep_tab;
+  QEP_TAB *tab=
+    sj_is_materialize_strategy(first_qep_tab->get_sj_strategy()) ?
+    &QEP_AT(first_qep_tab, first_sj_inner()) :
+    &join->qep_tab[join->const_tables];
+
+  table_map outer_map= 0;
+  for ( ; tab < qep_tab; tab++)
+    outer_map|= tab->table_ref->map();
+
+  key_parts= collect_key_parts(qep_tab->condition(), qep_tab->idx(),
+                               qep_tab->table_ref->map(), outer_map,
+                               outer_args, inner_args, key_collations);
+
+  DBUG_RETURN(JOIN_CACHE_BNL::init());
+}
+
+
+/**
+  Calculate the hash of a join key from the current record buffers.
+
+  @param      args  operands to build the key from
+  @param[out] hash  hash value of the key
+
+  @return true if a key part is NULL, so that the key cannot match
+*/
+
+bool JOIN_CACHE_HASH::calc_hash(Item **args, ulong *hash)
+{
+  ulong nr1= 1, nr2= 4;
+  for (uint i= 0; i < key_parts; i++)
+  {
+    if (key_collations[i] == NULL)
+    {
+      uchar buff[8];
+      const longlong value= args[i]->val_int();
+      if (args[i]->null_value)
+        return true;
+      int8store(buff, value);
+      my_charset_bin.coll->hash_sort(&my_charset_bin, buff, sizeof(buff),
+                                     &nr1, &nr2);
+    }
+    else
+    {
+      StringBuffer<STRING_BUFFER_USUAL_SIZE> buff(key_collations[i]);
+      const String *value= args[i]->val_str(&buff);
+      if (value == NULL || args[i]->null_value)
+        return true;
+      key_collations[i]->coll->hash_sort(key_collations[i],
+                                         pointer_cast<const uchar *>(
+                                           value->ptr()),
+                                         value->length(), &nr1, &nr2);
+    }
+  }
+  *hash= nr1;
+  return false;
+}
+
+
+/**
+  Build the hash table over the records of the join buffer.
+
+  The entries and the bucket array are placed in the auxiliary part of the
+  buffer, right after the last record. Records with a NULL key part are
+  left out as they cannot match any row.
+
+  @param      count      number of records from the start of the buffer
+                         to put into the hash table
+  @param[out] n_buckets  number of buckets
+
+  @return the bucket array, or NULL if the auxiliary part of the buffer is
+          too small (possible for the last record of a full buffer), in
+          which case the caller falls back to scanning the buffer
+*/
+
+JOIN_CACHE_HASH::Hash_entry **
+JOIN_CACHE_HASH::build_hash_table(uint count, uint *n_buckets)
+{
+  uchar *const start= buff + ALIGN_SIZE(end_pos - buff);
+  *n_buckets= max(count, 1U);
+  if (start + count * sizeof(Hash_entry) +
+      *n_buckets * sizeof(Hash_entry *) > buff + buff_size)
+    return NULL;
+
+  Hash_entry *const entries= reinterpret_cast<Hash_entry *>(start);
+  Hash_entry **const buckets=
+    reinterpret_cast<Hash_entry **>(entries + count);
+  uint n_entries= 0;
+
+  reset_cache(false);
+  for (uint cnt= count; cnt; cnt--)
+  {
+    get_record();
+    Hash_entry *entry= &entries[n_entries];
+    if (calc_hash(outer_args, &entry->hash))
+      continue;
+    entry->rec_ptr= get_curr_rec();
+    n_entries++;
+  }
+
+  /* Chain the entries backwards so that each chain is in buffer order */
+  memset(buckets, 0, *n_buckets * sizeof(Hash_entry *));
+  while (n_entries)
+  {
+    Hash_entry *entry= &entries[--n_entries];
+    Hash_entry **bucket= &buckets[entry->hash % *n_buckets];
+    entry->next= *bucket;
+    *bucket= entry;
+  }
+  return buckets;
+}
+
+
+/*
+  Using a hash table find matches from the next table for records from the
+  join buffer
+
+  SYNOPSIS
+    join_matching_records()
+      skip_last    do not look for matches for the last partial join record
+
+  DESCRIPTION
+    The function follows JOIN_CACHE_BNL::join_matching_records(), but
+    instead of reading every record of the join buffer for each row of the
+    joined table it reads only the records whose key hashes to the same
+    value as the key of the row. The hash table is built when the first
+    row of the joined table has been read.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_HASH::join_matching_records(bool skip_last)
+{
+  int error;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+
+  if (!key_parts)
+    return JOIN_CACHE_BNL::join_matching_records(skip_last);
+
+  qep_tab->table()->reset_null_row();
+
+  /* Return at once if there are no records in the join buffer */
+  if (!records)
+    return NESTED_LOOP_OK;
+
+  if (skip_last)
+    put_record_in_cache();
+
+  DBUG_ASSERT(!(qep_tab->dynamic_range() && qep_tab->quick()));
+
+  /* Start retrieving all records of the joined table */
+  if ((error= (*qep_tab->read_first_record)(qep_tab)))
+    return error < 0 ? NESTED_LOOP_OK : NESTED_LOOP_ERROR;
+
+  const uint count= records - MY_TEST(skip_last);
+  uint n_buckets;
+  Hash_entry **const buckets= build_hash_table(count, &n_buckets);
+  if (join->thd->is_error())
+    return NESTED_LOOP_ERROR;
+
+  READ_RECORD *info= &qep_tab->read_record;
+  do
+  {
+    if (qep_tab->keep_current_rowid)
+      qep_tab->table()->file->position(qep_tab->table()->record[0]);
+
+    if (join->thd->killed)
+    {
+      /* The user has aborted the execution of the query */
+      join->thd->send_kill_message();
+      return NESTED_LOOP_KILLED;
+    }
+
+    join->examined_rows++;
+    if (const_cond)
+    {
+      const bool consider_record= const_cond->val_int() != FALSE;
+      if (join->thd->is_error())                // error in condition evaluation
+        return NESTED_LOOP_ERROR;
+      if (!consider_record)
+        continue;
+    }
+
+    if (buckets == NULL)
+    {
+      /* No room for the hash table: compare with every buffered record */
+      reset_cache(false);
+      for (uint cnt= count; cnt; cnt--)
+      {
+        if (!check_only_first_match || !skip_record_if_match())
+        {
+          get_record();
+          rc= generate_full_extensions(get_curr_rec());
+          if (rc != NESTED_LOOP_OK)
+            return rc;
+        }
+      }
+      continue;
+    }
+
+    ulong hash;
+    const bool null_key= calc_hash(inner_args, &hash);
+    if (join->thd->is_error())
+      return NESTED_LOOP_ERROR;
+    if (null_key)
+      continue;                           // No buffered record can match
+
+    for (Hash_entry *entry= buckets[hash % n_buckets]; entry;
+         entry= entry->next)
+    {
+      if (entry->hash != hash ||
+          (check_only_first_match && get_match_flag_by_pos(entry->rec_ptr)))
+        continue;
+      get_record_by_pos(entry->rec_ptr);
+      rc= generate_full_extensions(entry->rec_ptr);
+      if (rc != NESTED_LOOP_OK)
+        return rc;
+    }
+  } while (!(error= info->read_record(info)));
+
+  if (error > 0)                                // Fatal error
+    rc= NESTED_LOOP_ERROR;
+  return rc;
+}
+
+
 bool JOIN_CACHE::calc_check_only_first_match(const QEP_TAB *t) const
 {
   if ((t->last_sj_inner() == t->idx() &&
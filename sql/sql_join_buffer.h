@@ -490,7 +490,7 @@ public:
 
   /** Bits describing cache's type @sa setup_join_buffering() */
   enum enum_join_cache_type
-  {ALG_NONE= 0, ALG_BNL= 1, ALG_BKA= 2, ALG_BKA_UNIQUE= 4};
+  {ALG_NONE= 0, ALG_BNL= 1, ALG_BKA= 2, ALG_BKA_UNIQUE= 4, ALG_HASH= 8};
 
   virtual enum_join_cache_type cache_type() const= 0;
 
@@ -499,6 +499,7 @@ public:
   { return cache_type() & (ALG_BKA | ALG_BKA_UNIQUE ); }
 
   friend class JOIN_CACHE_BNL;
+  friend class JOIN_CACHE_HASH;
   friend class JOIN_CACHE_BKA;
   friend class JOIN_CACHE_BKA_UNIQUE;
 };
@@ -521,10 +522,83 @@ public:
 
   enum_join_cache_type cache_type() const { return ALG_BNL; }
 
-private:
+protected:
   Item *const_cond;
 };
 
+
+/*
+  JOIN_CACHE_HASH is a variant of the BNL cache for equi-joins. Once the
+  join buffer is full, a hash table is built over the buffered records,
+  keyed by the values of the outer operands of the equalities that join
+  the buffered tables with the next table. Each row of the next table is
+  then checked only against the buffered records in its hash chain rather
+  than against every record in the buffer.
+  The hash table is placed in the auxiliary part of the join buffer, so a
+  buffer holds fewer records than a BNL buffer of the same size; a full
+  buffer is joined and refilled exactly as BNL does. Hash chains keep the
+  order of the buffer, so rows are produced in the same order as BNL.
+  The equalities remain part of the pushed down condition: a collision
+  costs an extra condition evaluation, never a wrong result.
+*/
+
+class JOIN_CACHE_HASH :public JOIN_CACHE_BNL
+{
+private:
+
+  /* Entry of the hash table built over the records of the join buffer */
+  struct Hash_entry
+  {
+    uchar *rec_ptr;             /**< position of the record in the buffer */
+    Hash_entry *next;           /**< next record in the same bucket */
+    ulong hash;                 /**< hash value of the record key */
+  };
+
+  /* Number of equalities the hash key is built from */
+  uint key_parts;
+  /* Operands of the equalities that refer to the buffered tables */
+  Item *outer_args[MAX_REF_PARTS];
+  /* Operands of the equalities that refer to the joined table */
+  Item *inner_args[MAX_REF_PARTS];
+  /* Collation to hash a string key part with, NULL for integer parts */
+  const CHARSET_INFO *key_collations[MAX_REF_PARTS];
+
+  /* Calculate the hash of a key from the current record buffers */
+  bool calc_hash(Item **args, ulong *hash);
+
+  /* Build the hash table over the first 'count' records in the buffer */
+  Hash_entry **build_hash_table(uint count, uint *n_buckets);
+
+protected:
+
+  uint aux_buffer_incr()
+  { return key_parts ? sizeof(Hash_entry) + sizeof(Hash_entry *) : 0; }
+
+  uint aux_buffer_min_size() const
+  { return key_parts ? ALIGN_SIZE(1) : 0; }
+
+  /* Find matches from the next table probing the hash table */
+  enum_nested_loop_state join_matching_records(bool skip_last);
+
+public:
+  JOIN_CACHE_HASH(JOIN *j, QEP_TAB *qep_tab_arg, JOIN_CACHE *prev)
+    : JOIN_CACHE_BNL(j, qep_tab_arg, prev), key_parts(0)
+  {}
+
+  /* Initialize the hash join cache */
+  int init();
+
+  /* Without a usable equality the cache works as a BNL cache */
+  enum_join_cache_type cache_type() const
+  { return key_parts ? ALG_HASH : ALG_BNL; }
+
+  static uint collect_key_parts(Item *cond, plan_idx inner_idx,
+                                table_map inner_map,
+                                table_map outer_map,
+                                Item **outer_args, Item **inner_args,
+                                const CHARSET_INFO **key_collations);
+};
+
 class JOIN_CACHE_BKA :public JOIN_CACHE
 {
 protected:
@@ -2285,6 +2285,7 @@ st_select_lex::st_select_lex
   select_list_tables(0),
   outer_join(0),
   opt_hints_qb(NULL),
+  join_plan_cache(NULL),
   m_agg_func_used(false),
   m_json_agg_func_used(false),
   sj_candidates(NULL),
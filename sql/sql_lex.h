@@ -76,6 +76,7 @@ typedef class st_select_lex SELECT_LEX;
 const size_t INITIAL_LEX_PLUGIN_LIST_SIZE = 16;
 class Opt_hints_global;
 class Opt_hints_qb;
+class Join_plan_cache;
 
 #ifdef MYSQL_SERVER
 /*
@@ -1098,6 +1099,13 @@ public:
   /// Query-block-level hints, for this query block
   Opt_hints_qb *opt_hints_qb;
 
+  /**
+    Join order chosen by an earlier execution of this query block, if it
+    belongs to a prepared statement or a stored routine. Allocated on the
+    statement's persistent MEM_ROOT. @see Optimize_table_order
+  */
+  Join_plan_cache *join_plan_cache;
+
 
   /**
     @note the group_by and order_by lists below will probably be added to the
@@ -1665,6 +1673,12 @@ union YYSTYPE {
     enum enum_trigger_order_type ordering_clause;
     LEX_STRING anchor_trigger_name;
   } trg_characteristics;
+  struct
+  {
+    int command;
+    List<String> *columns;
+    ulong num_buckets;
+  } histogram;
   class Index_hint *key_usage_element;
   List<Index_hint> *key_usage_list;
   class PT_subselect *subselect;
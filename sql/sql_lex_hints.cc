@@ -140,6 +140,7 @@ void Hint_scanner::add_hint_token_digest()
       case BNL_HINT:
       case DUPSWEEDOUT_HINT:
       case FIRSTMATCH_HINT:
+      case HASH_JOIN_HINT:
       case INTOEXISTS_HINT:
       case LOOSESCAN_HINT:
       case MATERIALIZATION_HINT:
@@ -147,6 +148,7 @@ void Hint_scanner::add_hint_token_digest()
       case MRR_HINT:
       case NO_BKA_HINT:
       case NO_BNL_HINT:
+      case NO_HASH_JOIN_HINT:
       case NO_ICP_HINT:
       case NO_MRR_HINT:
       case NO_RANGE_OPTIMIZATION_HINT:
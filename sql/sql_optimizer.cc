@@ -3101,6 +3101,9 @@ static bool setup_join_buffering(JOIN_TAB *tab, JOIN *join, uint no_jbuf_after)
                                       BNL_HINT_ENUM, OPTIMIZER_SWITCH_BNL);
   const bool bka_on= hint_table_state(join->thd, tab->table_ref->table,
                                       BKA_HINT_ENUM, OPTIMIZER_SWITCH_BKA);
+  const bool hash_on= hint_table_state(join->thd, tab->table_ref->table,
+                                       HASH_JOIN_HINT_ENUM,
+                                       OPTIMIZER_SWITCH_HASH_JOIN);
 
   const uint tableno= tab->idx();
   const uint tab_sj_strategy= tab->get_sj_strategy();
@@ -3223,6 +3226,34 @@ static bool setup_join_buffering(JOIN_TAB *tab, JOIN *join, uint no_jbuf_after)
       goto no_join_cache;
     }
 
+    if (hash_on)
+    {
+      /*
+        Probing a hash table never evaluates the join condition more
+        often than scanning the buffer, so use it instead of BNL whenever
+        the condition has an equality the key can be built from. The
+        equalities are looked for with the tables JOIN_CACHE_HASH::init()
+        finds in the buffer: from the first inner table of a materialized
+        semi-join nest, or from the first non-const table, up to this one.
+      */
+      Item *outer_args[MAX_REF_PARTS], *inner_args[MAX_REF_PARTS];
+      const CHARSET_INFO *key_collations[MAX_REF_PARTS];
+      const uint first_buffered=
+        sj_is_materialize_strategy(tab_sj_strategy) ?
+        tab->first_sj_inner() : join->const_tables;
+      table_map outer_map= 0;
+      for (uint i= first_buffered; i < tableno; i++)
+        outer_map|= join->best_ref[i]->table_ref->map();
+      if (JOIN_CACHE_HASH::collect_key_parts(tab->condition(), tableno,
+                                             tab->table_ref->map(),
+                                             outer_map, outer_args,
+                                             inner_args, key_collations))
+      {
+        tab->set_use_join_cache(JOIN_CACHE::ALG_HASH);
+        return false;
+      }
+    }
+
     tab->set_use_join_cache(JOIN_CACHE::ALG_BNL);
     return false;
   case JT_SYSTEM:
@@ -8010,6 +8041,12 @@ static void trace_indexes_added_group_distinct(Opt_trace_context *trace,
   join_tab->keys. This allows later on such queries to be processed by
   a QUICK_GROUP_MIN_MAX_SELECT.
 
+  Otherwise, if the skip_scan optimizer switch is on, find all indexes
+  that contain all fields of the WHERE condition, and add them as well.
+  A condition that does not refer to the first key part of an index
+  makes no key usable for ranges, but the range optimizer can then
+  consider a QUICK_SKIP_SCAN_SELECT for these indexes.
+
   Note that indexes that are not usable for resolving GROUP
   BY/DISTINCT may also be added in some corner cases. For example, an
   index covering 'a' and 'b' is not usable for the following query but
@@ -8066,6 +8103,14 @@ add_group_and_distinct_keys(JOIN *join, JOIN_TAB *join_tab)
     join->sort_and_group= 1;
     cause= "indexed_distinct_aggregate";
   }
+  else if (join->where_cond &&
+           join->thd->optimizer_switch_flag(OPTIMIZER_SWITCH_SKIP_SCAN))
+  { /* Collect all query fields referenced in the WHERE clause. */
+    join->where_cond->walk(&Item::collect_item_field_processor,
+                           Item::WALK_POSTFIX,
+                           (uchar*) &indexed_fields);
+    cause= "skip_scan";
+  }
   else
     return;
 
@@ -7434,7 +7434,7 @@ extern int MYSQLparse(class THD *thd); // from sql_yacc.cc
       bool truncated;
       const sql_digest_storage *digest= & thd->m_digest->m_digest_storage;
 
-      compute_digest_md5(digest, & md5[0]);
+      compute_digest_hash(digest, & md5[0]);
       compute_digest_text(digest, & digest_text[0], sizeof(digest_text), & truncated);
     }
   @endverbatim
@@ -153,6 +153,7 @@ public:
     }
     return false;
   }
+  ulong get_id() const { return m_id; }
 private:
   ulong m_id;
   bool  m_daemon_allowed;
@@ -931,7 +931,10 @@ void Optimize_table_order::best_access_path(JOIN_TAB *tab,
     Cannot use join buffering if either
      1. This is the first table in the join sequence, or
      2. Join buffering is not enabled
-        (Only Block Nested Loop is considered in this context)
+        (Only Block Nested Loop is considered in this context. Its hash
+        join variant is only built for tables that use Block Nested Loop,
+        and never evaluates the join condition more often, so the cost
+        of Block Nested Loop is used for both)
   */
   disable_jbuf= disable_jbuf ||
     idx == join->const_tables ||                                     // 1
@@ -1878,7 +1881,24 @@ bool Optimize_table_order::choose_table_order()
     join_tables= join->all_table_map & ~join->const_table_map;
   }
 
+  /*
+    A prepared statement or stored routine may reuse the join order of an
+    earlier execution, which saves the search below.
+  */
+  const bool plan_cache= !straight_join && use_plan_cache();
+  bool reuse_plan= false;
+  if (plan_cache)
+  {
+    reuse_plan= apply_cached_plan();
+    if (reuse_plan)
+      thd->status_var.plan_cache_hits++;
+    else
+      thd->status_var.plan_cache_misses++;
+  }
+
   Opt_trace_object wrapper(&join->thd->opt_trace);
+  if (reuse_plan)
+    wrapper.add("reusing_cached_join_order", true);
   Opt_trace_array
     trace_plan(&join->thd->opt_trace, "considered_execution_plans",
                Opt_trace_context::GREEDY_SEARCH);
@@ -1898,12 +1918,14 @@ bool Optimize_table_order::choose_table_order()
                            Item::WALK_POSTFIX, NULL);
   }
 
-  if (straight_join)
+  if (straight_join || reuse_plan)
     optimize_straight_join(join_tables);
   else
   {
     if (greedy_search(join_tables))
       DBUG_RETURN(true);
+    if (plan_cache && save_plan_in_cache())
+      DBUG_RETURN(true);
   }
 
   // Remaining part of this function not needed when processing semi-join nests.
@@ -2055,6 +2077,163 @@ void Optimize_table_order::optimize_straight_join(table_map join_tables)
 }
 
 
+/**
+  @return the version of a table that a cached join order depends on;
+          0 for internal temporary tables, which are created anew for
+          every execution
+*/
+
+static ulonglong plan_cache_table_version(const TABLE *table)
+{
+  return table->s->tmp_table == INTERNAL_TMP_TABLE ?
+         0 : table->s->get_table_ref_version();
+}
+
+
+/**
+  Checks whether the join order may be taken from, or saved in, the plan
+  cache of the query block.
+
+  Only complete plans of query blocks without semi-join nests are cached,
+  since their order does not involve semi-join strategies, and only for
+  statements that are executed more than once from the same LEX.
+
+  @return true if the plan cache is to be used
+*/
+
+bool Optimize_table_order::use_plan_cache() const
+{
+  return thd->optimizer_switch_flag(OPTIMIZER_SWITCH_PLAN_CACHE) &&
+         !thd->stmt_arena->is_conventional() &&
+         emb_sjm_nest == NULL && !has_sj &&
+         join->select_lex->sj_nests.is_empty() &&
+         join->allow_outer_refs &&
+         join->tables - join->const_tables > 1;
+}
+
+
+/**
+  Arranges join->best_ref in the join order cached for the query block,
+  if that order is still valid.
+
+  The cached order is valid if the same tables are const, the optimizer
+  settings are the same, no table has been changed, neither index
+  statistics nor cost constants have changed and the number of rows
+  to read from each table, which depends on the parameter values, is
+  within Join_plan_cache::ROWS_FACTOR of the number the order was chosen
+  with.
+
+  @return true if join->best_ref is in the cached order, which is then to
+          be costed with optimize_straight_join()
+*/
+
+bool Optimize_table_order::apply_cached_plan()
+{
+  const Join_plan_cache *const cache= join->select_lex->join_plan_cache;
+  if (cache == NULL || cache->table_count == 0 ||
+      cache->table_count != join->tables - join->const_tables ||
+      cache->const_table_map != join->const_table_map ||
+      cache->optimizer_switch != thd->variables.optimizer_switch ||
+      cache->search_depth != search_depth ||
+      cache->prune_level != prune_level ||
+      cache->statistics_version != ha_statistics_version())
+    return false;
+
+  JOIN_TAB **const best_ref= join->best_ref + join->const_tables;
+  const uint count= cache->table_count;
+  table_map placed_tables= join->const_table_map;
+
+  // Validate before changing the order, which is needed if not reused
+  for (uint i= 0; i < count; i++)
+  {
+    const Join_plan_cache::Table_entry *const entry= cache->tables + i;
+    JOIN_TAB *tab= NULL;
+    for (uint j= 0; j < count; j++)
+    {
+      if (best_ref[j]->table_ref->tableno() == entry->tableno)
+      {
+        tab= best_ref[j];
+        break;
+      }
+    }
+    if (tab == NULL ||
+        (tab->dependent & ~placed_tables) ||
+        plan_cache_table_version(tab->table()) != entry->version)
+      return false;
+
+    const double cached_rows= std::max<double>(entry->rows, 1.0);
+    const double rows= std::max<double>(tab->found_records, 1.0);
+    if (rows > cached_rows * Join_plan_cache::ROWS_FACTOR ||
+        cached_rows > rows * Join_plan_cache::ROWS_FACTOR)
+      return false;
+
+    placed_tables|= tab->table_ref->map();
+  }
+
+  for (uint i= 0; i < count; i++)
+  {
+    const uint tableno= cache->tables[i].tableno;
+    for (uint j= i; j < count; j++)
+    {
+      if (best_ref[j]->table_ref->tableno() == tableno)
+      {
+        std::swap(best_ref[i], best_ref[j]);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+
+/**
+  Saves the join order found in join->best_positions in the plan cache of
+  the query block, replacing any order cached before.
+
+  @return true if out of memory
+*/
+
+bool Optimize_table_order::save_plan_in_cache()
+{
+  SELECT_LEX *const select_lex= join->select_lex;
+  const uint count= join->tables - join->const_tables;
+
+  if (select_lex->join_plan_cache == NULL)
+  {
+    MEM_ROOT *const mem_root= thd->stmt_arena->mem_root;
+    Join_plan_cache *const cache=
+      new (mem_root) Join_plan_cache(join->tables);
+    if (cache == NULL ||
+        !(cache->tables= static_cast<Join_plan_cache::Table_entry *>
+          (alloc_root(mem_root,
+                      sizeof(Join_plan_cache::Table_entry) * join->tables))))
+      return true;
+    select_lex->join_plan_cache= cache;
+  }
+
+  Join_plan_cache *const cache= select_lex->join_plan_cache;
+  if (count > cache->max_tables)
+    return false;
+
+  for (uint i= 0; i < count; i++)
+  {
+    const JOIN_TAB *const tab=
+      join->best_positions[join->const_tables + i].table;
+    Join_plan_cache::Table_entry *const entry= cache->tables + i;
+    entry->tableno= tab->table_ref->tableno();
+    entry->rows= tab->found_records;
+    entry->version= plan_cache_table_version(tab->table());
+  }
+  cache->table_count= count;
+  cache->const_table_map= join->const_table_map;
+  cache->optimizer_switch= thd->variables.optimizer_switch;
+  cache->search_depth= search_depth;
+  cache->prune_level= prune_level;
+  cache->statistics_version= ha_statistics_version();
+  return false;
+}
+
+
 /**
   Check whether a semijoin materialization strategy is allowed for
   the current (semi)join table order.
@@ -25,6 +25,54 @@
 
 class Opt_trace_object;
 
+/**
+  The join order chosen for a query block of a prepared statement or a
+  stored routine. Later executions of the query block reuse the order
+  instead of searching for one again, as long as the tables, the const
+  tables, the optimizer settings and the row estimates of every table are
+  about the same as when the order was chosen. Access methods are still
+  chosen anew for the order, so changed parameter values can change them.
+
+  Lives on the persistent MEM_ROOT of the statement and is discarded with
+  it, including when the statement is reprepared after a metadata change.
+*/
+class Join_plan_cache : public Sql_alloc
+{
+public:
+  /**
+    Row estimates of a table may differ by at most this factor from those
+    the cached order was chosen with.
+  */
+  static const uint ROWS_FACTOR= 2;
+
+  struct Table_entry
+  {
+    uint tableno;         ///< TABLE_LIST::tableno() of the table
+    ha_rows rows;         ///< JOIN_TAB::found_records when cached
+    ulonglong version;    ///< TABLE_SHARE::get_table_ref_version()
+  };
+
+  explicit Join_plan_cache(uint max_tables_arg)
+    : max_tables(max_tables_arg), table_count(0), tables(NULL),
+      const_table_map(0), optimizer_switch(0), search_depth(0),
+      prune_level(0), statistics_version(0)
+  {}
+
+  /// Capacity of tables
+  const uint max_tables;
+  /// Number of non-const tables in the cached order; 0 if none cached
+  uint table_count;
+  /// The non-const tables in join order
+  Table_entry *tables;
+  table_map const_table_map;
+  ulonglong optimizer_switch;
+  uint search_depth;
+  uint prune_level;
+  /// ha_statistics_version() when the order was chosen
+  ulonglong statistics_version;
+};
+
+
 /**
   This class determines the optimal join order for tables within
   a basic query block, ie a query specification clause, possibly extended
@@ -139,6 +187,9 @@ private:
   void backout_nj_state(const table_map remaining_tables,
                         const JOIN_TAB *tab);
   void optimize_straight_join(table_map join_tables);
+  bool use_plan_cache() const;
+  bool apply_cached_plan();
+  bool save_plan_in_cache();
   bool greedy_search(table_map remaining_tables);
   bool best_extension_by_limited_search(table_map remaining_tables,
                                         uint idx,
@@ -827,6 +827,8 @@ void JOIN::reset()
         continue;
       tmp_table->file->extra(HA_EXTRA_RESET_STATE);
       tmp_table->file->ha_delete_all_rows();
+      if (qep_tab[tmp].tmp_table_param)
+        qep_tab[tmp].tmp_table_param->last_group_pending= false;
       free_io_cache(tmp_table);
       filesort_free_buffers(tmp_table,0);
     }
@@ -1720,7 +1722,8 @@ void QEP_TAB::push_index_cond(const JOIN_TAB *join_tab,
   const bool other_tbls_ok=
     !((type() == JT_ALL || type() == JT_INDEX_SCAN ||
        type() == JT_RANGE || type() ==  JT_INDEX_MERGE) &&
-      join_tab->use_join_cache() == JOIN_CACHE::ALG_BNL);
+      (join_tab->use_join_cache() == JOIN_CACHE::ALG_BNL ||
+       join_tab->use_join_cache() == JOIN_CACHE::ALG_HASH));
 
   /*
     We will only attempt to push down an index condition when the
@@ -2055,6 +2058,9 @@ void QEP_TAB::init_join_cache(JOIN_TAB *join_tab)
   case JOIN_CACHE::ALG_BNL:
     op= new JOIN_CACHE_BNL(join_, this, prev_cache);
     break;
+  case JOIN_CACHE::ALG_HASH:
+    op= new JOIN_CACHE_HASH(join_, this, prev_cache);
+    break;
   case JOIN_CACHE::ALG_BKA:
     op= new JOIN_CACHE_BKA(join_, this, join_tab->join_cache_flags, prev_cache);
     break;
@@ -310,6 +310,7 @@ public:
   bool not_killable;
   bool using_pq;
   char* tmp_buffer;
+  uint max_sort_threads;      // Max threads sorting a buffer, 0 or 1: no threads
 
   // The fields below are used only by Unique class.
   Merge_chunk_compare_context cmp_context;
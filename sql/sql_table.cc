@@ -55,6 +55,7 @@
 #include "sql_resolver.h"              // setup_order
 #include "table_cache.h"
 #include "sql_trigger.h"               // change_trigger_table_name
+#include "histogram.h"                 // drop_table_histograms
 #include <mysql/psi/mysql_table.h>
 #include "mysql.h"			// in_bootstrap & opt_noacl
 #include "partitioning/partition_handler.h" // Partition_handler
@@ -2700,6 +2701,9 @@ int mysql_rm_table_no_locks(THD *thd, TABLE_LIST *tables, bool if_exists,
         {
           non_tmp_table_deleted= TRUE;
           new_error= drop_all_triggers(thd, db, table->table_name);
+          /* DROP DATABASE removes the histograms of all tables at once. */
+          if (thd->lex->sql_command != SQLCOM_DROP_DB)
+            drop_table_histograms(db, table->table_name);
         }
         error|= new_error;
         /* Invalidate even if we failed to delete the .FRM file. */
@@ -7905,6 +7909,8 @@ static bool mysql_inplace_alter_table(THD *thd,
                                 alter_ctx->db, alter_ctx->alias, NO_FK_CHECKS);
       DBUG_RETURN(true);
     }
+    rename_table_histograms(alter_ctx->db, alter_ctx->table_name,
+                            alter_ctx->new_db, alter_ctx->new_name);
   }
 
   DBUG_RETURN(false);
@@ -9179,6 +9185,9 @@ simple_rename_or_index_change(THD *thd, TABLE_LIST *table_list,
                                 NO_FK_CHECKS);
       error= -1;
     }
+    else
+      rename_table_histograms(alter_ctx->db, alter_ctx->table_name,
+                              alter_ctx->new_db, alter_ctx->new_name);
   }
 
   if (!error)
@@ -10505,6 +10514,9 @@ bool mysql_alter_table(THD *thd, const char *new_db, const char *new_name,
                               FN_FROM_IS_TMP | NO_FK_CHECKS);
     goto err_with_mdl;
   }
+  if (alter_ctx.is_table_renamed())
+    rename_table_histograms(alter_ctx.db, alter_ctx.table_name,
+                            alter_ctx.new_db, alter_ctx.new_name);
 
   // ALTER TABLE succeeded, delete the backup of the old table.
   if (quick_rm_table(thd, old_db_type, alter_ctx.db, backup_name, FN_IS_TMP))
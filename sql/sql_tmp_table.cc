@@ -1280,6 +1280,16 @@ update_hidden:
 
   if (!use_packed_rows)
     share->db_create_options&= ~HA_OPTION_PACK_RECORD;
+  else if (share->db_type() == heap_hton)
+  {
+    /*
+      HEAP stores fixed rows at their full length. With the dynamic row
+      format it only stores the used part of long VARCHARs, in a chain of
+      chunks, so many more rows fit into memory before the table has to be
+      converted to an on-disk one.
+    */
+    share->row_type= ROW_TYPE_DYNAMIC;
+  }
 
   share->reclength= reclength;
   {
@@ -1412,7 +1422,12 @@ update_hidden:
   param->recinfo=recinfo;
   store_record(table,s->default_values);        // Make empty default record
 
-  if (thd->variables.tmp_table_size == ~ (ulonglong) 0)		// No limit
+  /*
+    Dynamic HEAP rows are shorter than reclength; the engine limits such a
+    table by its memory usage instead, see heap_prepare_hp_create_info().
+  */
+  if (thd->variables.tmp_table_size == ~ (ulonglong) 0 ||	// No limit
+      share->row_type == ROW_TYPE_DYNAMIC)
     share->max_rows= ~(ha_rows) 0;
   else
     share->max_rows= (ha_rows) (((share->db_type() == heap_hton) ?
@@ -2338,6 +2353,8 @@ static void trace_tmp_table(Opt_trace_context *trace, const TABLE *table)
     DBUG_ASSERT(table->s->db_type() == heap_hton);
     trace_tmp.add_alnum("location", "memory (heap)").
       add("row_limit_estimate", table->s->max_rows);
+    if (table->s->row_type == ROW_TYPE_DYNAMIC)
+      trace_tmp.add_alnum("record_format", "dynamic");
   }
 }
 
@@ -2519,6 +2536,8 @@ bool create_ondisk_from_heap(THD *thd, TABLE *table,
   share= *table->s;
   share.ha_share= NULL;
   new_table.s= &share;
+  // The dynamic row format is specific to HEAP.
+  share.row_type= ROW_TYPE_DEFAULT;
   switch (internal_tmp_disk_storage_engine)
   {
   case TMP_TABLE_MYISAM:
@@ -522,6 +522,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, YYLTYPE **c, ulong *yystacksize);
 %token  BOOL_SYM
 %token  BOTH                          /* SQL-2003-R */
 %token  BTREE_SYM
+%token  BUCKETS_SYM
 %token  BY                            /* SQL-2003-R */
 %token  BYTE_SYM
 %token  CACHE_SYM
@@ -695,6 +696,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, YYLTYPE **c, ulong *yystacksize);
 %token  GT_SYM                        /* OPERATOR */
 %token  HANDLER_SYM
 %token  HASH_SYM
+%token  HISTOGRAM_SYM
 %token  HAVING                        /* SQL-2003-R */
 %token  HELP_SYM
 %token  HEX_NUM
@@ -1420,6 +1422,8 @@ END_OF_INPUT
 %type <signal_item_list> opt_set_signal_information;
 
 %type <trg_characteristics> trigger_follows_precedes_clause;
+
+%type <histogram> opt_histogram
 %type <trigger_action_order_type> trigger_action_order;
 
 %type <xid> xid;
@@ -8906,17 +8910,52 @@ analyze:
             /* Will be overriden during execution. */
             YYPS->m_lock_type= TL_UNLOCK;
           }
-          table_list
+          table_list opt_histogram
           {
             THD *thd= YYTHD;
             LEX* lex= thd->lex;
             DBUG_ASSERT(!lex->m_sql_cmd);
-            lex->m_sql_cmd= new (thd->mem_root) Sql_cmd_analyze_table();
+            lex->m_sql_cmd= new (thd->mem_root)
+              Sql_cmd_analyze_table(static_cast<Sql_cmd_analyze_table::
+                                    enum_histogram_command>($6.command),
+                                    $6.columns, $6.num_buckets);
             if (lex->m_sql_cmd == NULL)
               MYSQL_YYABORT;
           }
         ;
 
+opt_histogram:
+          /* empty */
+          {
+            $$.command= Sql_cmd_analyze_table::HISTOGRAM_NONE;
+            $$.columns= NULL;
+            $$.num_buckets= 0;
+          }
+        | UPDATE_SYM HISTOGRAM_SYM ON using_list
+          {
+            $$.command= Sql_cmd_analyze_table::HISTOGRAM_UPDATE;
+            $$.columns= $4;
+            $$.num_buckets= 0;
+          }
+        | UPDATE_SYM HISTOGRAM_SYM ON using_list WITH ulong_num BUCKETS_SYM
+          {
+            if ($6 == 0)
+            {
+              my_error(ER_WRONG_ARGUMENTS, MYF(0), "WITH BUCKETS");
+              MYSQL_YYABORT;
+            }
+            $$.command= Sql_cmd_analyze_table::HISTOGRAM_UPDATE;
+            $$.columns= $4;
+            $$.num_buckets= $6;
+          }
+        | DROP HISTOGRAM_SYM ON using_list
+          {
+            $$.command= Sql_cmd_analyze_table::HISTOGRAM_DROP;
+            $$.columns= $4;
+            $$.num_buckets= 0;
+          }
+        ;
+
 binlog_base64_event:
           BINLOG_SYM TEXT_STRING_sys
           {
@@ -13616,6 +13655,7 @@ keyword_sp:
         | BOOL_SYM                 {}
         | BOOLEAN_SYM              {}
         | BTREE_SYM                {}
+        | BUCKETS_SYM              {}
         | CASCADED                 {}
         | CATALOG_NAME_SYM         {}
         | CHAIN_SYM                {}
@@ -13704,6 +13744,7 @@ keyword_sp:
         | GRANTS                   {}
         | GLOBAL_SYM               {}
         | HASH_SYM                 {}
+        | HISTOGRAM_SYM            {}
         | HOSTS_SYM                {}
         | HOUR_SYM                 {}
         | IDENTIFIED_SYM           {}
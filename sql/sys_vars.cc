@@ -53,11 +53,13 @@
 #include "rpl_slave.h"                   // SLAVE_THD_TYPE
 #include "socket_connection.h"           // MY_BIND_ALL_ADDRESSES
 #include "sp_head.h"                     // SP_PSI_STATEMENT_INFO_COUNT
+#include "sql_digest.h"                  // digest_hash_algorithm
 #include "sql_parse.h"                   // killall_non_super_threads
 #include "sql_show.h"                    // opt_ignore_db_dirs
 #include "sql_tmp_table.h"               // internal_tmp_disk_storage_engine
 #include "sql_time.h"                    // global_date_format
 #include "table_cache.h"                 // Table_cache_manager
+#include "frm_cache.h"                   // frm_cache_size
 #include "transaction.h"                 // trans_commit_stmt
 #include "rpl_write_set_handler.h"       // transaction_write_set_hashing_algorithms
 #include "rpl_group_replication.h"       // is_group_replication_running
@@ -2461,6 +2463,15 @@ static Sys_var_long Sys_max_digest_length(
        DEFAULT(1024),
        BLOCK_SIZE(1));
 
+static const char *digest_hash_algorithm_names[]= {"MD5", "MURMUR3", NullS};
+static Sys_var_enum Sys_digest_hash_algorithm(
+       "digest_hash_algorithm",
+       "Hash function for statement digests. MURMUR3 is faster than MD5 "
+       "but gives different digest values, e.g. for existing "
+       "query rewrite rules.",
+       READ_ONLY GLOBAL_VAR(digest_hash_algorithm), CMD_LINE(REQUIRED_ARG),
+       digest_hash_algorithm_names, DEFAULT(DIGEST_HASH_MD5));
+
 static bool check_max_delayed_threads(sys_var *self, THD *thd, set_var *var)
 {
   return var->type != OPT_GLOBAL &&
@@ -2629,6 +2640,15 @@ static Sys_var_ulong Sys_max_sort_length(
        SESSION_VAR(max_sort_length), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(4, 8192*1024L), DEFAULT(1024), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_max_sort_threads(
+       "max_sort_threads",
+       "The maximum number of threads a sort may use to sort the keys in "
+       "its sort buffer. 1 sorts in the session thread only. The sorts of "
+       "all sessions together use at most 64 threads besides their session "
+       "threads",
+       SESSION_VAR(max_sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, MAX_SORT_THREADS), DEFAULT(1), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_max_sp_recursion_depth(
        "max_sp_recursion_depth",
        "Maximum stored procedure recursion depth",
@@ -2954,7 +2974,7 @@ static const char *optimizer_switch_names[]=
   "materialization", "semijoin", "loosescan", "firstmatch", "duplicateweedout",
   "subquery_materialization_cost_based",
   "use_index_extensions", "condition_fanout_filter", "derived_merge",
-  "default", NullS
+  "hash_join", "skip_scan", "histograms", "plan_cache", "default", NullS
 };
 static Sys_var_flagset Sys_optimizer_switch(
        "optimizer_switch",
@@ -2965,8 +2985,9 @@ static Sys_var_flagset Sys_optimizer_switch(
        ", materialization, semijoin, loosescan, firstmatch, duplicateweedout,"
        " subquery_materialization_cost_based"
        ", block_nested_loop, batched_key_access, use_index_extensions,"
-       " condition_fanout_filter, derived_merge} and val is one of "
-       "{on, off, default}",
+       " condition_fanout_filter, derived_merge, hash_join, skip_scan,"
+       " histograms, plan_cache}"
+       " and val is one of {on, off, default}",
        SESSION_VAR(optimizer_switch), CMD_LINE(REQUIRED_ARG),
        optimizer_switch_names, DEFAULT(OPTIMIZER_SWITCH_DEFAULT),
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(NULL), ON_UPDATE(NULL));
@@ -4174,6 +4195,29 @@ static Sys_var_charptr Sys_system_time_zone(
        READ_ONLY GLOBAL_VAR(system_time_zone_ptr), NO_CMD_LINE,
        IN_FS_CHARSET, DEFAULT(system_time_zone));
 
+static bool fix_frm_cache_size(sys_var *self, THD *thd, enum_var_type type)
+{
+  frm_cache_resize();
+  return false;
+}
+
+static Sys_var_ulong Sys_frm_cache_size(
+       "frm_cache_size",
+       "The amount of memory used to cache the contents of .frm files of "
+       "tables that are not in the table definition cache. 0 disables the "
+       "cache",
+       GLOBAL_VAR(frm_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(16*1024*1024), BLOCK_SIZE(1024),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(fix_frm_cache_size));
+
+static Sys_var_uint Sys_frm_cache_prewarm_threads(
+       "frm_cache_prewarm_threads",
+       "Number of threads reading .frm files into the frm cache at "
+       "startup. 0 disables prewarming",
+       READ_ONLY GLOBAL_VAR(frm_cache_prewarm_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_table_def_size(
        "table_definition_cache",
        "The number of cached table definitions",
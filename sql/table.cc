@@ -43,6 +43,7 @@
 #include "table_cache.h"                 // table_cache_manager
 #include "table_trigger_dispatcher.h"    // Table_trigger_dispatcher
 #include "template_utils.h"              // down_cast
+#include "frm_cache.h"                   // read_frm_file
 
 #include "pfs_file_provider.h"
 #include "mysql/psi/mysql_file.h"
@@ -87,7 +88,7 @@ LEX_STRING PARSE_GCOL_KEYWORD= {C_STRING_WITH_LEN("parse_gcol_expr")};
 void open_table_error(TABLE_SHARE *share, int error, int db_errno,
                       myf errortype, int errarg);
 static int open_binary_frm(THD *thd, TABLE_SHARE *share,
-                           uchar *head, File file);
+                           const uchar *image, size_t image_length);
 static void fix_type_pointers(const char ***array, TYPELIB *point_to_type,
 			      uint types, char **names);
 static uint find_field(Field **fields, uchar *record, uint start, uint length);
@@ -99,6 +100,11 @@ static Item *create_view_field(THD *thd, TABLE_LIST *view, Item **field_ref,
 inline bool is_system_table_name(const char *name, size_t length);
 
 static ulong get_form_pos(File file, uchar *head);
+static ulong get_form_pos(const uchar *image, size_t image_length);
+static bool read_frm_bytes(const uchar *image, size_t image_length,
+                           ulong offset, uchar *to, size_t length);
+static bool read_frm_string(const uchar *image, size_t image_length,
+                            ulong offset, uchar **to, size_t length);
 
 /**************************************************************************
   Object_creation_ctx implementation.
@@ -720,9 +726,11 @@ int open_table_def(THD *thd, TABLE_SHARE *share, uint db_flags)
 {
   int error, table_type;
   bool error_given;
-  File file;
-  uchar head[64];
+  uchar *image= NULL;
+  size_t image_length;
+  const uchar *head;
   char	path[FN_REFLEN + 1];
+  const bool use_frm_cache= share->tmp_table == NO_TMP_TABLE;
   MEM_ROOT **root_ptr, *old_root;
   DBUG_ENTER("open_table_def");
   DBUG_PRINT("enter", ("table: '%s'.'%s'  path: '%s'", share->db.str,
@@ -732,8 +740,7 @@ int open_table_def(THD *thd, TABLE_SHARE *share, uint db_flags)
   error_given= 0;
 
   strxnmov(path, sizeof(path) - 1, share->normalized_path.str, reg_ext, NullS);
-  if ((file= mysql_file_open(key_file_frm,
-                             path, O_RDONLY | O_SHARE, MYF(0))) < 0)
+  if ((error= read_frm_file(path, use_frm_cache, &image, &image_length)) == 1)
   {
     /*
       We don't try to open 5.0 unencoded name, if
@@ -744,7 +751,7 @@ int open_table_def(THD *thd, TABLE_SHARE *share, uint db_flags)
         
       - non-encoded db or table name contain "#mysql50#" prefix.
         This kind of tables must have been opened only by the
-        mysql_file_open() above.
+        read_frm_file() above.
     */
     if (has_disabled_path_chars(share->table_name.str) ||
         has_disabled_path_chars(share->db.str) ||
@@ -778,8 +785,8 @@ int open_table_def(THD *thd, TABLE_SHARE *share, uint db_flags)
       so no need to check the old file name.
     */
     if (length == share->normalized_path.length ||
-        ((file= mysql_file_open(key_file_frm,
-                                path, O_RDONLY | O_SHARE, MYF(0))) < 0))
+        (error= read_frm_file(path, use_frm_cache, &image,
+                              &image_length)) == 1)
       goto err_not_open;
 
     /* Unencoded 5.0 table name found */
@@ -788,9 +795,12 @@ int open_table_def(THD *thd, TABLE_SHARE *share, uint db_flags)
     share->normalized_path.length= length;
   }
 
-  error= 4;
-  if (mysql_file_read(file, head, 64, MYF(MY_NABP)))
+  if (error || image_length < 64)
+  {
+    error= 4;
     goto err;
+  }
+  head= image;
 
   if (head[0] == (uchar) 254 && head[1] == 1)
   {
@@ -833,7 +843,7 @@ int open_table_def(THD *thd, TABLE_SHARE *share, uint db_flags)
     root_ptr= my_thread_get_THR_MALLOC();
     old_root= *root_ptr;
     *root_ptr= &share->mem_root;
-    error= open_binary_frm(thd, share, head, file);
+    error= open_binary_frm(thd, share, image, image_length);
     *root_ptr= old_root;
     error_given= 1;
   }
@@ -860,7 +870,7 @@ int open_table_def(THD *thd, TABLE_SHARE *share, uint db_flags)
     thd->status_var.opened_shares++;
 
 err:
-  mysql_file_close(file, MYF(MY_WME));
+  my_free(image);
 
 err_not_open:
   if (error && !error_given)
@@ -1665,9 +1675,10 @@ static int make_field_from_frm(THD *thd,
   repeated there.
 */
 
-static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
-                           File file)
+static int open_binary_frm(THD *thd, TABLE_SHARE *share,
+                           const uchar *image, size_t image_length)
 {
+  const uchar *head= image;
   int error, errarg= 0;
   uint new_frm_ver, field_pack_length, new_field_pack_flag;
   uint interval_count, interval_parts, read_length, int_length;
@@ -1682,7 +1693,7 @@ static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
   uchar forminfo[288];
   uchar *record;
   uchar *disk_buff, *strpos, *null_flags, *null_pos;
-  ulong pos, record_offset, *rec_per_key, rec_buff_length;
+  ulong pos, form_pos, record_offset, *rec_per_key, rec_buff_length;
   rec_per_key_t *rec_per_key_float;
   handler *handler_file= 0;
   KEY	*keyinfo;
@@ -1704,11 +1715,10 @@ static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
 
   error= 3;
   /* Position of the form in the form file. */
-  if (!(pos= get_form_pos(file, head)))
+  if (!(form_pos= get_form_pos(image, image_length)))
     goto err;                                   /* purecov: inspected */
 
-  mysql_file_seek(file,pos,MY_SEEK_SET,MYF(0));
-  if (mysql_file_read(file, forminfo,288,MYF(MY_NABP)))
+  if (read_frm_bytes(image, image_length, form_pos, forminfo, 288))
     goto err;
   share->frm_version= head[2];
   /*
@@ -1771,8 +1781,8 @@ static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
 
   /* Read keyinformation */
   key_info_length= (uint) uint2korr(head+28);
-  mysql_file_seek(file, (ulong) uint2korr(head+6), MY_SEEK_SET, MYF(0));
-  if (read_string(file, &disk_buff,key_info_length))
+  if (read_frm_string(image, image_length, (ulong) uint2korr(head+6),
+                      &disk_buff, key_info_length))
     goto err;                                   /* purecov: inspected */
   if (disk_buff[0] & 0x80)
   {
@@ -1940,9 +1950,9 @@ static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
                                                  n_length, MYF(MY_WME))))
       goto err;
     next_chunk= extra_segment_buff;
-    if (mysql_file_pread(file, extra_segment_buff,
-                         n_length, record_offset + share->reclength,
-                         MYF(MY_NABP)))
+    if (read_frm_bytes(image, image_length,
+                       record_offset + share->reclength,
+                       extra_segment_buff, n_length))
     {
       goto err;
     }
@@ -2216,12 +2226,10 @@ static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
                                      rec_buff_length)))
     goto err;                                   /* purecov: inspected */
   share->default_values= record;
-  if (mysql_file_pread(file, record, (size_t) share->reclength,
-                       record_offset, MYF(MY_NABP)))
+  if (read_frm_bytes(image, image_length, record_offset, record,
+                     (size_t) share->reclength))
     goto err;                                   /* purecov: inspected */
 
-  mysql_file_seek(file, pos+288, MY_SEEK_SET, MYF(0));
-
   share->fields= uint2korr(forminfo+258);
   pos= uint2korr(forminfo+260);   /* Length of all screens */
   n_length= uint2korr(forminfo+268);
@@ -2255,7 +2263,8 @@ static int open_binary_frm(THD *thd, TABLE_SHARE *share, uchar *head,
   read_length=(uint) (share->fields * field_pack_length +
 		      pos+ (uint) (n_length+int_length+com_length+
 		                   gcol_screen_length));
-  if (read_string(file, &disk_buff,read_length))
+  if (read_frm_string(image, image_length, form_pos + 288,
+                      &disk_buff, read_length))
     goto err;                                   /* purecov: inspected */
 
   strpos= disk_buff+pos;
@@ -3693,6 +3702,64 @@ static ulong get_form_pos(File file, uchar *head)
 }
 
 
+/**
+  Like get_form_pos(File, uchar*), but for the image of a .frm file.
+
+  @retval The form position, 0 if the image is too short.
+*/
+
+static ulong get_form_pos(const uchar *image, size_t image_length)
+{
+  uint names, length;
+
+  if (!(names= uint2korr(image+8)))
+    return 0;
+
+  length= uint2korr(image+4);
+  if (64 + length + names*4 > image_length)
+    return 0;
+
+  return uint4korr(image + 64 + length);
+}
+
+
+/**
+  Copies length bytes at offset of the image of a .frm file to to.
+
+  @return true if the image is too short
+*/
+
+static bool read_frm_bytes(const uchar *image, size_t image_length,
+                           ulong offset, uchar *to, size_t length)
+{
+  if (offset > image_length || length > image_length - offset)
+    return true;
+  memcpy(to, image + offset, length);
+  return false;
+}
+
+
+/**
+  Like read_string(), but reads from offset of the image of a .frm file.
+*/
+
+static bool read_frm_string(const uchar *image, size_t image_length,
+                            ulong offset, uchar **to, size_t length)
+{
+  my_free(*to);
+  if (!(*to= (uchar*) my_malloc(key_memory_frm_string,
+                                length+1, MYF(MY_WME))) ||
+      read_frm_bytes(image, image_length, offset, *to, length))
+  {
+    my_free(*to);
+    *to= 0;
+    return true;
+  }
+  *((char*) *to+length)= '\0';
+  return false;
+}
+
+
 /*
   Read string from a file with malloc
 
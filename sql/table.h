@@ -50,6 +50,7 @@ struct LEX;
 typedef int8 plan_idx;
 class Opt_hints_qb;
 class Opt_hints_table;
+class Histogram;
 
 #define store_record(A,B) memcpy((A)->B,(A)->record[0],(size_t) (A)->s->reclength)
 #define restore_record(A,B) memcpy((A)->record[0],(A)->B,(size_t) (A)->s->reclength)
@@ -582,6 +583,11 @@ struct TABLE_SHARE
   Field **found_next_number_field;
   KEY  *key_info;			/* data of keys defined for the table */
   uint	*blob_field;			/* Index to blobs in Field arrray*/
+  /**
+    Column value histograms, indexed like field, or NULL if no column
+    of the table has one. Set in get_table_share(), see histogram.h.
+  */
+  const Histogram **histograms;
 
   uchar	*default_values;		/* row with default values */
   LEX_STRING comment;			/* Comment about table */
@@ -732,6 +738,15 @@ struct TABLE_SHARE
   */ 
   const File_parser *view_def;
 
+  /**
+    File_parser object with the .TRG file of the table, read when the
+    first TABLE of the share is opened and used by the later ones.
+    NULL if the table has no triggers. Valid only if trg_def_loaded is
+    set; both are protected by LOCK_ha_data.
+  */
+  const File_parser *trg_def;
+  bool trg_def_loaded;
+
   /**
     True in the case if tokudb read-free-replication is used for the table
     without explicit pk and corresponding warning was issued to disable
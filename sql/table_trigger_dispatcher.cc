@@ -418,13 +418,16 @@ bool Table_trigger_dispatcher::prepare_record1_accessors()
   @param table_name   table's name
   @param table        pointer to table object
   @param names_only   stop after loading trigger names
+  @param trg_file     the TRG-file if already read, see
+                      Trigger_loader::read_trg_file()
 
   @return Operation status.
     @retval false Success
     @retval true  Failure
 */
 
-bool Table_trigger_dispatcher::check_n_load(THD *thd, bool names_only)
+bool Table_trigger_dispatcher::check_n_load(THD *thd, bool names_only,
+                                            const File_parser *trg_file)
 {
   // Load triggers from Data Dictionary.
 
@@ -432,7 +435,8 @@ bool Table_trigger_dispatcher::check_n_load(THD *thd, bool names_only)
                                     get_mem_root(),
                                     m_db_name.str,
                                     m_subject_table_name.str,
-                                    &m_triggers))
+                                    &m_triggers,
+                                    trg_file))
   {
     return true;
   }
@@ -31,6 +31,7 @@
 
 ///////////////////////////////////////////////////////////////////////////
 
+class File_parser;
 class Query_tables_list;
 class String;
 class Trigger_chain;
@@ -49,7 +50,8 @@ class Table_trigger_dispatcher : public Sql_alloc,
 public:
   static Table_trigger_dispatcher *create(TABLE *subject_table);
 
-  bool check_n_load(THD *thd, bool names_only);
+  bool check_n_load(THD *thd, bool names_only,
+                    const File_parser *trg_file= NULL);
 
 private:
   Table_trigger_dispatcher(TABLE *subject_table);
@@ -551,6 +551,48 @@ bool Trigger_loader::trg_file_exists(const char *db_name,
 }
 
 
+/**
+  Read the TRG-file of a table.
+
+  The returned parser can be shared: parsing its contents does not change
+  it, so it can be kept in the TABLE_SHARE and used for every TABLE.
+
+  @param [in]  mem_root           memory for the file contents
+  @param [in]  db_name            name of schema
+  @param [in]  table_name         subject table name
+
+  @return the parser of the file, or NULL on error, which has been
+          reported
+*/
+
+File_parser *Trigger_loader::read_trg_file(MEM_ROOT *mem_root,
+                                           const char *db_name,
+                                           const char *table_name)
+{
+  char trg_file_path_buffer[FN_REFLEN];
+  LEX_STRING trg_file_path;
+
+  trg_file_path.length= build_table_filename(trg_file_path_buffer,
+                                             FN_REFLEN - 1,
+                                             db_name, table_name, TRG_EXT, 0);
+  trg_file_path.str= trg_file_path_buffer;
+
+  File_parser *parser=
+    sql_parse_prepare(&trg_file_path, mem_root, true);
+
+  if (!parser)
+    return NULL;
+
+  if (!is_equal(&trg_file_type, parser->type()))
+  {
+    my_error(ER_WRONG_OBJECT, MYF(0), table_name, TRG_EXT + 1, "TRIGGER");
+    return NULL;
+  }
+
+  return parser;
+}
+
+
 /**
   Load table triggers from the data dictionary.
 
@@ -559,6 +601,8 @@ bool Trigger_loader::trg_file_exists(const char *db_name,
   @param [in]  table_name         subject table name
   @param [out] triggers           pointer to the list where new Trigger
                                   objects will be inserted
+  @param [in]  trg_file           the TRG-file as read by read_trg_file(),
+                                  or NULL to read it here
 
   @return Operation status
     @retval true   Failure
@@ -569,7 +613,8 @@ bool Trigger_loader::load_triggers(THD *thd,
                                    MEM_ROOT *mem_root,
                                    const char *db_name,
                                    const char *table_name,
-                                   List<Trigger> *triggers)
+                                   List<Trigger> *triggers,
+                                   const File_parser *trg_file)
 {
   DBUG_ENTER("Trigger_loader::load_triggers");
 
@@ -585,17 +630,10 @@ bool Trigger_loader::load_triggers(THD *thd,
 
   // The TRG-file exists so we got to load triggers.
 
-  File_parser *parser=
-    sql_parse_prepare(&trg_file_path, mem_root, true);
-
-  if (!parser)
-    DBUG_RETURN(true);
+  const File_parser *parser= trg_file;
 
-  if (!is_equal(&trg_file_type, parser->type()))
-  {
-    my_error(ER_WRONG_OBJECT, MYF(0), table_name, TRG_EXT + 1, "TRIGGER");
+  if (!parser && !(parser= read_trg_file(mem_root, db_name, table_name)))
     DBUG_RETURN(true);
-  }
 
   Handle_old_incorrect_sql_modes_hook sql_modes_hook(trg_file_path.str);
 
@@ -23,6 +23,7 @@
 
 struct TABLE;
 
+class File_parser;
 class THD;
 class Trigger;
 
@@ -49,11 +50,16 @@ public:
   static bool trg_file_exists(const char *db_name,
                               const char *table_name);
 
+  static File_parser *read_trg_file(MEM_ROOT *mem_root,
+                                    const char *db_name,
+                                    const char *table_name);
+
   static bool load_triggers(THD *thd,
                             MEM_ROOT *mem_root,
                             const char *db_name,
                             const char *table_name,
-                            List<Trigger> *triggers);
+                            List<Trigger> *triggers,
+                            const File_parser *trg_file= NULL);
 
   static bool store_trigger(const LEX_STRING &db_name,
                             const LEX_STRING &table_name,
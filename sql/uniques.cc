@@ -60,28 +60,278 @@ int unique_write_to_ptrs(uchar* key, element_count count, Unique *unique)
   return 0;
 }
 
+/*
+  Minimum number of slots of the hash set. The set starts with this many
+  and doubles whenever it gets two thirds full.
+*/
+static const ulong MIN_HASH_CAPACITY= 64;
+
+/**
+  @param comp_func             Function to compare keys
+  @param comp_func_fixed_arg   First argument of comp_func
+  @param size_arg              Size of the keys
+  @param max_in_memory_size_arg  Memory to use for keys before they are
+                               written to a temporary file
+  @param binary_keys           True if comp_func returns 0 exactly for keys
+                               with the same bytes. The keys are then
+                               kept in a hash set.
+*/
+
 Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
-	       uint size_arg, ulonglong max_in_memory_size_arg)
+	       uint size_arg, ulonglong max_in_memory_size_arg,
+               bool binary_keys)
   :file_ptrs(PSI_INSTRUMENT_ME),
    max_in_memory_size(max_in_memory_size_arg),
    record_pointers(NULL),
    size(size_arg),
+   m_use_hash(binary_keys && size_arg > 0),
+   m_keys(NULL),
+   m_slots(NULL),
+   m_hash_elements(0),
+   m_hash_capacity(0),
+   m_max_hash_capacity(0),
+   m_keys_allocated(0),
+   m_slots_allocated(0),
    elements(0)
 {
   my_b_clear(&file);
-  init_tree(&tree, (ulong) (max_in_memory_size / 16), 0, size, comp_func, 0,
-            NULL, comp_func_fixed_arg);
+  init_tree(&tree, m_use_hash ? 0 : (ulong) (max_in_memory_size / 16), 0,
+            size, comp_func, 0, NULL, comp_func_fixed_arg);
 
-  /*
-    If you change the following, change it in get_max_elements function, too.
-  */
-  max_elements= (ulong) (max_in_memory_size /
-                         ALIGN_SIZE(sizeof(TREE_ELEMENT)+size));
+  max_elements= get_max_elements(max_in_memory_size, size, m_use_hash);
+  if (m_use_hash)
+  {
+    m_max_hash_capacity= MIN_HASH_CAPACITY;
+    while (m_max_hash_capacity < max_elements + max_elements / 2 + 1)
+      m_max_hash_capacity*= 2;
+  }
   (void) open_cached_file(&file, mysql_tmpdir,TEMP_PREFIX, DISK_BUFFER_SIZE,
 		   MYF(MY_WME));
 }
 
 
+/**
+  @return the number of keys of the given size that Unique keeps in
+          max_in_memory_size bytes before it writes them to a file
+*/
+
+ulong Unique::get_max_elements(ulonglong max_in_memory_size, uint key_size,
+                               bool binary_keys)
+{
+  if (!binary_keys)
+    return (ulong) (max_in_memory_size /
+                    ALIGN_SIZE(sizeof(TREE_ELEMENT)+key_size));
+  /*
+    Every key takes its size plus at most three slots, as the set is
+    at least one third full once it has grown beyond its minimum.
+  */
+  ulong max_elements=
+    (ulong) (max_in_memory_size / (key_size + 3 * sizeof(uint32)));
+  set_if_bigger(max_elements, 1UL);
+  // Key numbers are stored in 32 bits
+  set_if_smaller(max_elements, (ulong) (UINT_MAX32 / 2));
+  return max_elements;
+}
+
+
+/**
+  Hash of a key, computed eight bytes at a time.
+*/
+
+static inline ulong unique_key_hash(const uchar *key, uint length)
+{
+  ulonglong hash= length;
+  for (; length >= 8; key+= 8, length-= 8)
+    hash= (hash ^ uint8korr(key)) * 0x9E3779B97F4A7C15ULL;
+  for (; length > 0; key++, length--)
+    hash= (hash ^ *key) * 0x100000001B3ULL;
+  return (ulong) (hash ^ (hash >> 29));
+}
+
+
+/**
+  Find the slot of a key in the hash set.
+
+  @return the slot of the key, or the free slot where the key belongs
+*/
+
+ulong Unique::hash_find_slot(const uchar *key, ulong hash) const
+{
+  const ulong mask= m_hash_capacity - 1;
+  for (ulong pos= hash & mask; ; pos= (pos + 1) & mask)
+  {
+    const uint32 slot= m_slots[pos];
+    if (slot == 0 || memcmp(m_keys + (size_t) (slot - 1) * size, key, size) == 0)
+      return pos;
+  }
+}
+
+
+/**
+  Add a key to the hash set, writing the set to the file first if it has
+  max_elements keys.
+
+  @retval false  the key was added or was in the set already
+  @retval true   out of memory or write error
+*/
+
+bool Unique::hash_add(const uchar *key)
+{
+  if (m_slots == NULL)
+  {
+    if (!(m_slots= (uint32*) my_malloc(key_memory_Unique_sort_buffer,
+                                       MIN_HASH_CAPACITY * sizeof(uint32),
+                                       MYF(0))))
+      return true;
+    m_slots_allocated= MIN_HASH_CAPACITY;
+    m_hash_capacity= MIN_HASH_CAPACITY;
+    memset(m_slots, 0, m_hash_capacity * sizeof(uint32));
+  }
+
+  const ulong hash= unique_key_hash(key, size);
+  ulong pos= hash_find_slot(key, hash);
+  if (m_slots[pos] != 0)
+    return false;
+
+  if (m_hash_elements == max_elements)
+  {
+    if (flush())
+      return true;
+    pos= hash_find_slot(key, hash);
+  }
+  else if ((m_hash_elements + 1) * 3 > m_hash_capacity * 2 &&
+           m_hash_capacity < m_max_hash_capacity)
+  {
+    if (hash_grow(m_hash_capacity * 2))
+      return true;
+    pos= hash_find_slot(key, hash);
+  }
+
+  if (m_hash_elements == m_keys_allocated)
+  {
+    ulong n_keys= std::max(m_keys_allocated * 2, MIN_HASH_CAPACITY);
+    set_if_smaller(n_keys, max_elements);
+    uchar *keys= (uchar*) my_realloc(key_memory_Unique_sort_buffer, m_keys,
+                                     (size_t) n_keys * size,
+                                     MYF(MY_ALLOW_ZERO_PTR));
+    if (keys == NULL)
+      return true;
+    m_keys= keys;
+    m_keys_allocated= n_keys;
+  }
+
+  memcpy(m_keys + m_hash_elements * size, key, size);
+  m_slots[pos]= (uint32) ++m_hash_elements;
+  return false;
+}
+
+
+/**
+  Rehash the keys of the hash set into the given number of slots,
+  allocating more slots if needed. Slots allocated once are kept until
+  the Unique is destroyed, also when reset() shrinks the set.
+
+  @retval true  out of memory, the set is left as it was
+*/
+
+bool Unique::hash_grow(ulong capacity)
+{
+  if (capacity > m_slots_allocated)
+  {
+    uint32 *slots= (uint32*) my_malloc(key_memory_Unique_sort_buffer,
+                                       capacity * sizeof(uint32), MYF(0));
+    if (slots == NULL)
+      return true;
+    my_free(m_slots);
+    m_slots= slots;
+    m_slots_allocated= capacity;
+  }
+  hash_rebuild(capacity);
+  return false;
+}
+
+
+/**
+  Rehash the keys of the hash set into the given number of slots, which
+  must have been allocated.
+*/
+
+void Unique::hash_rebuild(ulong capacity)
+{
+  DBUG_ASSERT(capacity <= m_slots_allocated);
+  m_hash_capacity= capacity;
+  memset(m_slots, 0, m_hash_capacity * sizeof(uint32));
+  for (ulong i= 0; i < m_hash_elements; i++)
+  {
+    const uchar *key= m_keys + i * size;
+    m_slots[hash_find_slot(key, unique_key_hash(key, size))]= (uint32) (i + 1);
+  }
+}
+
+
+/**
+  Remove all keys from the hash set, shrinking it to its minimum size.
+*/
+
+void Unique::hash_clear()
+{
+  if (m_slots != NULL)
+    memset(m_slots, 0, m_hash_capacity * sizeof(uint32));
+  m_hash_capacity= MIN_HASH_CAPACITY;
+  m_hash_elements= 0;
+}
+
+
+namespace {
+
+/** Orders key numbers of the hash set by the comparison function. */
+struct Unique_key_less
+{
+  Unique_key_less(const uchar *keys, uint size, qsort_cmp2 compare,
+                  const void *compare_arg)
+    : m_keys(keys), m_size(size), m_compare(compare), m_compare_arg(compare_arg)
+  {}
+
+  bool operator()(uint32 a, uint32 b) const
+  {
+    return m_compare(m_compare_arg, m_keys + (size_t) a * m_size,
+                     m_keys + (size_t) b * m_size) < 0;
+  }
+
+  const uchar *m_keys;
+  uint m_size;
+  qsort_cmp2 m_compare;
+  const void *m_compare_arg;
+};
+
+} // namespace
+
+
+/**
+  Call action for the keys of the hash set in sorted order. The key
+  numbers are sorted in the slots, so the set must be cleared or rebuilt
+  afterwards.
+*/
+
+bool Unique::hash_walk(tree_walk_action action, void *walk_action_arg)
+{
+  if (m_hash_elements == 0)
+    return false;
+
+  for (ulong i= 0; i < m_hash_elements; i++)
+    m_slots[i]= (uint32) i;
+  std::sort(m_slots, m_slots + m_hash_elements,
+            Unique_key_less(m_keys, size, tree.compare, tree.custom_arg));
+
+  for (ulong i= 0; i < m_hash_elements; i++)
+  {
+    if (action(m_keys + (size_t) m_slots[i] * size, 1, walk_action_arg))
+      return true;
+  }
+  return false;
+}
+
+
 /**
   Calculate log2(n!)
 
@@ -258,6 +508,8 @@ static double get_merge_many_buffs_cost(Unique::Imerge_cost_buf_type buffer,
       nkeys     #of elements in Unique
       key_size  size of each elements in bytes
       max_in_memory_size amount of memory Unique will be allowed to use
+      binary_keys  true if the keys are kept in a hash set, see the
+                   constructor
 
   RETURN
     Cost in disk seeks.
@@ -282,6 +534,10 @@ static double get_merge_many_buffs_cost(Unique::Imerge_cost_buf_type buffer,
 
       Approximate value of log2(N!) is calculated by log2_n_fact function.
 
+      A hash set needs about one comparison per added element, and a sort
+      of its elements, i.e. log2(N!) comparisons, before it is written to
+      disk or read.
+
     2. Cost of merging.
       If only one tree is created by Unique no merging will be necessary.
       Otherwise, we model execution of merge_many_buff function and count
@@ -297,22 +553,33 @@ static double get_merge_many_buffs_cost(Unique::Imerge_cost_buf_type buffer,
 double Unique::get_use_cost(Imerge_cost_buf_type buffer,
                             uint nkeys, uint key_size,
                             ulonglong max_in_memory_size,
-                            const Cost_model_table *cost_model)
+                            const Cost_model_table *cost_model,
+                            bool binary_keys)
 {
   ulong max_elements_in_tree;
   ulong last_tree_elems;
   int   n_full_trees; /* number of trees in unique - 1 */
 
-  max_elements_in_tree= ((ulong) max_in_memory_size /
-                         ALIGN_SIZE(sizeof(TREE_ELEMENT)+key_size));
+  max_elements_in_tree= get_max_elements(max_in_memory_size, key_size,
+                                         binary_keys);
 
   n_full_trees=    nkeys / max_elements_in_tree;
   last_tree_elems= nkeys % max_elements_in_tree;
 
   /* Calculate cost of creating trees */
-  double n_compares= 2 * log2_n_fact(last_tree_elems + 1);
-  if (n_full_trees)
-    n_compares+= n_full_trees * log2_n_fact(max_elements_in_tree + 1);
+  double n_compares;
+  if (binary_keys)
+  {
+    n_compares= nkeys + log2_n_fact(last_tree_elems);
+    if (n_full_trees)
+      n_compares+= n_full_trees * log2_n_fact(max_elements_in_tree);
+  }
+  else
+  {
+    n_compares= 2 * log2_n_fact(last_tree_elems + 1);
+    if (n_full_trees)
+      n_compares+= n_full_trees * log2_n_fact(max_elements_in_tree + 1);
+  }
   double result= cost_model->key_compare_cost(n_compares);
 
   DBUG_PRINT("info",("unique trees sizes: %u=%u*%lu + %lu", nkeys,
@@ -355,6 +622,8 @@ Unique::~Unique()
 {
   close_cached_file(&file);
   delete_tree(&tree);
+  my_free(m_keys);
+  my_free(m_slots);
 }
 
 
@@ -362,10 +631,19 @@ Unique::~Unique()
 bool Unique::flush()
 {
   Merge_chunk file_ptr;
-  elements+= tree.elements_in_tree;
-  file_ptr.set_rowcount(tree.elements_in_tree);
+  elements+= elements_in_tree();
+  file_ptr.set_rowcount(elements_in_tree());
   file_ptr.set_file_position(my_b_tell(&file));
 
+  if (m_use_hash)
+  {
+    if (hash_walk((tree_walk_action) unique_write_to_file, this) ||
+        file_ptrs.push_back(file_ptr))
+      return 1;
+    hash_clear();
+    return 0;
+  }
+
   if (tree_walk(&tree, (tree_walk_action) unique_write_to_file,
 		(void*) this, left_root_right) ||
       file_ptrs.push_back(file_ptr))
@@ -383,7 +661,10 @@ bool Unique::flush()
 void
 Unique::reset()
 {
-  reset_tree(&tree);
+  if (m_use_hash)
+    hash_clear();
+  else
+    reset_tree(&tree);
   /*
     If elements != 0, some trees were stored in the file (see how
     flush() works). Note, that we can not count on my_b_tell(&file) == 0
@@ -613,7 +894,16 @@ bool Unique::walk(tree_walk_action action, void *walk_action_arg)
   uchar *merge_buffer;
 
   if (elements == 0)                       /* the whole tree is in memory */
+  {
+    if (m_use_hash)
+    {
+      res= hash_walk(action, walk_action_arg);
+      if (m_hash_elements > 0)
+        hash_rebuild(m_hash_capacity);
+      return res;
+    }
     return tree_walk(&tree, action, walk_action_arg, left_root_right);
+  }
 
   /* flush current tree to the file to have some memory for merge buffer */
   if (flush())
@@ -648,7 +938,7 @@ bool Unique::walk(tree_walk_action action, void *walk_action_arg)
 
 bool Unique::get(TABLE *table)
 {
-  table->sort.found_records=elements+tree.elements_in_tree;
+  table->sort.found_records=elements+elements_in_tree();
 
   if (my_b_tell(&file) == 0)
   {
@@ -656,10 +946,13 @@ bool Unique::get(TABLE *table)
     DBUG_ASSERT(table->sort.sorted_result == NULL);
     if ((record_pointers= table->sort.sorted_result= (uchar*)
 	 my_malloc(key_memory_Filesort_info_record_pointers,
-                   size * tree.elements_in_tree, MYF(0))))
+                   size * elements_in_tree(), MYF(0))))
     {
-      (void) tree_walk(&tree, (tree_walk_action) unique_write_to_ptrs,
-		       this, left_root_right);
+      if (m_use_hash)
+        (void) hash_walk((tree_walk_action) unique_write_to_ptrs, this);
+      else
+        (void) tree_walk(&tree, (tree_walk_action) unique_write_to_ptrs,
+                         this, left_root_right);
       return 0;
     }
   }
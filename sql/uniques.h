@@ -28,6 +28,10 @@ class Cost_model_table;
    it's dumped to the file. User can request sorted values, or
    just iterate through them. In the last case tree merging is performed in
    memory simultaneously with iteration, so it should be ~2-3x faster.
+
+   Keys that are equal exactly when their bytes are equal can be kept in
+   an open addressing hash set instead of the tree. They are only sorted
+   when they are dumped to the file or read back.
  */
 
 class Unique :public Sql_alloc
@@ -41,15 +45,42 @@ class Unique :public Sql_alloc
   bool flush();
   uint size;
 
+  /*
+    The hash set: m_keys holds the keys in the order they were added,
+    m_slots the key numbers plus one, or 0 for free slots. Only the
+    first m_hash_capacity slots are used; the set grows up to
+    m_max_hash_capacity slots. Both arrays are allocated for
+    m_keys_allocated keys and m_slots_allocated slots, and double in
+    size as the set grows.
+  */
+  bool m_use_hash;
+  uchar *m_keys;
+  uint32 *m_slots;
+  ulong m_hash_elements;
+  ulong m_hash_capacity;
+  ulong m_max_hash_capacity;
+  ulong m_keys_allocated;
+  ulong m_slots_allocated;
+  bool hash_add(const uchar *key);
+  ulong hash_find_slot(const uchar *key, ulong hash) const;
+  bool hash_grow(ulong capacity);
+  void hash_rebuild(ulong capacity);
+  void hash_clear();
+  bool hash_walk(tree_walk_action action, void *walk_action_arg);
+
 public:
   ulong elements;
   Unique(qsort_cmp2 comp_func, void *comp_func_fixed_arg,
-	 uint size_arg, ulonglong max_in_memory_size_arg);
+	 uint size_arg, ulonglong max_in_memory_size_arg,
+         bool binary_keys= false);
   ~Unique();
-  ulong elements_in_tree() { return tree.elements_in_tree; }
+  ulong elements_in_tree()
+  { return m_use_hash ? m_hash_elements : tree.elements_in_tree; }
   inline bool unique_add(void *ptr)
   {
     DBUG_ENTER("unique_add");
+    if (m_use_hash)
+      DBUG_RETURN(hash_add(static_cast<const uchar*>(ptr)));
     DBUG_PRINT("info", ("tree %u - %lu", tree.elements_in_tree, max_elements));
     if (tree.elements_in_tree > max_elements && flush())
       DBUG_RETURN(1);
@@ -60,17 +91,22 @@ public:
 
   typedef Bounds_checked_array<uint> Imerge_cost_buf_type;
 
+  static ulong get_max_elements(ulonglong max_in_memory_size, uint key_size,
+                                bool binary_keys= false);
+
   static double get_use_cost(Imerge_cost_buf_type buffer,
                              uint nkeys, uint key_size, 
                              ulonglong max_in_memory_size,
-                             const Cost_model_table *cost_model);
+                             const Cost_model_table *cost_model,
+                             bool binary_keys= false);
 
   // Returns the number of elements needed in Imerge_cost_buf_type.
   inline static size_t get_cost_calc_buff_size(ulong nkeys, uint key_size, 
-                                               ulonglong max_in_memory_size)
+                                               ulonglong max_in_memory_size,
+                                               bool binary_keys= false)
   {
     ulonglong max_elems_in_tree=
-      (max_in_memory_size / ALIGN_SIZE(sizeof(TREE_ELEMENT)+key_size));
+      get_max_elements(max_in_memory_size, key_size, binary_keys);
     return 1 + static_cast<size_t>(nkeys/max_elems_in_tree);
   }
 
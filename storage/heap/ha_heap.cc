@@ -385,6 +385,26 @@ int ha_heap::rnd_next(uchar *buf)
   return error;
 }
 
+int ha_heap::rnd_next_batch(uchar *buf, uint max_rows, uint *n_rows)
+{
+  const size_t rec_length= table->s->rec_buff_length;
+  int error= 0;
+
+  while (*n_rows < max_rows)
+  {
+    ha_statistic_increment(&SSV::ha_read_rnd_next_count);
+    if ((error= heap_scan(file, buf + *n_rows * rec_length)))
+    {
+      if (error != HA_ERR_RECORD_DELETED)
+        break;
+      continue;
+    }
+    (*n_rows)++;
+  }
+  table->status= error ? STATUS_NOT_FOUND : 0;
+  return error;
+}
+
 int ha_heap::rnd_pos(uchar * buf, uchar *pos)
 {
   int error;
@@ -882,6 +902,13 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
   hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
+  /*
+    Internal temporary tables with fixed rows are limited to tmp_table_size
+    by their max_rows. Dynamic rows vary in length, so limit the memory.
+  */
+  if (internal_table && share->row_type == ROW_TYPE_DYNAMIC)
+    set_if_smaller(hp_create_info->max_table_size,
+                   current_thd->variables.tmp_table_size);
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
   hp_create_info->max_chunk_size= share->key_block_size;
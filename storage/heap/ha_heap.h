@@ -50,7 +50,7 @@ public:
     return (HA_FAST_KEY_READ | HA_NULL_IN_KEY |
             HA_BINLOG_ROW_CAPABLE | HA_BINLOG_STMT_CAPABLE |
             HA_REC_NOT_IN_SEQ | HA_NO_TRANSACTIONS |
-            HA_HAS_RECORDS | HA_STATS_RECORDS_IS_EXACT);
+            HA_HAS_RECORDS | HA_STATS_RECORDS_IS_EXACT | HA_CAN_READ_BATCH);
   }
   ulong index_flags(uint inx, uint part, bool all_parts) const
   {
@@ -89,6 +89,7 @@ public:
   int index_last(uchar * buf);
   int rnd_init(bool scan);
   int rnd_next(uchar *buf);
+  int rnd_next_batch(uchar *buf, uint max_rows, uint *n_rows);
   int rnd_pos(uchar * buf, uchar *pos);
   void position(const uchar *record);
   int info(uint);
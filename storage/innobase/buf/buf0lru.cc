@@ -1008,6 +1008,80 @@ buf_LRU_flush_or_remove_pages(
 	}
 }
 
+/** Discard the pages of a range of a tablespace from the buffer pool
+without writing them, before the storage of the range is released. The
+pages must belong to free extents, so that no thread latches them or
+allocates them meanwhile.
+@param[in]	space_id	tablespace identifier
+@param[in]	first		first page number of the range
+@param[in]	n_pages		number of pages in the range
+@return false if a page could not be discarded because it is still
+buffer-fixed or I/O-fixed, e.g. by a flush that started before the page
+was freed */
+bool
+buf_LRU_discard_page_range(
+	ulint	space_id,
+	ulint	first,
+	ulint	n_pages)
+{
+	for (ulint page_no = first; page_no < first + n_pages; page_no++) {
+		const page_id_t	page_id(space_id, page_no);
+		buf_pool_t*	buf_pool = buf_pool_get(page_id);
+		rw_lock_t*	hash_lock;
+
+		mutex_enter(&buf_pool->LRU_list_mutex);
+
+		buf_page_t*	bpage = buf_page_hash_get_locked(
+			buf_pool, page_id, &hash_lock, RW_LOCK_X);
+
+		if (bpage == NULL) {
+			mutex_exit(&buf_pool->LRU_list_mutex);
+			continue;
+		}
+
+		BPageMutex*	block_mutex = buf_page_get_mutex(bpage);
+
+		mutex_enter(block_mutex);
+
+		/* The adaptive hash index entries of the pages of an
+		extent are dropped when the extent is freed. */
+		if (bpage->buf_fix_count > 0
+		    || buf_page_get_io_fix(bpage) != BUF_IO_NONE
+		    || (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE
+			&& reinterpret_cast<buf_block_t*>(bpage)->index
+			!= NULL)) {
+
+			mutex_exit(block_mutex);
+			rw_lock_x_unlock(hash_lock);
+			mutex_exit(&buf_pool->LRU_list_mutex);
+
+			return(false);
+		}
+
+		if (bpage->oldest_modification != 0) {
+			buf_flush_remove(bpage);
+		}
+
+		ut_ad(!bpage->in_flush_list);
+
+		if (buf_LRU_block_remove_hashed(bpage, true)) {
+			buf_LRU_block_free_hashed_page(
+				reinterpret_cast<buf_block_t*>(bpage));
+		} else {
+			ut_ad(block_mutex == &buf_pool->zip_mutex);
+		}
+
+		/* buf_LRU_block_remove_hashed() releases the hash_lock
+		and the block mutex */
+		ut_ad(!mutex_own(block_mutex));
+		ut_ad(!rw_lock_own(hash_lock, RW_LOCK_X));
+
+		mutex_exit(&buf_pool->LRU_list_mutex);
+	}
+
+	return(true);
+}
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 /********************************************************************//**
 Insert a compressed block into buf_pool->zip_clean in the LRU order. */
@@ -1523,16 +1523,42 @@ dict_table_can_be_evicted(
 	return(FALSE);
 }
 
+/** Check whether the dictionary cache is above its configured limits.
+@param[in]	n_tables	number of tables in dict_sys->table_LRU
+@param[in]	max_tables	max tables allowed in cache
+@param[in]	max_size	max bytes of dictionary objects allowed in
+cache, or 0 if the cache is not bounded by size
+@return true if some tables should be evicted */
+static
+bool
+dict_cache_over_limit(
+	ulint	n_tables,
+	ulint	max_tables,
+	ulint	max_size)
+{
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	return(n_tables > max_tables
+	       || (max_size > 0
+		   && static_cast<ulint>(dict_sys->size) > max_size));
+}
+
 /**********************************************************************//**
-Make room in the table cache by evicting an unused table. The unused table
+Make room in the table cache by evicting unused tables. The unused tables
 should not be part of FK relationship and currently not used in any user
 transaction. There is no guarantee that it will remove a table.
 @return number of tables evicted. If the number of tables in the dict_LRU
-is less than max_tables it will not do anything. */
+is less than max_tables and the dictionary objects occupy less than
+max_size bytes it will not do anything. */
 ulint
 dict_make_room_in_cache(
 /*====================*/
 	ulint		max_tables,	/*!< in: max tables allowed in cache */
+	ulint		max_size,	/*!< in: max bytes of dictionary
+					objects allowed in cache, or 0 for
+					no size limit */
+	ulint		max_evict,	/*!< in: max tables to evict in
+					this call */
 	ulint		pct_check)	/*!< in: max percent to check */
 {
 	ulint		i;
@@ -1543,13 +1569,14 @@ dict_make_room_in_cache(
 
 	ut_a(pct_check > 0);
 	ut_a(pct_check <= 100);
+	ut_a(max_evict > 0);
 	ut_ad(mutex_own(&dict_sys->mutex));
 	ut_ad(rw_lock_own(dict_operation_lock, RW_LOCK_X));
 	ut_ad(dict_lru_validate());
 
 	i = len = UT_LIST_GET_LEN(dict_sys->table_LRU);
 
-	if (len < max_tables) {
+	if (!dict_cache_over_limit(len, max_tables, max_size)) {
 		return(0);
 	}
 
@@ -1558,13 +1585,16 @@ dict_make_room_in_cache(
 	/* Check for overflow */
 	ut_a(i == 0 || check_up_to <= i);
 
-	/* Find a suitable candidate to evict from the cache. Don't scan the
-	entire LRU list. Only scan pct_check list entries. */
+	/* Find suitable candidates to evict from the cache. Don't scan the
+	entire LRU list. Only scan pct_check list entries, and stop after
+	max_evict tables so that the caller can release dict_sys->mutex
+	between batches. */
 
 	for (table = UT_LIST_GET_LAST(dict_sys->table_LRU);
 	     table != NULL
 	     && i > check_up_to
-	     && (len - n_evicted) > max_tables;
+	     && n_evicted < max_evict
+	     && dict_cache_over_limit(len - n_evicted, max_tables, max_size);
 	     --i) {
 
 		dict_table_t*	prev_table;
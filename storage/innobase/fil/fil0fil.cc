@@ -5330,6 +5330,61 @@ fil_space_get_n_reserved_extents(
 	return(n);
 }
 
+/** Keep the extents of a range of pages from being allocated while
+fsp_reclaim_free_extents() releases their storage without holding the
+tablespace latch. The range must be set while holding the latch.
+@param[in]	id		tablespace identifier
+@param[in]	page_no		first page of the range
+@param[in]	n_pages		number of pages in the range, or 0 to let
+				the extents be allocated again */
+void
+fil_space_set_reclaim_range(
+	ulint	id,
+	ulint	page_no,
+	ulint	n_pages)
+{
+	ut_ad(fil_system);
+
+	mutex_enter(&fil_system->mutex);
+
+	fil_space_t*	space = fil_space_get_by_id(id);
+
+	/* The tablespace may have been dropped while its storage was
+	being released. */
+	if (space != NULL) {
+		ut_ad(n_pages == 0 || space->reclaim_n_pages == 0);
+
+		space->reclaim_page_no = page_no;
+		space->reclaim_n_pages = n_pages;
+	}
+
+	mutex_exit(&fil_system->mutex);
+}
+
+/** Check whether the storage of a page is being released.
+@param[in]	id		tablespace identifier
+@param[in]	page_no		page number
+@return true if the page is in the range of fil_space_set_reclaim_range() */
+bool
+fil_space_is_being_reclaimed(
+	ulint	id,
+	ulint	page_no)
+{
+	ut_ad(fil_system);
+
+	mutex_enter(&fil_system->mutex);
+
+	const fil_space_t*	space = fil_space_get_by_id(id);
+
+	bool	reclaimed = space != NULL
+		&& page_no >= space->reclaim_page_no
+		&& page_no - space->reclaim_page_no < space->reclaim_n_pages;
+
+	mutex_exit(&fil_system->mutex);
+
+	return(reclaimed);
+}
+
 /*============================ FILE I/O ================================*/
 
 /********************************************************************//**
@@ -6365,6 +6420,34 @@ struct fil_iterator_t {
 	byte*		encryption_iv;		/*!< Encryption iv */
 };
 
+/** Check whether a multi-page read returned pages that need to be
+decrypted or decompressed. os_file_read() only transforms the first page
+of a read, such pages must be read one at a time.
+@param[in]	buf		pages read from the file
+@param[in]	n_bytes		number of bytes read
+@param[in]	page_size	physical page size
+@return true if a page other than the first one is transformed */
+static
+bool
+fil_iterate_has_transformed_pages(
+	const byte*	buf,
+	ulint		n_bytes,
+	ulint		page_size)
+{
+	for (ulint i = page_size; i < n_bytes; i += page_size) {
+
+		switch (fil_page_get_type(buf + i)) {
+		case FIL_PAGE_COMPRESSED:
+		case FIL_PAGE_ENCRYPTED:
+		case FIL_PAGE_COMPRESSED_AND_ENCRYPTED:
+		case FIL_PAGE_ENCRYPTED_RTREE:
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
 /********************************************************************//**
 TODO: This can be made parallel trivially by chunking up the file and creating
 a callback per thread. Main benefit will be to use multiple CPUs for
@@ -6388,7 +6471,8 @@ fil_iterate(
 	os_offset_t		offset;
 	ulint			page_no = 0;
 	ulint			space_id = callback.get_space_id();
-	ulint			n_bytes = iter.n_io_buffers * iter.page_size;
+	ulint			n_io_buffers = iter.n_io_buffers;
+	ulint			n_bytes = n_io_buffers * iter.page_size;
 
 	ut_ad(!srv_read_only_mode);
 
@@ -6429,7 +6513,8 @@ fil_iterate(
 		InnoDB IO functions croak on failed reads. */
 
 		n_bytes = static_cast<ulint>(
-			ut_min(static_cast<os_offset_t>(n_bytes),
+			ut_min(static_cast<os_offset_t>(
+				       n_io_buffers * iter.page_size),
 			       iter.end - offset));
 
 		ut_ad(n_bytes > 0);
@@ -6457,6 +6542,18 @@ fil_iterate(
 			return(err);
 		}
 
+		if (n_bytes > iter.page_size
+		    && fil_iterate_has_transformed_pages(
+			    io_buffer, n_bytes, iter.page_size)) {
+
+			/* The first page has already been transformed by
+			os_file_read(), process it alone and continue page
+			by page from the next one. */
+
+			n_io_buffers = 1;
+			n_bytes = iter.page_size;
+		}
+
 		bool		updated = false;
 		os_offset_t	page_off = offset;
 		ulint		n_pages_read = (ulint) n_bytes / iter.page_size;
@@ -6653,10 +6750,11 @@ fil_tablespace_iterate(
 
 		if (err == DB_SUCCESS) {
 
-			/* Compressed pages can't be optimised for block IO
-			for now.  We do the IMPORT page by page. */
+			/* Compressed and encrypted pages can't be optimised
+			for block IO for now.  We do the IMPORT page by page. */
 
-			if (callback.get_page_size().is_compressed()) {
+			if (callback.get_page_size().is_compressed()
+			    || FSP_FLAGS_GET_ENCRYPTION(space_flags)) {
 				iter.n_io_buffers = 1;
 				ut_a(iter.page_size
 				     == callback.get_page_size().physical());
@@ -7264,6 +7362,77 @@ fil_no_punch_hole(fil_node_t* node)
 	node->punch_hole = false;
 }
 
+#ifndef UNIV_HOTBACKUP
+/** Release the storage of a range of pages of a single-file tablespace by
+punching a hole in its data file. The pages must not be in use.
+Tablespaces that consist of several files are not supported.
+@param[in]	space_id	tablespace identifier
+@param[in]	page_no		first page of the range
+@param[in]	n_pages		number of pages in the range
+@return DB_SUCCESS or error code */
+dberr_t
+fil_punch_hole_pages(
+	ulint	space_id,
+	ulint	page_no,
+	ulint	n_pages)
+{
+	ut_ad(!srv_read_only_mode);
+
+	fil_mutex_enter_and_prepare_for_io(space_id);
+
+	fil_space_t*	space = fil_space_get_by_id(space_id);
+
+	if (space == NULL || space->stop_new_ops) {
+		mutex_exit(&fil_system->mutex);
+
+		return(DB_TABLESPACE_DELETED);
+	}
+
+	if (UT_LIST_GET_LEN(space->chain) != 1) {
+		mutex_exit(&fil_system->mutex);
+
+		return(DB_IO_NO_PUNCH_HOLE_TABLESPACE);
+	}
+
+	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+
+	if (!node->punch_hole) {
+		mutex_exit(&fil_system->mutex);
+
+		return(DB_IO_NO_PUNCH_HOLE);
+	}
+
+	if (!fil_node_prepare_for_io(node, fil_system, space)) {
+		mutex_exit(&fil_system->mutex);
+
+		return(DB_ERROR);
+	}
+
+	const page_size_t	page_size(space->flags);
+
+	mutex_exit(&fil_system->mutex);
+
+	dberr_t	err = os_file_punch_hole(
+		node->handle.m_file,
+		static_cast<os_offset_t>(page_no) * page_size.physical(),
+		static_cast<os_offset_t>(n_pages) * page_size.physical());
+
+	mutex_enter(&fil_system->mutex);
+
+	/* The file contents did not change, account the hole as a read
+	so that the node is not queued for a flush. */
+	fil_node_complete_io(node, fil_system, IORequestRead);
+
+	if (err == DB_IO_NO_PUNCH_HOLE) {
+		fil_no_punch_hole(node);
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	return(err);
+}
+#endif /* !UNIV_HOTBACKUP */
+
 /** Set the compression type for the tablespace of a table
 @param[in]	table		The table that should be compressed
 @param[in]	algorithm	Text representation of the algorithm
@@ -35,6 +35,7 @@ Created 11/29/1995 Heikki Tuuri
 # include "fut0lst.h"
 #else /* UNIV_HOTBACKUP */
 #include "buf0buf.h"
+#include "buf0lru.h"
 #include "fil0fil.h"
 #include "mtr0log.h"
 #include "ut0byte.h"
@@ -1843,6 +1844,14 @@ fsp_alloc_free_extent(
 			space_id, page_size, first, mtr);
 	}
 
+	/* fsp_reclaim_free_extents() releases the storage of free extents
+	without holding the tablespace latch. A page of the extent must not
+	be written before the hole is punched. */
+	while (fil_space_is_being_reclaimed(space_id,
+					    xdes_get_offset(descr))) {
+		os_thread_sleep(1000);
+	}
+
 	flst_remove(header + FSP_FREE, descr + XDES_FLST_NODE, mtr);
 	space->free_len--;
 
@@ -3558,6 +3567,193 @@ fsp_get_available_space_in_free_extents(
 	       * FSP_EXTENT_SIZE * (page_size.physical() / 1024));
 }
 
+/** Release the storage of the free extents of a tablespace by punching
+holes in its data file. The size of the tablespace does not change and
+the extents stay on the FSP_FREE list, to be allocated again as usual.
+Only the extent descriptor pages last modified in [lsn_start, lsn_limit)
+are examined. For a redo logged tablespace lsn_limit must not exceed the
+last checkpoint LSN: no redo log record newer than the checkpoint can
+then refer to a page of an extent that was free at that point, so crash
+recovery never applies redo to a page whose storage was released. The
+temporary tablespace is not recovered and can use LSN_MAX.
+The free extents of a descriptor page are found while holding the
+tablespace latch, and their storage is released after it is released,
+while fil_space_set_reclaim_range() keeps them from being allocated.
+@param[in]	space_id	tablespace identifier
+@param[in]	lsn_start	descriptor pages modified before this LSN
+				were examined by an earlier call
+@param[in]	lsn_limit	checkpoint LSN, or LSN_MAX
+@param[out]	n_released	number of extents whose storage was
+				released
+@return DB_SUCCESS if every descriptor page in [lsn_start, lsn_limit)
+was examined, so that the next pass may start at lsn_limit. A file
+system that cannot punch holes also yields DB_SUCCESS, since repeating
+the pass would not release anything either.
+@retval DB_FAIL if some free extents were skipped because their pages
+were still in use in the buffer pool */
+dberr_t
+fsp_reclaim_free_extents(
+	ulint	space_id,
+	lsn_t	lsn_start,
+	lsn_t	lsn_limit,
+	ulint*	n_released)
+{
+	dberr_t	err = DB_SUCCESS;
+	bool	skipped = false;
+
+	*n_released = 0;
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(space_id != TRX_SYS_SPACE);
+
+	/* Pairs of the first and the end page number of each run of free
+	extents of a descriptor page */
+	typedef std::vector<ulint, ut_allocator<ulint> >	runs_t;
+
+	runs_t	runs;
+
+	for (ulint xdes_page_no = 0; /* No op */; /* No op */) {
+		mtr_t	mtr;
+
+		/* Examine one extent descriptor page per mini-transaction
+		so that allocations in the tablespace are not blocked for
+		the duration of the whole scan. The holes are punched after
+		the mini-transaction is committed, so that neither are they
+		blocked during the I/O. */
+
+		mtr_start(&mtr);
+
+		fil_space_t*		space = mtr_x_lock_space(
+			space_id, &mtr);
+		const page_size_t	page_size(space->flags);
+
+		buf_block_t*	header_block = buf_page_get(
+			page_id_t(space_id, 0), page_size, RW_SX_LATCH, &mtr);
+
+		buf_block_dbg_add_level(header_block, SYNC_FSP_PAGE);
+
+		const fsp_header_t*	header = FSP_HEADER_OFFSET
+			+ buf_block_get_frame(header_block);
+
+		ulint	limit = mach_read_from_4(header + FSP_FREE_LIMIT);
+
+		if (xdes_page_no >= limit) {
+			mtr_commit(&mtr);
+			break;
+		}
+
+		buf_block_t*	block = header_block;
+
+		if (xdes_page_no != 0) {
+			block = buf_page_get(
+				page_id_t(space_id, xdes_page_no),
+				page_size, RW_SX_LATCH, &mtr);
+
+			buf_block_dbg_add_level(block, SYNC_FSP_PAGE);
+		}
+
+		const page_t*	page = buf_block_get_frame(block);
+		lsn_t		lsn = ut_max(
+			block->page.newest_modification,
+			mach_read_from_8(page + FIL_PAGE_LSN));
+
+		ulint	end = ut_min(xdes_page_no + page_size.physical(),
+				     limit);
+
+		runs.clear();
+
+		if (lsn >= lsn_start && lsn < lsn_limit) {
+			ulint	run_start = ULINT_UNDEFINED;
+
+			for (ulint page_no = xdes_page_no;
+			     page_no <= end;
+			     page_no += FSP_EXTENT_SIZE) {
+
+				const xdes_t*	descr = NULL;
+
+				if (page_no < end) {
+					descr = page + XDES_ARR_OFFSET
+						+ XDES_SIZE
+						* xdes_calc_descriptor_index(
+							page_size, page_no);
+				}
+
+				if (descr != NULL
+				    && xdes_get_state(descr, &mtr)
+				    == XDES_FREE) {
+
+					if (run_start == ULINT_UNDEFINED) {
+						run_start = page_no;
+					}
+
+				} else if (run_start != ULINT_UNDEFINED) {
+
+					runs.push_back(run_start);
+					runs.push_back(page_no);
+
+					run_start = ULINT_UNDEFINED;
+				}
+			}
+		}
+
+		/* The runs were found free while holding the tablespace
+		latch, which fsp_alloc_free_extent() needs too. Until the
+		range is reset, it waits instead of allocating them. */
+		if (!runs.empty()) {
+			fil_space_set_reclaim_range(
+				space_id, runs.front(),
+				runs.back() - runs.front());
+		}
+
+		mtr_commit(&mtr);
+
+		for (runs_t::const_iterator it = runs.begin();
+		     it != runs.end() && err == DB_SUCCESS;
+		     it += 2) {
+
+			const ulint	run_start = it[0];
+			const ulint	n_pages = it[1] - run_start;
+
+			/* A page still in the buffer pool could be written
+			into the hole by a later flush. The next pass retries
+			the extents whose pages are still in use. */
+			if (DBUG_EVALUATE_IF("fsp_reclaim_page_in_use",
+					     true, false)
+			    || !buf_LRU_discard_page_range(
+				    space_id, run_start, n_pages)) {
+				skipped = true;
+				continue;
+			}
+
+			err = fil_punch_hole_pages(
+				space_id, run_start, n_pages);
+
+			if (err == DB_SUCCESS) {
+				*n_released += n_pages / FSP_EXTENT_SIZE;
+			}
+		}
+
+		if (!runs.empty()) {
+			fil_space_set_reclaim_range(space_id, 0, 0);
+		}
+
+		if (err == DB_IO_NO_PUNCH_HOLE
+		    || err == DB_IO_NO_PUNCH_HOLE_TABLESPACE) {
+			err = DB_SUCCESS;
+			break;
+		} else if (err != DB_SUCCESS) {
+			ib::warn() << "Failed to release free extents"
+				" of tablespace " << space_id << ": "
+				<< ut_strerr(err);
+			break;
+		}
+
+		xdes_page_no += page_size.physical();
+	}
+
+	return(err == DB_SUCCESS && skipped ? DB_FAIL : err);
+}
+
 /********************************************************************//**
 Marks a page used. The page must reside within the extents of the given
 segment. */
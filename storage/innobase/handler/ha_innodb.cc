@@ -94,6 +94,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0mysql.h"
+#include "row0pread.h"
 #include "row0quiesce.h"
 #include "row0sel.h"
 #include "row0trunc.h"
@@ -521,6 +522,7 @@ static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(io_write_thread),
 	PSI_KEY(page_cleaner_thread),
 	PSI_KEY(buf_lru_manager_thread),
+	PSI_KEY(parallel_read_thread),
 	PSI_KEY(srv_error_monitor_thread),
 	PSI_KEY(srv_lock_timeout_thread),
 	PSI_KEY(srv_master_thread),
@@ -3135,6 +3137,7 @@ ha_innobase::ha_innobase(
 			  | HA_ATTACHABLE_TRX_COMPATIBLE
 			  | HA_CAN_INDEX_VIRTUAL_GENERATED_COLUMN
 			  | HA_ONLINE_ANALYZE
+			  | HA_CAN_READ_BATCH
 		  ),
 	m_start_of_scan(),
 	m_num_write_row(),
@@ -10087,6 +10090,56 @@ ha_innobase::rnd_next(
 	DBUG_RETURN(error);
 }
 
+/** Reads the next rows of a table scan. The rows after the first one are
+fetched without going through the handler interface for every row.
+Locking reads return one row per call, so that rows are not locked ahead
+of the caller.
+@param[out]	buf		buffer for max_rows rows in MySQL format,
+				table->s->rec_buff_length bytes apart
+@param[in]	max_rows	maximum number of rows to read
+@param[out]	n_rows		number of rows read
+@return 0 if at least one row was read, or the error number that ended
+the batch */
+
+int
+ha_innobase::rnd_next_batch(
+	uchar*	buf,
+	uint	max_rows,
+	uint*	n_rows)
+{
+	DBUG_ENTER("rnd_next_batch");
+
+	int	error = rnd_next(buf);
+
+	if (error != 0) {
+		DBUG_RETURN(error);
+	}
+
+	*n_rows = 1;
+
+	if (m_prebuilt->select_lock_type != LOCK_NONE) {
+		DBUG_RETURN(0);
+	}
+
+	const ulint	rec_length = table->s->rec_buff_length;
+
+	while (*n_rows < max_rows) {
+
+		ha_statistic_increment(&SSV::ha_read_rnd_next_count);
+
+		error = general_fetch(
+			buf + *n_rows * rec_length, ROW_SEL_NEXT, 0);
+
+		if (error != 0) {
+			break;
+		}
+
+		++*n_rows;
+	}
+
+	DBUG_RETURN(error);
+}
+
 /**********************************************************************//**
 Fetches a row from the table based on a row reference.
 @return 0, HA_ERR_KEY_NOT_FOUND, or error code */
@@ -14406,8 +14459,15 @@ ha_innobase::records(
 	m_prebuilt->read_just_key = 1;
 	build_template(false);
 
-	/* Count the records in the clustered index */
-	ret = row_scan_index_for_mysql(m_prebuilt, index, false, &n_rows);
+	/* Count the records in parallel if possible, else in the
+	clustered index */
+	ret = row_count_rows_in_parallel(
+		m_prebuilt, srv_parallel_read_threads, &n_rows);
+
+	if (ret == DB_UNSUPPORTED) {
+		ret = row_scan_index_for_mysql(
+			m_prebuilt, index, false, &n_rows);
+	}
 	reset_template();
 	switch (ret) {
 	case DB_SUCCESS:
@@ -15175,6 +15235,10 @@ ha_innobase::info_low(
 
 		ut_a(ib_table->stat_initialized);
 
+		/* Whether the records per key estimates changed enough
+		for the optimizer to choose different plans. */
+		bool	stats_changed = false;
+
 		for (i = 0; i < table->s->keys; i++) {
 			ulong	j;
 			/* We could get index quickly through internal
@@ -15250,6 +15314,18 @@ ha_innobase::info_low(
 						index, j,
 						index->table->stat_n_rows);
 
+				/* The estimates drift a little with every
+				DML through stat_n_rows, so that only a
+				change by more than a factor of 2 counts. */
+				const rec_per_key_t	old_rec_per_key
+					= key->records_per_key(j);
+
+				if (old_rec_per_key != REC_PER_KEY_UNKNOWN
+				    && (rec_per_key > 2 * old_rec_per_key
+					|| old_rec_per_key > 2 * rec_per_key)) {
+					stats_changed = true;
+				}
+
 				key->set_records_per_key(j, rec_per_key);
 
 				/* The code below is legacy and should be
@@ -15280,6 +15356,10 @@ ha_innobase::info_low(
 			dict_table_stats_unlock(ib_table, RW_S_LATCH);
 		}
 
+		if (stats_changed) {
+			ha_statistics_changed();
+		}
+
 		my_snprintf(path, sizeof(path), "%s/%s%s",
 			    mysql_data_home, table->s->normalized_path.str,
 			    reg_ext);
@@ -17596,9 +17676,13 @@ ha_innobase::store_lock(
 		unexpected if an obsolete consistent read view would be
 		used. */
 
-		/* Use consistent read for checksum table */
+		/* Use consistent read for checksum table and for the
+		sampling scan of ANALYZE TABLE ... UPDATE HISTOGRAM, which
+		is the only ANALYZE TABLE that asks for TL_READ */
 
 		if (sql_command == SQLCOM_CHECKSUM
+		    || (sql_command == SQLCOM_ANALYZE
+			&& lock_type == TL_READ)
 		    || ((srv_locks_unsafe_for_binlog
 			|| trx->isolation_level <= TRX_ISO_READ_COMMITTED)
 			&& trx->isolation_level != TRX_ISO_SERIALIZABLE
@@ -20840,6 +20924,15 @@ static MYSQL_SYSVAR_ULONG(purge_batch_size, srv_purge_batch_size,
   1,			/* Minimum value */
   5000, 0);		/* Maximum value */
 
+static MYSQL_SYSVAR_ULONG(parallel_read_threads, srv_parallel_read_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of threads that scan an index for SELECT COUNT(*)"
+  " in parallel. 1 disables parallel scans.",
+  NULL, NULL,
+  4,			/* Default setting */
+  1,			/* Minimum value */
+  PARALLEL_READ_MAX_THREADS, 0);	/* Maximum value */
+
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Purge threads can be from 1 to 32. Default is 4.",
@@ -21524,6 +21617,25 @@ static MYSQL_SYSVAR_ULONGLONG(max_undo_log_size, srv_max_undo_log_size,
   10 * 1024 * 1024L,
   ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONGLONG(dict_size_limit, srv_dict_size_limit,
+  PLUGIN_VAR_OPCMDARG,
+  "Limit in bytes of the memory used by the data dictionary cache."
+  " Unused tables are evicted in the background when either this limit"
+  " or table_definition_cache is exceeded. 0 means no size limit.",
+  NULL, NULL,
+  0,		/* Default setting */
+  0,		/* Minimum value */
+  ~0ULL, 0);	/* Maximum value */
+
+static MYSQL_SYSVAR_ULONG(dict_lru_evict_batch, srv_dict_lru_evict_batch,
+  PLUGIN_VAR_OPCMDARG,
+  "Maximum number of tables evicted from the data dictionary cache"
+  " while holding the dictionary mutex once.",
+  NULL, NULL,
+  64,		/* Default setting */
+  1,		/* Minimum value */
+  ~0UL, 0);	/* Maximum value */
+
 static MYSQL_SYSVAR_ULONG(purge_rseg_truncate_frequency,
   srv_purge_rseg_truncate_frequency,
   PLUGIN_VAR_OPCMDARG,
@@ -21536,6 +21648,20 @@ static MYSQL_SYSVAR_BOOL(undo_log_truncate, srv_undo_log_truncate,
   "Enable or Disable Truncate of UNDO tablespace.",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_BOOL(temp_tablespace_punch_hole,
+  srv_temp_tablespace_punch_hole,
+  PLUGIN_VAR_OPCMDARG,
+  "Enable or Disable releasing the storage of free extents of the"
+  " temporary tablespace with punch hole, so that ibtmp1 does not keep"
+  " its peak size on disk until restart.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(undo_log_punch_hole, srv_undo_log_punch_hole,
+  PLUGIN_VAR_OPCMDARG,
+  "Enable or Disable releasing the storage of free extents of UNDO"
+  " tablespaces with punch hole while the tablespaces are in use.",
+  NULL, NULL, FALSE);
+
 /* Alias for innodb_undo_logs, this config variable is deprecated. */
 static MYSQL_SYSVAR_ULONG(rollback_segments, srv_rollback_segments,
   PLUGIN_VAR_OPCMDARG,
@@ -22008,6 +22134,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(monitor_reset_all),
   MYSQL_SYSVAR(purge_threads),
   MYSQL_SYSVAR(purge_batch_size),
+  MYSQL_SYSVAR(parallel_read_threads),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(background_drop_list_empty),
   MYSQL_SYSVAR(purge_run_now),
@@ -22039,8 +22166,12 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(cmp_per_index_enabled),
   MYSQL_SYSVAR(undo_logs),
   MYSQL_SYSVAR(max_undo_log_size),
+  MYSQL_SYSVAR(dict_size_limit),
+  MYSQL_SYSVAR(dict_lru_evict_batch),
   MYSQL_SYSVAR(purge_rseg_truncate_frequency),
   MYSQL_SYSVAR(undo_log_truncate),
+  MYSQL_SYSVAR(undo_log_punch_hole),
+  MYSQL_SYSVAR(temp_tablespace_punch_hole),
   MYSQL_SYSVAR(rollback_segments),
   MYSQL_SYSVAR(undo_directory),
   MYSQL_SYSVAR(undo_tablespaces),
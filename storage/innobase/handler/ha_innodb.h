@@ -166,6 +166,8 @@ public:
 
 	int rnd_next(uchar *buf);
 
+	int rnd_next_batch(uchar* buf, uint max_rows, uint* n_rows);
+
 	int rnd_pos(uchar * buf, uchar *pos);
 
 	int ft_init();
@@ -35,7 +35,8 @@ const handler::Table_flags	HA_INNOPART_DISABLED_TABLE_FLAGS =
 	| HA_CAN_FULLTEXT_EXT
 	| HA_CAN_GEOMETRY
 	| HA_DUPLICATE_POS
-	| HA_READ_BEFORE_WRITE_REMOVAL);
+	| HA_READ_BEFORE_WRITE_REMOVAL
+	| HA_CAN_READ_BATCH);
 
 /** InnoDB partition specific Handler_share. */
 class Ha_innopart_share : public Partition_share
@@ -1228,6 +1229,15 @@ protected:
 		return(Partition_helper::ph_rnd_next(record));
 	}
 
+	int
+	rnd_next_batch(
+		uchar*	buf,
+		uint	max_rows,
+		uint*	n_rows)
+	{
+		return(handler::rnd_next_batch(buf, max_rows, n_rows));
+	}
+
 	int
 	rnd_pos(
 		uchar*	record,
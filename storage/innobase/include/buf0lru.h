@@ -63,6 +63,22 @@ buf_LRU_flush_or_remove_pages(
 	const trx_t*	trx);		/*!< to check if the operation must
 					be interrupted */
 
+/** Discard the pages of a range of a tablespace from the buffer pool
+without writing them, before the storage of the range is released. The
+pages must belong to free extents, so that no thread latches them or
+allocates them meanwhile.
+@param[in]	space_id	tablespace identifier
+@param[in]	first		first page number of the range
+@param[in]	n_pages		number of pages in the range
+@return false if a page could not be discarded because it is still
+buffer-fixed or I/O-fixed, e.g. by a flush that started before the page
+was freed */
+bool
+buf_LRU_discard_page_range(
+	ulint	space_id,
+	ulint	first,
+	ulint	n_pages);
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 /********************************************************************//**
 Insert a compressed block into buf_pool->zip_clean in the LRU order. */
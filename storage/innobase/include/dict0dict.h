@@ -1108,7 +1108,7 @@ dict_index_find_on_id_low(
 	index_id_t	id)	/*!< in: index id */
 	MY_ATTRIBUTE((warn_unused_result));
 /**********************************************************************//**
-Make room in the table cache by evicting an unused table. The unused table
+Make room in the table cache by evicting unused tables. The unused tables
 should not be part of FK relationship and currently not used in any user
 transaction. There is no guarantee that it will remove a table.
 @return number of tables evicted. */
@@ -1116,6 +1116,11 @@ ulint
 dict_make_room_in_cache(
 /*====================*/
 	ulint		max_tables,	/*!< in: max tables allowed in cache */
+	ulint		max_size,	/*!< in: max bytes of dictionary
+					objects allowed in cache, or 0 for
+					no size limit */
+	ulint		max_evict,	/*!< in: max tables to evict in
+					this call */
 	ulint		pct_check);	/*!< in: max percent to check */
 
 #define BIG_ROW_SIZE	1024
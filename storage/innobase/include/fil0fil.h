@@ -199,6 +199,14 @@ struct fil_space_t {
 				Dropping of the tablespace is forbidden
 				if this is positive.
 				Protected by fil_system->mutex. */
+	ulint		reclaim_page_no;
+				/*!< first page of the range whose free
+				extents fsp_reclaim_free_extents() is
+				releasing; see fil_space_set_reclaim_range().
+				Protected by fil_system->mutex. */
+	ulint		reclaim_n_pages;
+				/*!< number of pages in that range, 0 if
+				none. Protected by fil_system->mutex. */
 	hash_node_t	hash;	/*!< hash chain node */
 	hash_node_t	name_hash;/*!< hash chain the name_hash table */
 #ifndef UNIV_HOTBACKUP
@@ -1200,6 +1208,28 @@ fil_space_get_n_reserved_extents(
 /*=============================*/
 	ulint	id);		/*!< in: space id */
 
+/** Keep the extents of a range of pages from being allocated while
+fsp_reclaim_free_extents() releases their storage without holding the
+tablespace latch. The range must be set while holding the latch.
+@param[in]	id		tablespace identifier
+@param[in]	page_no		first page of the range
+@param[in]	n_pages		number of pages in the range, or 0 to let
+				the extents be allocated again */
+void
+fil_space_set_reclaim_range(
+	ulint	id,
+	ulint	page_no,
+	ulint	n_pages);
+
+/** Check whether the storage of a page is being released.
+@param[in]	id		tablespace identifier
+@param[in]	page_no		page number
+@return true if the page is in the range of fil_space_set_reclaim_range() */
+bool
+fil_space_is_being_reclaimed(
+	ulint	id,
+	ulint	page_no);
+
 /** Reads or writes data. This operation could be asynchronous (aio).
 
 @param[in]	type		IO context
@@ -1673,6 +1703,22 @@ fil_fusionio_enable_atomic_write(pfs_os_file_t file);
 @param[in,out]	node		Node to set */
 void fil_no_punch_hole(fil_node_t* node);
 
+#ifndef UNIV_HOTBACKUP
+/** Release the storage of a range of pages of a single-file tablespace by
+punching a hole in its data file. The pages must not be in use.
+Tablespaces that consist of several files are not supported.
+@param[in]	space_id	tablespace identifier
+@param[in]	page_no		first page of the range
+@param[in]	n_pages		number of pages in the range
+@return DB_SUCCESS or error code */
+dberr_t
+fil_punch_hole_pages(
+	ulint	space_id,
+	ulint	page_no,
+	ulint	n_pages)
+	MY_ATTRIBUTE((warn_unused_result));
+#endif /* !UNIV_HOTBACKUP */
+
 #ifdef UNIV_ENABLE_UNIT_TEST_MAKE_FILEPATH
 void test_make_filepath();
 #endif /* UNIV_ENABLE_UNIT_TEST_MAKE_FILEPATH */
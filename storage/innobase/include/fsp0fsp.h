@@ -556,6 +556,24 @@ uintmax_t
 fsp_get_available_space_in_free_extents(
 	const fil_space_t*	space);
 
+/** Release the storage of the free extents of a tablespace by punching
+holes in its data file. The size of the tablespace does not change.
+@param[in]	space_id	tablespace identifier
+@param[in]	lsn_start	descriptor pages modified before this LSN
+				were examined by an earlier call
+@param[in]	lsn_limit	checkpoint LSN, or LSN_MAX for the
+				temporary tablespace
+@param[out]	n_released	number of extents whose storage was
+				released
+@return DB_SUCCESS if every descriptor page in [lsn_start, lsn_limit)
+was examined, so that the next pass may start at lsn_limit */
+dberr_t
+fsp_reclaim_free_extents(
+	ulint	space_id,
+	lsn_t	lsn_start,
+	lsn_t	lsn_limit,
+	ulint*	n_released);
+
 /**********************************************************************//**
 Frees a single page of a segment. */
 void
@@ -659,6 +659,21 @@ row_scan_index_for_mysql(
 	ulint*			n_rows)		/*!< out: number of entries
 						seen in the consistent read */
 	MY_ATTRIBUTE((warn_unused_result));
+
+/** Counts the rows of a table in the read view of the transaction for
+COUNT(*), scanning key ranges of an index in parallel.
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@param[in]	n_threads	maximum number of threads to use
+@param[out]	n_rows		number of records seen in the read view
+@return DB_SUCCESS, DB_INTERRUPTED or DB_UNSUPPORTED if the records
+cannot be counted in parallel, in which case the caller has to use
+row_scan_index_for_mysql() */
+dberr_t
+row_count_rows_in_parallel(
+	row_prebuilt_t*	prebuilt,
+	ulint		n_threads,
+	ulint*		n_rows)
+	MY_ATTRIBUTE((warn_unused_result));
 /*********************************************************************//**
 Initialize this module */
 void
@@ -0,0 +1,224 @@
+/*****************************************************************************
+
+Copyright (c) 2018, Percona Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel scan of an index in a consistent read view.
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "data0types.h"
+#include "dict0types.h"
+#include "mem0mem.h"
+#include "os0event.h"
+#include "os0thread.h"
+#include "read0types.h"
+#include "rem0types.h"
+#include "trx0types.h"
+#include "ut0new.h"
+
+#include <vector>
+
+/** Maximum number of threads of one parallel scan, and of the worker
+threads of all parallel scans together */
+#define PARALLEL_READ_MAX_THREADS	256
+
+#ifdef UNIV_PFS_THREAD
+extern mysql_pfs_key_t	parallel_read_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** Scans the user records of an index, as seen by a consistent read view,
+with several threads.
+
+The index is split into key ranges at the node pointers of the highest
+B-tree level that has enough of them to keep all threads busy. The
+threads take ranges from a shared counter until all ranges are scanned,
+so that a thread that got small subtrees takes more of them.
+
+In a secondary index, the records of a leaf page whose PAGE_MAX_TRX_ID
+the read view sees are all visible as they are. A visitor that only
+needs the number of records gets them counted page by page; other
+records are checked against the clustered index. */
+class Parallel_reader {
+public:
+	/** Callback for the records of a scan. The same object is called
+	by all threads of the scan at the same time. */
+	class Visitor {
+	public:
+		virtual ~Visitor() {}
+
+		/** Processes a record that is visible in the read view and
+		not delete-marked.
+		@param[in]	thread_no	number of the calling thread,
+						less than the number of threads
+						the reader was created with
+		@param[in]	rec		the record
+		@param[in]	offsets		rec_get_offsets(rec, index)
+		@return DB_SUCCESS, or an error that stops the scan */
+		virtual dberr_t visit(
+			ulint		thread_no,
+			const rec_t*	rec,
+			const ulint*	offsets) = 0;
+
+		/** @return whether visit() needs the records, rather than
+		only how many there are */
+		virtual bool needs_records() const
+		{
+			return(true);
+		}
+
+		/** Adds records that are visible and not delete-marked,
+		without passing them one by one. Called only if
+		needs_records() returns false.
+		@param[in]	thread_no	number of the calling thread
+		@param[in]	n_recs		number of records */
+		virtual void visit_count(
+			ulint	thread_no MY_ATTRIBUTE((unused)),
+			ulint	n_recs MY_ATTRIBUTE((unused)))
+		{
+			ut_error;
+		}
+	};
+
+	/** Constructor.
+	@param[in]	index		index to scan; a secondary index must
+					not have virtual columns
+	@param[in]	trx		transaction whose read view is used;
+					it must have one
+	@param[in]	n_threads	maximum number of threads to use */
+	Parallel_reader(
+		dict_index_t*	index,
+		trx_t*		trx,
+		ulint		n_threads);
+
+	~Parallel_reader();
+
+	/** Scans the index, calling the visitor for every visible record.
+	Records of one range are visited in index order, but the ranges are
+	visited in no particular order.
+	@param[in,out]	visitor		record callback
+	@return DB_SUCCESS, DB_INTERRUPTED, or the first error returned by
+	the visitor */
+	dberr_t run(Visitor* visitor);
+
+private:
+	/** A worker thread of the scan */
+	struct Worker {
+		Parallel_reader*	reader;
+		ulint			thread_no;
+		my_thread_handle	handle;
+		dberr_t			err;
+	};
+
+	/** Stops the scan in all threads. */
+	void stop()
+	{
+		os_compare_and_swap_ulint(&m_stop, 0, 1);
+	}
+
+	/** @return whether some thread has stopped the scan */
+	bool is_stopped() const
+	{
+		os_rmb;
+		return(m_stop != 0);
+	}
+
+	/** Splits the index into key ranges, filling m_bounds. */
+	void split();
+
+	/** Scans ranges until there are none left or the scan stops.
+	@param[in]	thread_no	number of the calling thread
+	@return DB_SUCCESS or error code */
+	dberr_t scan_ranges(ulint thread_no);
+
+	/** Scans the range [m_bounds[range], m_bounds[range + 1]).
+	@param[in]	thread_no	number of the calling thread
+	@param[in]	range		range number
+	@return DB_SUCCESS or error code */
+	dberr_t scan_range(ulint thread_no, ulint range);
+
+	/** Counts the records of a secondary index leaf page at once if
+	they all lie before end and are settled by PAGE_MAX_TRX_ID.
+	@param[in]	thread_no	number of the calling thread
+	@param[in]	rec		first user record on the page
+	@param[in]	end		end of the range, or NULL
+	@param[in,out]	heap		memory heap
+	@return whether the page was counted */
+	bool count_page(
+		ulint		thread_no,
+		const rec_t*	rec,
+		const dtuple_t*	end,
+		mem_heap_t*	heap);
+
+	/** Checks a secondary index record whose page the read view does
+	not see entirely against the clustered index.
+	@param[in]	rec		secondary index record
+	@param[in,out]	heap		memory heap
+	@return whether the record is visible and not delete-marked */
+	bool sec_rec_is_visible(const rec_t* rec, mem_heap_t* heap);
+
+	/** Thread function of the workers other than the first one */
+	static void* worker_thread(void* arg);
+
+	typedef std::vector<dtuple_t*, ut_allocator<dtuple_t*> > bounds_t;
+
+	/** Index to scan */
+	dict_index_t*		m_index;
+
+	/** Transaction of the caller */
+	trx_t*			m_trx;
+
+	/** Read view of the scan */
+	ReadView*		m_view;
+
+	/** Maximum number of threads */
+	ulint			m_n_threads;
+
+	/** Range i is [m_bounds[i], m_bounds[i + 1]); NULL bounds stand
+	for the ends of the index */
+	bounds_t		m_bounds;
+
+	/** Memory for the bounds */
+	mem_heap_t*		m_heap;
+
+	/** Visitor of the current scan */
+	Visitor*		m_visitor;
+
+	/** Number of ranges handed out to threads so far */
+	ulint			m_next_range;
+
+	/** Non-zero when a thread fails, to stop the other ones; set with
+	stop() and read with is_stopped() */
+	volatile ulint		m_stop;
+
+	/** Number of threads that still use this object: the calling
+	thread and the running workers of the current scan */
+	volatile ulint		m_n_running;
+
+	/** Set by the thread that drops m_n_running to 0 */
+	os_event_t		m_done;
+
+	// Disable copying
+	Parallel_reader(const Parallel_reader&);
+	Parallel_reader& operator=(const Parallel_reader&);
+};
+
+#endif /* row0pread_h */
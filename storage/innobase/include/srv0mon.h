@@ -307,6 +307,7 @@ enum monitor_id_t {
 	MONITOR_DML_PURGE_DELAY,
 	MONITOR_PURGE_STOP_COUNT,
 	MONITOR_PURGE_RESUME_COUNT,
+	MONITOR_UNDO_EXTENTS_RECLAIMED,
 
 	/* Recovery related counters */
 	MONITOR_MODULE_RECOVERY,
@@ -381,6 +382,7 @@ enum monitor_id_t {
 	MONITOR_SRV_PURGE_MICROSECOND,
 	MONITOR_SRV_DICT_LRU_MICROSECOND,
 	MONITOR_SRV_DICT_LRU_EVICT_COUNT,
+	MONITOR_SRV_TMP_SPACE_RECLAIM_COUNT,
 	MONITOR_SRV_CHECKPOINT_MICROSECOND,
 	MONITOR_OVLD_SRV_DBLWR_WRITES,
 	MONITOR_OVLD_SRV_DBLWR_PAGES_WRITTEN,
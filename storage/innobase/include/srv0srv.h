@@ -291,12 +291,28 @@ extern const char* deprecated_undo_logs;
 /** Maximum size of undo tablespace. */
 extern unsigned long long	srv_max_undo_log_size;
 
+/** Maximum size in bytes of the evictable data dictionary cache,
+or 0 if the cache is bounded only by table_definition_cache. */
+extern unsigned long long	srv_dict_size_limit;
+
+/** Maximum number of tables evicted from the data dictionary cache
+while holding dict_sys->mutex once. */
+extern ulong	srv_dict_lru_evict_batch;
+
 /** Rate at which UNDO records should be purged. */
 extern ulong	srv_purge_rseg_truncate_frequency;
 
 /** Enable or Disable Truncate of UNDO tablespace. */
 extern my_bool	srv_undo_log_truncate;
 
+/** Enable or disable releasing the storage of free extents of UNDO
+tablespaces with punch hole. */
+extern my_bool	srv_undo_log_punch_hole;
+
+/** Enable or disable releasing the storage of free extents of the
+temporary tablespace with punch hole. */
+extern my_bool	srv_temp_tablespace_punch_hole;
+
 /** UNDO logs not redo logged, these logs reside in the temp tablespace.*/
 extern const ulong	srv_tmp_undo_logs;
 
@@ -577,6 +593,9 @@ extern ulong srv_n_purge_threads;
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/** Maximum number of threads of a parallel index scan */
+extern ulong srv_parallel_read_threads;
+
 /* the number of sync wait arrays */
 extern ulong srv_sync_array_size;
 
@@ -462,6 +462,11 @@ struct trx_purge_t{
 
 	undo::Truncate	undo_trunc;	/*!< Track UNDO tablespace marked
 					for truncate. */
+	lsn_t		undo_reclaim_lsn;
+					/*!< Checkpoint LSN up to which the
+					free extents of the UNDO tablespaces
+					have been released, see
+					fsp_reclaim_free_extents() */
 };
 
 /** Info required to purge a record */
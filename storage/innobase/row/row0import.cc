@@ -48,11 +48,12 @@ Created 2012-02-08 by Sunny Bains.
 #include <my_aes.h>
 
 /** The size of the buffer to use for IO. Note: os_file_read() doesn't expect
-reads to fail. If you set the buffer size to be greater than a multiple of the
-file size then it will assert. TODO: Fix this limitation of the IO functions.
-@param n page size of the tablespace.
+reads to fail, fil_iterate() therefore trims the last read to the end of
+the file. Reading and writing the tablespace in large sequential chunks
+instead of page by page keeps the import bound by the disk bandwidth.
+@param n physical page size of the tablespace.
 @retval number of pages */
-#define IO_BUFFER_SIZE(m, n)	((m) / (n))
+#define IO_BUFFER_SIZE(n)	((1024 * 1024) / (n))
 
 /** For gathering stats on records during phase I */
 struct row_stats_t {
@@ -3664,9 +3665,7 @@ row_import_for_mysql(
 		FetchIndexRootPages	fetchIndexRootPages(table, trx);
 
 		err = fil_tablespace_iterate(
-			table, IO_BUFFER_SIZE(
-				cfg.m_page_size.physical(),
-				cfg.m_page_size.physical()),
+			table, IO_BUFFER_SIZE(cfg.m_page_size.physical()),
 			fetchIndexRootPages);
 
 		if (err == DB_SUCCESS) {
@@ -3737,9 +3736,7 @@ row_import_for_mysql(
 	/* Set the IO buffer size in pages. */
 
 	err = fil_tablespace_iterate(
-		table, IO_BUFFER_SIZE(
-			cfg.m_page_size.physical(),
-			cfg.m_page_size.physical()), converter);
+		table, IO_BUFFER_SIZE(cfg.m_page_size.physical()), converter);
 
 	DBUG_EXECUTE_IF("ib_import_reset_space_and_lsn_failure",
 			err = DB_TOO_MANY_CONCURRENT_TRXS;);
@@ -63,6 +63,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "row0import.h"
 #include "row0ins.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "row0row.h"
 #include "row0sel.h"
 #include "row0upd.h"
@@ -72,6 +73,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "trx0roll.h"
 #include "trx0undo.h"
 #include "row0ext.h"
+#include "ut0counter.h"
 #include "ut0new.h"
 #include "zlib.h"
 #include <algorithm>
@@ -6533,6 +6535,142 @@ next_rec:
 	goto loop;
 }
 
+/** Counts the visible records of a parallel scan, one counter per thread
+in a cache line of its own. */
+class Parallel_row_counter : public Parallel_reader::Visitor {
+public:
+	explicit Parallel_row_counter(ulint n_threads)
+		:
+		m_counts(n_threads)
+	{}
+
+	dberr_t visit(
+		ulint		thread_no,
+		const rec_t*	rec MY_ATTRIBUTE((unused)),
+		const ulint*	offsets MY_ATTRIBUTE((unused)))
+	{
+		++m_counts[thread_no].n;
+
+		return(DB_SUCCESS);
+	}
+
+	bool needs_records() const
+	{
+		return(false);
+	}
+
+	void visit_count(ulint thread_no, ulint n_recs)
+	{
+		m_counts[thread_no].n += n_recs;
+	}
+
+	/** @return number of records visited by all threads */
+	ulint total() const
+	{
+		ulint	n = 0;
+
+		for (ulint i = 0; i < m_counts.size(); ++i) {
+			n += m_counts[i].n;
+		}
+
+		return(n);
+	}
+
+private:
+	struct Count {
+		Count() : n(0) {}
+
+		ulint	n;
+		byte	pad[CACHE_LINE_SIZE - sizeof(ulint)];
+	};
+
+	std::vector<Count, ut_allocator<Count> >	m_counts;
+};
+
+/** Picks the index to count the rows of a table with: the smallest
+secondary index that can be read in parallel, because most of its leaf
+pages can be counted without looking at the records, or else the
+clustered index.
+@param[in]	trx	transaction with a read view
+@param[in]	table	table
+@return index */
+static
+dict_index_t*
+row_count_rows_choose_index(
+	trx_t*		trx,
+	dict_table_t*	table)
+{
+	dict_index_t*	clust_index = dict_table_get_first_index(table);
+	dict_index_t*	best = NULL;
+
+	for (dict_index_t* index = dict_table_get_next_index(clust_index);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (dict_index_is_spatial(index)
+		    || (index->type & DICT_FTS)
+		    || dict_index_has_virtual(index)
+		    || dict_index_is_online_ddl(index)
+		    || dict_index_is_corrupted(index)
+		    || !row_merge_is_index_usable(trx, index)) {
+			continue;
+		}
+
+		if (best == NULL
+		    || index->stat_index_size < best->stat_index_size) {
+			best = index;
+		}
+	}
+
+	return(best != NULL ? best : clust_index);
+}
+
+/** Counts the rows of a table in the read view of the transaction for
+COUNT(*), scanning key ranges of an index in parallel.
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@param[in]	n_threads	maximum number of threads to use
+@param[out]	n_rows		number of records seen in the read view
+@return DB_SUCCESS, DB_INTERRUPTED or DB_UNSUPPORTED if the records
+cannot be counted in parallel, in which case the caller has to use
+row_scan_index_for_mysql() */
+dberr_t
+row_count_rows_in_parallel(
+	row_prebuilt_t*	prebuilt,
+	ulint		n_threads,
+	ulint*		n_rows)
+{
+	trx_t*		trx = prebuilt->trx;
+
+	*n_rows = 0;
+
+	/* Only a plain consistent read can share its read view among
+	threads; locking reads and READ UNCOMMITTED go row by row. */
+	if (n_threads <= 1
+	    || srv_read_only_mode
+	    || prebuilt->select_lock_type != LOCK_NONE
+	    || trx->isolation_level == TRX_ISO_READ_UNCOMMITTED
+	    || dict_table_is_temporary(prebuilt->table)) {
+		return(DB_UNSUPPORTED);
+	}
+
+	trx_start_if_not_started(trx, false);
+	trx_assign_read_view(trx);
+
+	dict_index_t*	index = row_count_rows_choose_index(
+		trx, prebuilt->table);
+
+	Parallel_row_counter	counter(n_threads);
+	Parallel_reader		reader(index, trx, n_threads);
+
+	dberr_t	err = reader.run(&counter);
+
+	if (err == DB_SUCCESS) {
+		*n_rows = counter.total();
+	}
+
+	return(err);
+}
+
 /*********************************************************************//**
 Initialize this module */
 void
@@ -0,0 +1,575 @@
+/*****************************************************************************
+
+Copyright (c) 2018, Percona Inc. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel scan of an index in a consistent read view.
+*******************************************************/
+
+#include "ha_prototypes.h"
+
+#include "row0pread.h"
+
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "lock0lock.h"
+#include "os0atomic.h"
+#include "read0read.h"
+#include "rem0cmp.h"
+#include "row0row.h"
+#include "row0sel.h"
+#include "row0vers.h"
+#include "trx0trx.h"
+
+#include <my_thread.h>
+
+/** Number of key ranges to aim at per thread, so that a thread that got
+small subtrees can take more of them */
+static const ulint	PARALLEL_READ_RANGES_PER_THREAD = 4;
+
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	parallel_read_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** Number of worker threads of all parallel scans, which is kept within
+PARALLEL_READ_MAX_THREADS */
+static volatile ulint	parallel_read_n_workers = 0;
+
+/** Reserves worker threads within the limit for all parallel scans.
+@param[in]	n	number of threads wanted
+@return number of threads reserved, at most n */
+static
+ulint
+parallel_read_reserve_workers(
+	ulint	n)
+{
+	for (;;) {
+		const ulint	n_workers = parallel_read_n_workers;
+
+		if (n_workers >= PARALLEL_READ_MAX_THREADS) {
+			return(0);
+		}
+
+		const ulint	n_reserve = ut_min(
+			n, PARALLEL_READ_MAX_THREADS - n_workers);
+
+		if (n_reserve == 0
+		    || os_compare_and_swap_ulint(&parallel_read_n_workers,
+						 n_workers,
+						 n_workers + n_reserve)) {
+			return(n_reserve);
+		}
+	}
+}
+
+/** Number of records after which a scan releases its page latches even
+if it is still on the same page */
+static const ulint	PARALLEL_READ_RECS_PER_MTR = 100;
+
+/** Moves a scan to the next user record. Before the scan leaves a page, and
+at least every PARALLEL_READ_RECS_PER_MTR records, the position is stored
+and the mini-transaction committed, so that page latches are not held for
+long and the memo of the mini-transaction does not grow with every page.
+@param[in,out]	pcur		persistent cursor on a user record
+@param[in,out]	n_recs		records processed in this mini-transaction
+@param[in,out]	mtr		mini-transaction
+@return whether the cursor is on a user record */
+static
+bool
+parallel_read_move_to_next(
+	btr_pcur_t*	pcur,
+	ulint*		n_recs,
+	mtr_t*		mtr)
+{
+	ut_ad(btr_pcur_is_on_user_rec(pcur));
+
+	if (++*n_recs >= PARALLEL_READ_RECS_PER_MTR
+	    || page_rec_is_supremum(page_rec_get_next_const(
+			btr_pcur_get_rec(pcur)))) {
+
+		/* As in row_search_mvcc(), the cursor is restored to the
+		record it is on, or to the one before if that was purged, and
+		then moved forward. */
+		btr_pcur_store_position(pcur, mtr);
+		mtr_commit(mtr);
+		mtr_start(mtr);
+		btr_pcur_restore_position(BTR_SEARCH_LEAF, pcur, mtr);
+		*n_recs = 0;
+	}
+
+	return(btr_pcur_move_to_next_user_rec(pcur, mtr));
+}
+
+/** Constructor.
+@param[in]	index		index to scan; a secondary index must
+				not have virtual columns
+@param[in]	trx		transaction whose read view is used;
+				it must have one
+@param[in]	n_threads	maximum number of threads to use */
+Parallel_reader::Parallel_reader(
+	dict_index_t*	index,
+	trx_t*		trx,
+	ulint		n_threads)
+	:
+	m_index(index),
+	m_trx(trx),
+	m_view(trx->read_view),
+	m_n_threads(ut_max(ut_min(n_threads,
+				  ulint(PARALLEL_READ_MAX_THREADS)),
+			   ulint(1))),
+	m_heap(mem_heap_create(1024)),
+	m_visitor(NULL),
+	m_next_range(0),
+	m_stop(0),
+	m_n_running(0),
+	m_done(os_event_create(0))
+{
+	ut_ad(dict_index_is_clust(index) || !dict_index_has_virtual(index));
+	ut_ad(!dict_index_is_spatial(index));
+	ut_ad(MVCC::is_view_active(m_view));
+}
+
+Parallel_reader::~Parallel_reader()
+{
+	ut_ad(m_n_running == 0);
+	os_event_destroy(m_done);
+	mem_heap_free(m_heap);
+}
+
+/** Splits the index into key ranges, filling m_bounds. */
+void
+Parallel_reader::split()
+{
+	const ulint	target = m_n_threads * PARALLEL_READ_RANGES_PER_THREAD;
+	const ulint	n_fields = dict_index_get_n_unique_in_tree(m_index);
+	const bool	comp = dict_table_is_comp(m_index->table);
+	ulint		level = ULINT_UNDEFINED;
+	mtr_t		mtr;
+
+	m_bounds.clear();
+	m_bounds.push_back(NULL);
+
+	/* Walk down from the root until a level has enough node pointers.
+	The first node pointer of every level has the minimum record flag
+	and starts the first range, which has no lower bound. */
+	while (m_n_threads > 1) {
+		mtr_start(&mtr);
+		mtr_sx_lock(dict_index_get_lock(m_index), &mtr);
+
+		/* The tree may have changed since the last level. */
+		level = ut_min(level, btr_height_get(m_index, &mtr));
+
+		if (level == 0) {
+			mtr_commit(&mtr);
+			break;
+		}
+
+		mem_heap_empty(m_heap);
+		m_bounds.resize(1);
+
+		btr_pcur_t	pcur;
+
+		btr_pcur_open_at_index_side(
+			true, m_index, BTR_SEARCH_TREE | BTR_ALREADY_S_LATCHED,
+			&pcur, true, level, &mtr);
+		btr_pcur_move_to_next_on_page(&pcur);
+
+		for (; btr_pcur_is_on_user_rec(&pcur);
+		     btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+
+			rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+			if (rec_get_info_bits(rec, comp)
+			    & REC_INFO_MIN_REC_FLAG) {
+				continue;
+			}
+
+			dtuple_t*	tuple = dict_index_build_data_tuple(
+				m_index, rec, n_fields, m_heap);
+
+			/* The tuple points into the page; copy it. */
+			for (ulint i = 0; i < n_fields; ++i) {
+				dfield_dup(dtuple_get_nth_field(tuple, i),
+					   m_heap);
+			}
+
+			m_bounds.push_back(tuple);
+		}
+
+		btr_pcur_close(&pcur);
+		mtr_commit(&mtr);
+
+		if (m_bounds.size() >= target || level == 1) {
+			break;
+		}
+
+		--level;
+	}
+
+	m_bounds.push_back(NULL);
+}
+
+/** Counts the records of a secondary index leaf page at once if
+they all lie before end and are settled by PAGE_MAX_TRX_ID.
+@param[in]	thread_no	number of the calling thread
+@param[in]	rec		first user record on the page
+@param[in]	end		end of the range, or NULL
+@param[in,out]	heap		memory heap
+@return whether the page was counted */
+bool
+Parallel_reader::count_page(
+	ulint		thread_no,
+	const rec_t*	rec,
+	const dtuple_t*	end,
+	mem_heap_t*	heap)
+{
+	const page_t*	page = page_align(rec);
+	const bool	comp = page_is_comp(page);
+
+	/* Every change to the records of a secondary index page raises
+	PAGE_MAX_TRX_ID, delete-marking included. */
+	if (!m_view->sees(page_get_max_trx_id(page))) {
+		return(false);
+	}
+
+	if (end != NULL) {
+		const rec_t*	last = page_rec_get_prev_const(
+			page_get_supremum_rec(page));
+		const ulint*	offsets = rec_get_offsets(
+			last, m_index, NULL, ULINT_UNDEFINED, &heap);
+
+		if (cmp_dtuple_rec(end, last, offsets) <= 0) {
+			return(false);
+		}
+	}
+
+	ulint	n_recs = 0;
+
+	for (; !page_rec_is_supremum(rec); rec = page_rec_get_next_const(rec)) {
+		if (!rec_get_deleted_flag(rec, comp)) {
+			++n_recs;
+		}
+	}
+
+	m_visitor->visit_count(thread_no, n_recs);
+
+	return(true);
+}
+
+/** Checks a secondary index record whose page the read view does
+not see entirely against the clustered index.
+@param[in]	rec		secondary index record
+@param[in,out]	heap		memory heap
+@return whether the record is visible and not delete-marked */
+bool
+Parallel_reader::sec_rec_is_visible(
+	const rec_t*	rec,
+	mem_heap_t*	heap)
+{
+	dict_index_t*	clust_index = dict_table_get_first_index(
+		m_index->table);
+	const bool	comp = dict_table_is_comp(m_index->table);
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	bool		visible = false;
+
+	const dtuple_t*	ref = row_build_row_ref(
+		ROW_COPY_POINTERS, m_index, rec, heap);
+
+	/* The secondary index page stays latched by the caller, which is
+	the same latching order as in row_search_mvcc(). */
+	mtr_start(&mtr);
+
+	btr_pcur_open(clust_index, ref, PAGE_CUR_LE, BTR_SEARCH_LEAF,
+		      &pcur, &mtr);
+
+	const rec_t*	clust_rec = btr_pcur_get_rec(&pcur);
+
+	if (page_rec_is_user_rec(clust_rec)
+	    && btr_pcur_get_low_match(&pcur)
+	       >= dict_index_get_n_unique(clust_index)) {
+
+		ulint*	offsets = rec_get_offsets(
+			clust_rec, clust_index, NULL, ULINT_UNDEFINED, &heap);
+
+		if (!m_view->changes_visible(
+			    row_get_rec_trx_id(clust_rec, clust_index, offsets),
+			    m_index->table->name)) {
+
+			rec_t*	old_vers;
+
+			row_vers_build_for_consistent_read(
+				clust_rec, &mtr, clust_index, &offsets,
+				m_view, &heap, heap, &old_vers, NULL);
+
+			clust_rec = old_vers;
+		}
+
+		/* The record must be for the visible version of the row,
+		not for an older or newer value of its columns. */
+		visible = clust_rec != NULL
+			&& !rec_get_deleted_flag(clust_rec, comp)
+			&& row_sel_sec_rec_is_for_clust_rec(
+				rec, m_index, clust_rec, clust_index, NULL);
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	return(visible);
+}
+
+/** Scans the range [m_bounds[range], m_bounds[range + 1]).
+@param[in]	thread_no	number of the calling thread
+@param[in]	range		range number
+@return DB_SUCCESS or error code */
+dberr_t
+Parallel_reader::scan_range(
+	ulint	thread_no,
+	ulint	range)
+{
+	const dtuple_t*	start = m_bounds[range];
+	const dtuple_t*	end = m_bounds[range + 1];
+	const bool	comp = dict_table_is_comp(m_index->table);
+	const bool	clust = dict_index_is_clust(m_index);
+	const bool	count_pages = !clust && !m_visitor->needs_records();
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE / 4);
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	dberr_t		err = DB_SUCCESS;
+	ulint		cnt = 1000;
+	ulint		n_recs = 0;
+
+	rec_offs_init(offsets_);
+
+	mtr_start(&mtr);
+
+	if (start == NULL) {
+		btr_pcur_open_at_index_side(
+			true, m_index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	} else {
+		btr_pcur_open(m_index, start, PAGE_CUR_GE, BTR_SEARCH_LEAF,
+			      &pcur, &mtr);
+	}
+
+	for (bool on_rec = btr_pcur_is_on_user_rec(&pcur)
+		     || btr_pcur_move_to_next_user_rec(&pcur, &mtr);
+	     on_rec && !is_stopped();
+	     on_rec = parallel_read_move_to_next(&pcur, &n_recs, &mtr)) {
+
+		/* Check thd->killed every 1,000 scanned rows */
+		if (--cnt == 0) {
+			if (trx_is_interrupted(m_trx)) {
+				err = DB_INTERRUPTED;
+				break;
+			}
+			cnt = 1000;
+		}
+
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+		mem_heap_empty(heap);
+
+		if (count_pages
+		    && page_rec_is_infimum(page_rec_get_prev_const(rec))
+		    && count_page(thread_no, rec, end, heap)) {
+
+			/* Continue on the next page, from the last user
+			record of this one. */
+			btr_pcur_move_to_last_on_page(&pcur, &mtr);
+			btr_pcur_move_to_prev_on_page(&pcur);
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, m_index, offsets_,
+					  ULINT_UNDEFINED, &heap);
+
+		if (end != NULL && cmp_dtuple_rec(end, rec, offsets) <= 0) {
+			break;
+		}
+
+		if (!clust) {
+			/* A delete-marked record may still be visible in
+			the read view if the delete-marking is newer than
+			the view, so the delete-mark alone settles it only
+			when the view sees the whole page, as in
+			row_search_mvcc(). */
+			if (lock_sec_rec_cons_read_sees(rec, m_index, m_view)
+			    ? rec_get_deleted_flag(rec, comp)
+			    : !sec_rec_is_visible(rec, heap)) {
+				continue;
+			}
+		} else {
+			if (!m_view->changes_visible(
+				    row_get_rec_trx_id(rec, m_index, offsets),
+				    m_index->table->name)) {
+
+				rec_t*	old_vers;
+
+				row_vers_build_for_consistent_read(
+					rec, &mtr, m_index, &offsets, m_view,
+					&heap, heap, &old_vers, NULL);
+
+				if (old_vers == NULL) {
+					continue;
+				}
+
+				rec = old_vers;
+			}
+
+			if (rec_get_deleted_flag(rec, comp)) {
+				continue;
+			}
+		}
+
+		err = m_visitor->visit(thread_no, rec, offsets);
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+	mem_heap_free(heap);
+
+	return(err);
+}
+
+/** Scans ranges until there are none left or the scan stops.
+@param[in]	thread_no	number of the calling thread
+@return DB_SUCCESS or error code */
+dberr_t
+Parallel_reader::scan_ranges(
+	ulint	thread_no)
+{
+	const ulint	n_ranges = m_bounds.size() - 1;
+
+	while (!is_stopped()) {
+		const ulint	range = os_atomic_increment_ulint(
+			&m_next_range, 1) - 1;
+
+		if (range >= n_ranges) {
+			break;
+		}
+
+		dberr_t	err = scan_range(thread_no, range);
+
+		if (err != DB_SUCCESS) {
+			stop();
+			return(err);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+
+/** Thread function of the workers other than the first one */
+void*
+Parallel_reader::worker_thread(
+	void*	arg)
+{
+	Worker*			worker = static_cast<Worker*>(arg);
+	Parallel_reader*	reader = worker->reader;
+
+	my_thread_init();
+
+	worker->err = reader->scan_ranges(worker->thread_no);
+
+	/* The reader and the worker belong to the thread in run(), which
+	may free them as soon as the count drops to 0. */
+	if (os_atomic_decrement_ulint(&reader->m_n_running, 1) == 0) {
+		os_event_set(reader->m_done);
+	}
+
+	my_thread_end();
+
+	return(NULL);
+}
+
+/** Scans the index, calling the visitor for every visible record.
+@param[in,out]	visitor		record callback
+@return DB_SUCCESS, DB_INTERRUPTED, or the first error returned by
+the visitor */
+dberr_t
+Parallel_reader::run(
+	Visitor*	visitor)
+{
+	split();
+
+	m_visitor = visitor;
+	m_next_range = 0;
+	m_stop = 0;
+
+	/* The calling thread is thread 0. Worker threads are taken from
+	the limit for all scans; if there are none left or they can not be
+	created, the calling thread scans the remaining ranges alone. */
+	const ulint	n_reserved = parallel_read_reserve_workers(
+		ut_min(m_n_threads, ulint(m_bounds.size() - 1)) - 1);
+
+	std::vector<Worker, ut_allocator<Worker> >	workers(n_reserved + 1);
+	my_thread_attr_t				attr;
+
+	my_thread_attr_init(&attr);
+	my_thread_attr_setdetachstate(&attr, MY_THREAD_CREATE_DETACHED);
+
+	os_event_reset(m_done);
+	m_n_running = 1;
+
+	ulint	n_threads = 1;
+
+	for (; n_threads <= n_reserved; ++n_threads) {
+		Worker&	worker = workers[n_threads];
+
+		worker.reader = this;
+		worker.thread_no = n_threads;
+		worker.err = DB_SUCCESS;
+
+		os_atomic_increment_ulint(&m_n_running, 1);
+
+		if (mysql_thread_create(parallel_read_thread_key.m_value,
+					&worker.handle, &attr,
+					worker_thread, &worker)) {
+			os_atomic_decrement_ulint(&m_n_running, 1);
+			break;
+		}
+	}
+
+	my_thread_attr_destroy(&attr);
+
+	dberr_t	err = scan_ranges(0);
+
+	/* Wait for the workers, which signal m_done when the last of
+	them is done with this object. */
+	if (os_atomic_decrement_ulint(&m_n_running, 1) != 0) {
+		os_event_wait(m_done);
+	}
+
+	os_atomic_decrement_ulint(&parallel_read_n_workers, n_reserved);
+
+	for (ulint i = 1; i < n_threads; ++i) {
+		if (err == DB_SUCCESS) {
+			err = workers[i].err;
+		}
+	}
+
+	return(err);
+}
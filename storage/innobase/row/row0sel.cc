@@ -163,7 +163,6 @@ fields are compared with collation!
 @return TRUE if the secondary record is equal to the corresponding
 fields in the clustered record, when compared with collation;
 FALSE if not equal or if the clustered record has been marked for deletion */
-static
 ibool
 row_sel_sec_rec_is_for_clust_rec(
 	const rec_t*	sec_rec,
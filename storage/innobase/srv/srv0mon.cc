@@ -852,6 +852,11 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DISPLAY_CURRENT,
 	 MONITOR_DEFAULT_START, MONITOR_PURGE_RESUME_COUNT},
 
+	{"purge_undo_extents_reclaimed", "purge",
+	 "Number of free undo tablespace extents released with punch hole",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_UNDO_EXTENTS_RECLAIMED},
+
 	/* ========== Counters for Recovery Module ========== */
 	{"module_log", "recovery", "Recovery Module",
 	 MONITOR_MODULE,
@@ -1165,6 +1170,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_SRV_DICT_LRU_EVICT_COUNT},
 
+	{"innodb_temp_extents_reclaimed", "server",
+	 "Number of free temporary tablespace extents released with"
+	 " punch hole",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_SRV_TMP_SPACE_RECLAIM_COUNT},
+
 	{"innodb_checkpoint_usec", "server",
 	 "Time (in microseconds) spent by master thread to do checkpoint",
 	 MONITOR_NONE,
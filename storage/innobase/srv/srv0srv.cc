@@ -53,6 +53,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "dict0boot.h"
 #include "dict0load.h"
 #include "dict0stats_bg.h"
+#include "fsp0fsp.h"
 #include "fsp0sysspace.h"
 #include "ibuf0ibuf.h"
 #include "lock0lock.h"
@@ -149,9 +150,29 @@ it, truncate action is completed but no new tablespace is marked
 for truncate (action is never aborted). */
 my_bool	srv_undo_log_truncate = FALSE;
 
+/** Enable or disable releasing the storage of free extents of UNDO
+tablespaces with punch hole. Unlike truncate this does not need all
+the rsegs of the tablespace to be free. */
+my_bool	srv_undo_log_punch_hole = FALSE;
+
+/** Enable or disable releasing the storage of free extents of the
+temporary tablespace with punch hole. */
+my_bool	srv_temp_tablespace_punch_hole = FALSE;
+
+/** LSN at the start of the last srv_master_reclaim_temp_space() pass. */
+static lsn_t	srv_tmp_space_reclaim_lsn = 0;
+
 /** Maximum size of undo tablespace. */
 unsigned long long	srv_max_undo_log_size;
 
+/** Maximum size in bytes of the evictable data dictionary cache,
+or 0 if the cache is bounded only by table_definition_cache. */
+unsigned long long	srv_dict_size_limit	= 0;
+
+/** Maximum number of tables evicted from the data dictionary cache
+while holding dict_sys->mutex once. */
+ulong	srv_dict_lru_evict_batch	= 64;
+
 /** UNDO logs that are not redo logged.
 These logs reside in the temp tablespace.*/
 const ulong		srv_tmp_undo_logs = 32;
@@ -404,6 +425,9 @@ ulong	srv_n_purge_threads = 4;
 /* the number of pages to purge in one batch */
 ulong	srv_purge_batch_size = 20;
 
+/** Maximum number of threads of a parallel index scan */
+ulong	srv_parallel_read_threads = 4;
+
 ulong srv_encrypt_tables = 0;
 
 /* Internal setting for "innodb_stats_method". Decides how InnoDB treats
@@ -558,6 +582,7 @@ current_time % 5 != 0. */
 # define	SRV_MASTER_CHECKPOINT_INTERVAL		(7)
 # define	SRV_MASTER_PURGE_INTERVAL		(10)
 # define	SRV_MASTER_DICT_LRU_INTERVAL		(47)
+# define	SRV_MASTER_TMP_SPACE_RECLAIM_INTERVAL	(29)
 
 /** Acquire the system_mutex. */
 #define srv_sys_mutex_enter() do {			\
@@ -2348,7 +2373,10 @@ srv_sync_log_buffer_in_background(void)
 }
 
 /********************************************************************//**
-Make room in the table cache by evicting an unused table.
+Make room in the table cache by evicting unused tables. The tables are
+evicted in batches of srv_dict_lru_evict_batch and the dictionary latches
+are released between batches, so that table opens are not stalled for
+the whole duration of the sweep.
 @return number of tables evicted. */
 static
 ulint
@@ -2357,21 +2385,66 @@ srv_master_evict_from_table_cache(
 	ulint	pct_check)	/*!< in: max percent to check */
 {
 	ulint	n_tables_evicted = 0;
+	ulint	n_batch;
+	const ulint	batch_size = srv_dict_lru_evict_batch;
+
+	do {
+		rw_lock_x_lock(dict_operation_lock);
 
-	rw_lock_x_lock(dict_operation_lock);
+		dict_mutex_enter_for_mysql();
 
-	dict_mutex_enter_for_mysql();
+		n_batch = dict_make_room_in_cache(
+			innobase_get_table_cache_size(),
+			static_cast<ulint>(srv_dict_size_limit),
+			batch_size, pct_check);
 
-	n_tables_evicted = dict_make_room_in_cache(
-		innobase_get_table_cache_size(), pct_check);
+		dict_mutex_exit_for_mysql();
 
-	dict_mutex_exit_for_mysql();
+		rw_lock_x_unlock(dict_operation_lock);
 
-	rw_lock_x_unlock(dict_operation_lock);
+		n_tables_evicted += n_batch;
+
+	} while (n_batch == batch_size
+		 && srv_shutdown_state == SRV_SHUTDOWN_NONE);
 
 	return(n_tables_evicted);
 }
 
+/********************************************************************//**
+Release the storage of the free extents of the temporary tablespace, so
+that the disk space taken by large temporary tables is returned once the
+tables are dropped instead of at the next restart. The temporary
+tablespace is not redo logged, so any free extent can be released. Only
+the extent descriptor pages changed since the previous pass are
+examined. */
+static
+void
+srv_master_reclaim_temp_space(void)
+/*===============================*/
+{
+	log_mutex_enter();
+	lsn_t	lsn = log_sys->lsn;
+	log_mutex_exit();
+
+	/* Mini-transactions on the temporary tablespace are stamped with
+	the current LSN. A page modified after the pass started has a LSN
+	that is not less than lsn, and is examined by the next pass. */
+
+	ulint	n_released;
+	dberr_t	err = fsp_reclaim_free_extents(
+		srv_tmp_space.space_id(), srv_tmp_space_reclaim_lsn, LSN_MAX,
+		&n_released);
+
+	if (err == DB_SUCCESS) {
+		srv_tmp_space_reclaim_lsn = lsn;
+	}
+
+	if (n_released != 0) {
+		MONITOR_INC_VALUE(
+			MONITOR_SRV_TMP_SPACE_RECLAIM_COUNT, n_released);
+	}
+}
+
 /*********************************************************************//**
 This function prints progress message every 60 seconds during server
 shutdown, for any activities that master thread is pending on. */
@@ -2544,6 +2617,16 @@ srv_master_do_active_tasks(void)
 		return;
 	}
 
+	if (srv_temp_tablespace_punch_hole
+	    && cur_time % SRV_MASTER_TMP_SPACE_RECLAIM_INTERVAL == 0) {
+		srv_main_thread_op_info = "releasing temporary tablespace space";
+		srv_master_reclaim_temp_space();
+	}
+
+	if (srv_shutdown_state > 0) {
+		return;
+	}
+
 	/* Make a new checkpoint */
 	if (cur_time % SRV_MASTER_CHECKPOINT_INTERVAL == 0) {
 		srv_main_thread_op_info = "making checkpoint";
@@ -2614,6 +2697,11 @@ srv_master_do_idle_tasks(void)
 	MONITOR_INC_TIME_IN_MICRO_SECS(
 		MONITOR_SRV_DICT_LRU_MICROSECOND, counter_time);
 
+	if (srv_temp_tablespace_punch_hole) {
+		srv_main_thread_op_info = "releasing temporary tablespace space";
+		srv_master_reclaim_temp_space();
+	}
+
 	/* Flush logs if needed */
 	srv_sync_log_buffer_in_background();
 	MONITOR_INC_TIME_IN_MICRO_SECS(
@@ -1208,6 +1208,59 @@ trx_purge_initiate_truncate(
 			DBUG_SUICIDE(););
 }
 
+/** Release the storage of the free extents of the UNDO tablespaces by
+punching holes in their data files. Unlike truncate this does not wait
+for all the rsegs of a tablespace to become free, extents that were
+returned to the tablespace by freed undo segments are reclaimed while
+the other undo logs of the tablespace are in use.
+@param[in]	undo_trunc	undo truncate tracker */
+static
+void
+trx_purge_reclaim_undo_space(
+	const undo::Truncate*	undo_trunc)
+{
+	log_mutex_enter();
+	lsn_t	checkpoint_lsn = log_sys->last_checkpoint_lsn;
+	log_mutex_exit();
+
+	if (checkpoint_lsn <= purge_sys->undo_reclaim_lsn) {
+		/* Nothing was freed since the last pass. */
+		return;
+	}
+
+	bool	complete = true;
+
+	for (ulint i = 0; i < srv_undo_tablespaces_active; ++i) {
+		ulint	space_id = srv_undo_space_id_start + i;
+
+		if (undo_trunc->is_marked()
+		    && undo_trunc->get_marked_space_id() == space_id) {
+			/* The whole tablespace will be truncated. */
+			continue;
+		}
+
+		ulint	n_released;
+		dberr_t	err = fsp_reclaim_free_extents(
+			space_id, purge_sys->undo_reclaim_lsn, checkpoint_lsn,
+			&n_released);
+
+		if (err != DB_SUCCESS) {
+			complete = false;
+		}
+
+		if (n_released > 0) {
+			MONITOR_INC_VALUE(
+				MONITOR_UNDO_EXTENTS_RECLAIMED, n_released);
+		}
+	}
+
+	/* A pass that stopped early is repeated from the same LSN, or
+	the extents it did not reach would never be examined again. */
+	if (complete) {
+		purge_sys->undo_reclaim_lsn = checkpoint_lsn;
+	}
+}
+
 /********************************************************************//**
 Removes unnecessary history data from rollback segments. NOTE that when this
 function is called, the caller must not have any latches on undo log pages! */
@@ -1257,6 +1310,10 @@ trx_purge_truncate_history(
 		trx_purge_mark_undo_for_truncate(&purge_sys->undo_trunc);
 		trx_purge_initiate_truncate(limit, &purge_sys->undo_trunc);
 	}
+
+	if (srv_undo_log_punch_hole) {
+		trx_purge_reclaim_undo_space(&purge_sys->undo_trunc);
+	}
 }
 
 /***********************************************************************//**
@@ -62,6 +62,7 @@ public:
     primary_key= 0;
     column_bitmap_size= sizeof(int);
     tmp_table= NO_TMP_TABLE;
+    histograms= NULL;
     db_low_byte_first= true;
     path.str= const_cast<char*>(fakepath);
     path.length= strlen(path.str);
@@ -19,6 +19,8 @@
 #include <utility>
 
 #include "filesort_utils.h"
+#include "myisampack.h"
+#include "sql_sort.h"
 #include "table.h"
 
 
@@ -123,4 +125,169 @@ TEST_F(FileSortBufferTest, AssignmentOperator)
 }
 
 
+/*
+  Sorting with several threads must give the same result as sorting in
+  one thread, including the order of records with equal keys.
+*/
+TEST_F(FileSortBufferTest, ParallelSortIsStable)
+{
+  const uint num_records= 100000;
+  const uint sort_length= 24;
+  const uint rec_length= sort_length + sizeof(uint32);
+
+  Sort_param param;
+  param.sort_length= sort_length;
+  param.rec_length= rec_length;
+  param.max_sort_threads= 4;
+
+  fs_info.alloc_sort_buffer(num_records, rec_length);
+  fs_info.init_next_record_pointer();
+  for (uint ix= 0; ix < num_records; ++ix)
+  {
+    uchar *record= fs_info.get_next_record_pointer();
+    memset(record, 'a', sort_length);
+    // Few distinct keys, so that there are many duplicates.
+    int4store(record + sort_length - sizeof(uint32), (ix * 7919) % 97);
+    mi_int4store(record + sort_length, ix);
+  }
+
+  fs_info.sort_buffer(&param, num_records);
+
+  for (uint ix= 1; ix < num_records; ++ix)
+  {
+    const uchar *prev= fs_info.get_sorted_record(ix - 1);
+    const uchar *curr= fs_info.get_sorted_record(ix);
+    const int cmp= memcmp(prev, curr, sort_length);
+    ASSERT_LE(cmp, 0) << "index:" << ix;
+    if (cmp == 0)
+      ASSERT_LT(mi_uint4korr(prev + sort_length),
+                mi_uint4korr(curr + sort_length)) << "index:" << ix;
+  }
+}
+
+
+/*
+  The radix sort on key prefixes must order keys that differ only after
+  the prefix, and keep records with equal keys in their original order.
+*/
+TEST_F(FileSortBufferTest, PrefixRadixSortIsStable)
+{
+  const uint num_records= 200000;
+  const uint sort_length= 12;
+  const uint rec_length= sort_length + sizeof(uint32);
+
+  Sort_param param;
+  param.sort_length= sort_length;
+  param.rec_length= rec_length;
+  param.max_sort_threads= 1;
+
+  fs_info.alloc_sort_buffer(num_records, rec_length);
+  fs_info.init_next_record_pointer();
+  for (uint ix= 0; ix < num_records; ++ix)
+  {
+    uchar *record= fs_info.get_next_record_pointer();
+    mi_int8store(record, (ix * 7919ULL) % 1013);
+    mi_int4store(record + 8, (ix * 104729) % 89);
+    mi_int4store(record + sort_length, ix);
+  }
+
+  fs_info.sort_buffer(&param, num_records);
+
+  for (uint ix= 1; ix < num_records; ++ix)
+  {
+    const uchar *prev= fs_info.get_sorted_record(ix - 1);
+    const uchar *curr= fs_info.get_sorted_record(ix);
+    const int cmp= memcmp(prev, curr, sort_length);
+    ASSERT_LE(cmp, 0) << "index:" << ix;
+    if (cmp == 0)
+      ASSERT_LT(mi_uint4korr(prev + sort_length),
+                mi_uint4korr(curr + sort_length)) << "index:" << ix;
+  }
+}
+
+
+/*
+  Keys with equal eight byte prefixes must be ordered on the rest of the
+  key, and equal keys must stay in their original order.
+*/
+TEST_F(FileSortBufferTest, PrefixRadixSortEqualPrefixes)
+{
+  const uint num_records= 5000;
+  const uint sort_length= 24;
+  const uint rec_length= sort_length + sizeof(uint32);
+
+  Sort_param param;
+  param.sort_length= sort_length;
+  param.rec_length= rec_length;
+  param.max_sort_threads= 1;
+
+  fs_info.alloc_sort_buffer(num_records, rec_length);
+  fs_info.init_next_record_pointer();
+  for (uint ix= 0; ix < num_records; ++ix)
+  {
+    uchar *record= fs_info.get_next_record_pointer();
+    // Two distinct prefixes, the keys differ in their last bytes.
+    mi_int8store(record, ix % 2);
+    memset(record + 8, 'x', sort_length - 8);
+    mi_int4store(record + sort_length - sizeof(uint32),
+                 (num_records - ix) % 251);
+    mi_int4store(record + sort_length, ix);
+  }
+
+  fs_info.sort_buffer(&param, num_records);
+
+  for (uint ix= 1; ix < num_records; ++ix)
+  {
+    const uchar *prev= fs_info.get_sorted_record(ix - 1);
+    const uchar *curr= fs_info.get_sorted_record(ix);
+    const int cmp= memcmp(prev, curr, sort_length);
+    ASSERT_LE(cmp, 0) << "index:" << ix;
+    if (cmp == 0)
+      ASSERT_LT(mi_uint4korr(prev + sort_length),
+                mi_uint4korr(curr + sort_length)) << "index:" << ix;
+  }
+}
+
+
+/*
+  Keys shorter than eight bytes are padded to a full prefix, the padding
+  must not change their order.
+*/
+TEST_F(FileSortBufferTest, PrefixRadixSortShortKeys)
+{
+  // More keys than radixsort_for_str_ptr() takes, to get the prefix sort.
+  const uint num_records= 150000;
+  const uint sort_length= 5;
+  const uint rec_length= sort_length + sizeof(uint32);
+
+  Sort_param param;
+  param.sort_length= sort_length;
+  param.rec_length= rec_length;
+  param.max_sort_threads= 1;
+
+  fs_info.alloc_sort_buffer(num_records, rec_length);
+  fs_info.init_next_record_pointer();
+  for (uint ix= 0; ix < num_records; ++ix)
+  {
+    uchar *record= fs_info.get_next_record_pointer();
+    mi_int4store(record, (ix * 7919) % 4099);
+    record[4]= static_cast<uchar>((ix * 31) % 7);
+    mi_int4store(record + sort_length, ix);
+  }
+
+  fs_info.sort_buffer(&param, num_records);
+
+  for (uint ix= 1; ix < num_records; ++ix)
+  {
+    const uchar *prev= fs_info.get_sorted_record(ix - 1);
+    const uchar *curr= fs_info.get_sorted_record(ix);
+    const int cmp= memcmp(prev, curr, sort_length);
+    ASSERT_LE(cmp, 0) << "index:" << ix;
+    if (cmp == 0)
+      ASSERT_LT(mi_uint4korr(prev + sort_length),
+                mi_uint4korr(curr + sort_length)) << "index:" << ix;
+  }
+}
+
+
 }  // namespace
@@ -0,0 +1,115 @@
+/* Copyright (c) 2018 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <vector>
+
+#include "frm_cache.h"
+#include "my_sys.h"
+
+namespace frm_cache_unittest {
+
+static const char *frm_path= "frm_cache_test.frm";
+
+class FrmCacheTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    m_saved_size= frm_cache_size;
+    frm_cache_size= 1024 * 1024;
+    frm_cache_init();
+  }
+
+  virtual void TearDown()
+  {
+    frm_cache_free();
+    frm_cache_size= m_saved_size;
+    remove(frm_path);
+  }
+
+  /** Writes a table .frm image of the given length, filled with fill. */
+  static void write_frm(size_t length, uchar fill)
+  {
+    std::vector<uchar> image(length, fill);
+    image[0]= 254;
+    image[1]= 1;
+    FILE *file= fopen(frm_path, "wb");
+    ASSERT_TRUE(file != NULL);
+    EXPECT_EQ(length, fwrite(&image[0], 1, length, file));
+    fclose(file);
+  }
+
+  /** Reads the .frm and checks its length and contents. */
+  static void check_frm(size_t length, uchar fill)
+  {
+    uchar *image;
+    size_t image_length;
+    ASSERT_EQ(0, read_frm_file(frm_path, true, &image, &image_length));
+    EXPECT_EQ(length, image_length);
+    EXPECT_EQ(254, image[0]);
+    EXPECT_EQ(fill, image[length - 1]);
+    my_free(image);
+  }
+
+  ulong m_saved_size;
+};
+
+
+TEST_F(FrmCacheTest, ReadsCurrentImage)
+{
+  write_frm(100, 'a');
+  check_frm(100, 'a');
+  // Served from the cache
+  check_frm(100, 'a');
+
+  // A changed file is never served from the cache.
+  write_frm(200, 'b');
+  check_frm(200, 'b');
+
+  frm_cache_invalidate(frm_path);
+  check_frm(200, 'b');
+  frm_cache_flush();
+  check_frm(200, 'b');
+}
+
+
+TEST_F(FrmCacheTest, MissingFile)
+{
+  write_frm(100, 'a');
+  check_frm(100, 'a');
+  remove(frm_path);
+
+  uchar *image;
+  size_t image_length;
+  EXPECT_EQ(1, read_frm_file(frm_path, true, &image, &image_length));
+  EXPECT_EQ(1, read_frm_file(frm_path, false, &image, &image_length));
+}
+
+
+TEST_F(FrmCacheTest, Disabled)
+{
+  frm_cache_size= 0;
+  frm_cache_resize();
+  write_frm(100, 'a');
+  check_frm(100, 'a');
+  write_frm(100, 'c');
+  check_frm(100, 'c');
+}
+
+}
@@ -0,0 +1,169 @@
+/* Copyright (c) 2018 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "test_utils.h"
+#include "histogram.h"
+#include "sql_class.h"
+#include "sql_string.h"
+
+namespace histogram_unittest {
+
+using my_testing::Server_initializer;
+
+class HistogramTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp() { initializer.SetUp(); }
+  virtual void TearDown() { initializer.TearDown(); }
+
+  MEM_ROOT *mem_root() { return initializer.thd()->mem_root; }
+
+  Server_initializer initializer;
+};
+
+
+TEST_F(HistogramTest, Singleton)
+{
+  // 1 x 4, 2 x 1, 3 x 5, plus 10 NULLs
+  double values[]= { 3, 1, 3, 2, 1, 3, 1, 3, 1, 3 };
+  const Histogram *histogram=
+    Histogram::build(mem_root(), values, array_elements(values), 10, 100,
+                     MYSQL_TYPE_LONG);
+  ASSERT_TRUE(histogram != NULL);
+
+  EXPECT_EQ(Histogram::SINGLETON, histogram->get_type());
+  EXPECT_EQ(3U, histogram->get_num_buckets());
+  EXPECT_DOUBLE_EQ(0.5, histogram->get_null_values_fraction());
+
+  EXPECT_DOUBLE_EQ(0.2, histogram->get_equal_to_selectivity(1));
+  EXPECT_DOUBLE_EQ(0.05, histogram->get_equal_to_selectivity(2));
+  EXPECT_DOUBLE_EQ(0.25, histogram->get_equal_to_selectivity(3));
+  EXPECT_DOUBLE_EQ(0.0, histogram->get_equal_to_selectivity(2.5));
+  EXPECT_DOUBLE_EQ(0.0, histogram->get_equal_to_selectivity(4));
+
+  EXPECT_DOUBLE_EQ(0.0, histogram->get_less_than_selectivity(1));
+  EXPECT_DOUBLE_EQ(0.25, histogram->get_less_than_selectivity(3));
+  EXPECT_DOUBLE_EQ(0.25, histogram->get_less_than_equal_selectivity(2));
+  EXPECT_DOUBLE_EQ(0.3, histogram->get_greater_than_selectivity(1));
+  EXPECT_DOUBLE_EQ(0.5, histogram->get_greater_than_equal_selectivity(1));
+  EXPECT_DOUBLE_EQ(0.0, histogram->get_greater_than_selectivity(3));
+  EXPECT_DOUBLE_EQ(0.3, histogram->get_between_selectivity(2, 3));
+}
+
+
+TEST_F(HistogramTest, EquiHeight)
+{
+  // 0..999 once each, and 1000 values of 500 more
+  std::vector<double> values;
+  for (int i= 0; i < 1000; i++)
+    values.push_back(i);
+  for (int i= 0; i < 1000; i++)
+    values.push_back(500);
+
+  const Histogram *histogram=
+    Histogram::build(mem_root(), &values[0], values.size(), 0, 10,
+                     MYSQL_TYPE_LONG);
+  ASSERT_TRUE(histogram != NULL);
+
+  EXPECT_EQ(Histogram::EQUI_HEIGHT, histogram->get_type());
+  EXPECT_GE(10U, histogram->get_num_buckets());
+  EXPECT_DOUBLE_EQ(0.0, histogram->get_null_values_fraction());
+
+  // The frequent value has a bucket of its own.
+  for (uint i= 1; i < histogram->get_num_buckets(); i++)
+    EXPECT_LT(histogram->get_bucket(i - 1)->upper,
+              histogram->get_bucket(i)->lower);
+  EXPECT_DOUBLE_EQ(1.0, histogram->get_bucket(histogram->get_num_buckets() - 1)
+                   ->cumulative_frequency);
+
+  // The skew is visible, unlike with a fixed guess.
+  EXPECT_GT(histogram->get_equal_to_selectivity(500), 0.1);
+  EXPECT_LT(histogram->get_equal_to_selectivity(100), 0.01);
+  EXPECT_NEAR(0.25, histogram->get_less_than_selectivity(500), 0.05);
+  EXPECT_NEAR(0.75, histogram->get_less_than_equal_selectivity(500), 0.05);
+  EXPECT_DOUBLE_EQ(0.0, histogram->get_less_than_selectivity(0));
+  EXPECT_NEAR(1.0, histogram->get_less_than_equal_selectivity(999), 1e-9);
+  EXPECT_NEAR(0.0, histogram->get_greater_than_selectivity(999), 1e-9);
+}
+
+
+TEST_F(HistogramTest, Empty)
+{
+  const Histogram *histogram=
+    Histogram::build(mem_root(), NULL, 0, 0, 10, MYSQL_TYPE_LONG);
+  ASSERT_TRUE(histogram != NULL);
+
+  EXPECT_EQ(0U, histogram->get_num_buckets());
+  EXPECT_DOUBLE_EQ(0.0, histogram->get_equal_to_selectivity(1));
+  EXPECT_DOUBLE_EQ(1.0, histogram->get_less_than_selectivity(1));
+}
+
+
+TEST_F(HistogramTest, JsonRoundTrip)
+{
+  std::vector<double> values;
+  for (int i= 0; i < 500; i++)
+    values.push_back(i * 0.5);
+  const Histogram *histogram=
+    Histogram::build(mem_root(), &values[0], values.size(), 25, 20,
+                     MYSQL_TYPE_DOUBLE);
+  ASSERT_TRUE(histogram != NULL);
+
+  String json;
+  EXPECT_FALSE(histogram->to_json(&json));
+  const Histogram *copy=
+    Histogram::from_json(mem_root(), json.ptr(), json.length());
+  ASSERT_TRUE(copy != NULL);
+
+  EXPECT_EQ(histogram->get_type(), copy->get_type());
+  EXPECT_EQ(histogram->get_data_type(), copy->get_data_type());
+  EXPECT_DOUBLE_EQ(histogram->get_null_values_fraction(),
+                   copy->get_null_values_fraction());
+  ASSERT_EQ(histogram->get_num_buckets(), copy->get_num_buckets());
+  for (uint i= 0; i < histogram->get_num_buckets(); i++)
+  {
+    EXPECT_DOUBLE_EQ(histogram->get_bucket(i)->lower,
+                     copy->get_bucket(i)->lower);
+    EXPECT_DOUBLE_EQ(histogram->get_bucket(i)->upper,
+                     copy->get_bucket(i)->upper);
+    EXPECT_DOUBLE_EQ(histogram->get_bucket(i)->cumulative_frequency,
+                     copy->get_bucket(i)->cumulative_frequency);
+    EXPECT_DOUBLE_EQ(histogram->get_bucket(i)->distinct_values,
+                     copy->get_bucket(i)->distinct_values);
+  }
+
+  // Invalid histograms are rejected.
+  const char *invalid[]=
+  {
+    "[]",
+    "{\"histogram-type\": \"singleton\", \"data-type\": 3}",
+    "{\"histogram-type\": \"other\", \"data-type\": 3, "
+    "\"null-values\": 0, \"buckets\": []}",
+    "{\"histogram-type\": \"singleton\", \"data-type\": 3, "
+    "\"null-values\": 0, \"buckets\": [[2, 0.5], [1, 1.0]]}",
+    "{\"histogram-type\": \"singleton\", \"data-type\": 3, "
+    "\"null-values\": 0, \"buckets\": [[1, 0.5, 1, 1]]}"
+  };
+  for (size_t i= 0; i < array_elements(invalid); i++)
+    EXPECT_TRUE(Histogram::from_json(mem_root(), invalid[i],
+                                     strlen(invalid[i])) == NULL) << i;
+}
+
+}
@@ -132,6 +132,9 @@ protected:
   // A utility member for testing single lock requests.
   void test_one_simple_shared_lock(enum_mdl_type lock_type);
 
+  // A utility member for making "fast path" locks on a table sharded.
+  void shard_fast_path_counters(const char *table_name);
+
   const MDL_ticket  *m_null_ticket;
   const MDL_request *m_null_request;
   MDL_context        m_mdl_context;
@@ -3047,6 +3050,211 @@ TEST_F(MDLTest, UnusedMinRatio)
 }
 
 
+/*
+  Acquires and releases S lock on the table while pretending that its
+  "fast path" compare-and-swap has failed often enough, so that further
+  "fast path" locks on the table use shards of counters.
+*/
+
+void MDLTest::shard_fast_path_counters(const char *table_name)
+{
+  MDL_request request;
+  MDL_REQUEST_INIT(&request,
+                   MDL_key::TABLE, db_name, table_name, MDL_SHARED,
+                   MDL_TRANSACTION);
+
+  DBUG_SET("+d,mdl_shard_fast_path_counters");
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&request));
+  DBUG_SET("-d,mdl_shard_fast_path_counters");
+
+  ASSERT_NE(m_null_ticket, request.ticket);
+  /* Only the locks acquired after this one are sharded. */
+  EXPECT_FALSE(request.ticket->is_sharded_fast_path());
+
+  m_mdl_context.release_transactional_locks();
+}
+
+
+#if !defined(DBUG_OFF)
+/*
+  Verifies that X lock waits for S lock which was acquired using
+  a shard of "fast path" counters, and that it is granted once the
+  S lock is released.
+*/
+
+TEST_F(MDLTest, ShardedSharedExclusive)
+{
+  Notification lock_grabbed;
+  Notification release_locks;
+  Notification lock_blocked;
+
+  shard_fast_path_counters(table_name1);
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  ASSERT_NE(m_null_ticket, m_request.ticket);
+  EXPECT_TRUE(m_request.ticket->is_sharded_fast_path());
+
+  MDL_thread mdl_thread(table_name1, MDL_EXCLUSIVE, &lock_grabbed,
+                        &release_locks, &lock_blocked, NULL);
+  mdl_thread.start();
+  lock_blocked.wait_for_notification();
+
+  /* Releasing the sharded S lock should let the X lock through. */
+  m_mdl_context.release_transactional_locks();
+  lock_grabbed.wait_for_notification();
+
+  release_locks.notify();
+  mdl_thread.join();
+}
+
+
+/*
+  Verifies that a sharded S lock is materialized when its context
+  acquires an "obtrusive" lock, and that it still conflicts with
+  X lock afterwards.
+*/
+
+TEST_F(MDLTest, ShardedSharedMaterialize)
+{
+  Notification lock_grabbed;
+  Notification release_locks;
+  Notification lock_blocked;
+  MDL_request request_2;
+
+  shard_fast_path_counters(table_name1);
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  ASSERT_NE(m_null_ticket, m_request.ticket);
+  EXPECT_TRUE(m_request.ticket->is_sharded_fast_path());
+
+  MDL_REQUEST_INIT(&request_2,
+                   MDL_key::TABLE, db_name, table_name2, MDL_EXCLUSIVE,
+                   MDL_TRANSACTION);
+  m_request_list.push_front(&request_2);
+  m_request_list.push_front(&m_global_request);
+  EXPECT_FALSE(m_mdl_context.acquire_locks(&m_request_list, long_timeout));
+
+  /* The S lock is now in MDL_lock::m_granted. */
+  EXPECT_FALSE(m_request.ticket->is_sharded_fast_path());
+  EXPECT_TRUE(m_mdl_context.
+              owns_equal_or_stronger_lock(MDL_key::TABLE, db_name, table_name1,
+                                          MDL_SHARED));
+
+  MDL_thread mdl_thread(table_name1, MDL_EXCLUSIVE, &lock_grabbed,
+                        &release_locks, &lock_blocked, NULL);
+  mdl_thread.start();
+  lock_blocked.wait_for_notification();
+
+  m_mdl_context.release_transactional_locks();
+  lock_grabbed.wait_for_notification();
+
+  release_locks.notify();
+  mdl_thread.join();
+}
+
+
+/*
+  Verifies that a sharded S lock can be upgraded to X lock, which
+  then blocks S locks of other contexts until it is released.
+*/
+
+TEST_F(MDLTest, ShardedSharedUpgrade)
+{
+  MDL_context mdl_context2;
+  MDL_request request_2;
+
+  shard_fast_path_counters(table_name1);
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  ASSERT_NE(m_null_ticket, m_request.ticket);
+  EXPECT_TRUE(m_request.ticket->is_sharded_fast_path());
+
+  EXPECT_FALSE(m_mdl_context.acquire_lock(&m_global_request, long_timeout));
+  EXPECT_FALSE(m_mdl_context.upgrade_shared_lock(m_request.ticket,
+                                                 MDL_EXCLUSIVE,
+                                                 long_timeout));
+  EXPECT_EQ(MDL_EXCLUSIVE, m_request.ticket->get_type());
+  EXPECT_FALSE(m_request.ticket->is_sharded_fast_path());
+
+  mdl_context2.init(this);
+  MDL_REQUEST_INIT(&request_2,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(mdl_context2.try_acquire_lock(&request_2));
+  EXPECT_EQ(m_null_ticket, request_2.ticket);
+
+  m_mdl_context.release_transactional_locks();
+
+  EXPECT_FALSE(mdl_context2.try_acquire_lock(&request_2));
+  EXPECT_NE(m_null_ticket, request_2.ticket);
+
+  mdl_context2.release_transactional_locks();
+  mdl_context2.destroy();
+}
+
+
+/*
+  Verifies that MDL_lock object with sharded "fast path" counters stays
+  used while the table is hot, and becomes unused once X lock (as taken
+  by DROP TABLE) has been released.
+*/
+
+TEST_F(MDLTest, ShardedUnusedAfterExclusive)
+{
+  MDL_request request_2;
+
+  EXPECT_EQ(0, mdl_get_unused_locks_count());
+
+  shard_fast_path_counters(table_name1);
+
+  /* HAS_SHARDS keeps the object in use without any locks. */
+  EXPECT_EQ(0, mdl_get_unused_locks_count());
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  ASSERT_NE(m_null_ticket, m_request.ticket);
+  EXPECT_TRUE(m_request.ticket->is_sharded_fast_path());
+  m_mdl_context.release_transactional_locks();
+
+  EXPECT_EQ(0, mdl_get_unused_locks_count());
+
+  MDL_REQUEST_INIT(&request_2,
+                   MDL_key::TABLE, db_name, table_name1, MDL_EXCLUSIVE,
+                   MDL_TRANSACTION);
+  m_request_list.push_front(&request_2);
+  m_request_list.push_front(&m_global_request);
+  EXPECT_FALSE(m_mdl_context.acquire_locks(&m_request_list, long_timeout));
+  m_mdl_context.release_transactional_locks();
+
+  /* Release of X lock has cleared HAS_SHARDS. */
+  EXPECT_EQ(1, mdl_get_unused_locks_count());
+
+  /* And the next S lock uses m_fast_path_state again. */
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  ASSERT_NE(m_null_ticket, m_request.ticket);
+  EXPECT_FALSE(m_request.ticket->is_sharded_fast_path());
+  EXPECT_EQ(0, mdl_get_unused_locks_count());
+  m_mdl_context.release_transactional_locks();
+
+  EXPECT_EQ(1, mdl_get_unused_locks_count());
+}
+#endif  // !defined(DBUG_OFF)
+
+
 /*
   Verifies following scenario,
   After granting max_write_lock_count(=1) number of times for SW
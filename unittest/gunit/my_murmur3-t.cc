@@ -105,4 +105,33 @@ TEST(Murmur3, Bug16396598)
     EXPECT_GT(4U, buckets[i]);
 }
 
+
+/* Check 128-bit version against the reference implementation. */
+
+TEST(Murmur3, X64_128)
+{
+  const char *str= "The quick brown fox jumps over the lazy dog";
+  const uchar expected[MURMUR3_128_HASH_SIZE]=
+    { 0x6c, 0x1b, 0x07, 0xbc, 0x7b, 0xbc, 0x4b, 0xe3,
+      0x47, 0x93, 0x9a, 0xc4, 0xa9, 0x3c, 0x43, 0x7a };
+  uchar hash[MURMUR3_128_HASH_SIZE];
+
+  murmur3_x64_128((const uchar *)str, strlen(str), 0, hash);
+  EXPECT_EQ(0, memcmp(expected, hash, sizeof(hash)));
+
+  /* Every tail length gives a different hash. */
+  uchar prev[MURMUR3_128_HASH_SIZE];
+  memset(prev, 0, sizeof(prev));
+  for (size_t len= 1; len <= 32; len++)
+  {
+    murmur3_x64_128((const uchar *)str, len, 0, hash);
+    EXPECT_NE(0, memcmp(prev, hash, sizeof(hash))) << len;
+    memcpy(prev, hash, sizeof(hash));
+  }
+
+  murmur3_x64_128(NULL, 0, 0, hash);
+  for (size_t i= 0; i < sizeof(hash); i++)
+    EXPECT_EQ(0, hash[i]);
+}
+
 }  // namespace
@@ -23,6 +23,7 @@
 #include "thread_utils.h"
 #include "mysqld.h"
 #include "mysqld_thd_manager.h"  // Global_THD_manager
+#include "sql_parse.h"           // Find_thd_with_id
 
 using thread::Thread;
 using thread::Notification;
@@ -214,6 +215,40 @@ TEST_F(ThreadManagerTest, TestTHDFindFunc)
 }
 
 
+/*
+  Verify find_thd() with Find_thd_with_id, which only searches the
+  partition of the thread id, on THDs spread over all partitions.
+*/
+TEST_F(ThreadManagerTest, TestTHDFindById)
+{
+  const uint num_thds= 2 * Global_THD_manager::NUM_PARTITIONS + 1;
+  THD *thds[num_thds];
+  for (uint i= 0; i < num_thds; i++)
+  {
+    thds[i]= new THD(false);
+    thds[i]->set_new_thread_id();
+    thd_manager->add_thd(thds[i]);
+  }
+  EXPECT_EQ(num_thds, thd_manager->get_thd_count());
+
+  for (uint i= 0; i < num_thds; i++)
+  {
+    Find_thd_with_id find_thd_with_id(thds[i]->thread_id(), true);
+    THD *thd= thd_manager->find_thd(&find_thd_with_id);
+    EXPECT_EQ(thds[i], thd);
+    if (thd)
+      mysql_mutex_unlock(&thd->LOCK_thd_data);
+  }
+
+  for (uint i= 0; i < num_thds; i++)
+  {
+    thd_manager->remove_thd(thds[i]);
+    delete thds[i];
+  }
+  EXPECT_EQ(0U, thd_manager->get_thd_count());
+}
+
+
 TEST_F(ThreadManagerTest, TestTHDCountFunc)
 {
   THD thd1(false), thd2(false), thd3(false);
@@ -17,11 +17,13 @@
 #include "my_config.h"
 #include <gtest/gtest.h>
 #include <stddef.h>
+#include <vector>
 
 #include "test_utils.h"
 #include "fake_costmodel.h"
 #include "sql_class.h"
 #include "uniques.h"
+#include "myisampack.h"
 
 namespace unique_unittest {
 
@@ -59,4 +61,112 @@ TEST_F(UniqueCostTest, GetUseCost)
   EXPECT_GT(dup_removal_cost, 0.0);
 }
 
+
+static int key_cmp(const void *arg, const void *key1, const void *key2)
+{
+  return memcmp(key1, key2, *static_cast<const uint*>(arg));
+}
+
+
+static int collect_key(void *key, element_count count, void *arg)
+{
+  std::vector<ulonglong> *keys= static_cast<std::vector<ulonglong>*>(arg);
+  keys->push_back(mi_uint8korr(static_cast<uchar*>(key)));
+  return 0;
+}
+
+
+/*
+  Adds every key of 0..99 ten times in scattered order, and checks that
+  walk() returns each of them once, in order.
+*/
+static void add_and_walk(Unique *unique)
+{
+  for (ulonglong i= 0; i < 1000; i++)
+  {
+    uchar key[8];
+    mi_int8store(key, (i * 37) % 100);
+    EXPECT_FALSE(unique->unique_add(key));
+  }
+
+  std::vector<ulonglong> keys;
+  EXPECT_FALSE(unique->walk(collect_key, &keys));
+  ASSERT_EQ(100U, keys.size());
+  for (ulonglong i= 0; i < keys.size(); i++)
+    EXPECT_EQ(i, keys[i]);
+}
+
+
+TEST_F(UniqueCostTest, BinaryKeysInMemory)
+{
+  uint key_size= 8;
+  Unique unique(key_cmp, &key_size, key_size, MIN_SORT_MEMORY, true);
+  add_and_walk(&unique);
+  EXPECT_EQ(0U, unique.elements);
+  EXPECT_EQ(100U, unique.elements_in_tree());
+
+  unique.reset();
+  EXPECT_EQ(0U, unique.elements_in_tree());
+  add_and_walk(&unique);
+}
+
+
+TEST_F(UniqueCostTest, BinaryKeysOnDisk)
+{
+  uint key_size= 8;
+  // Room for eight keys at a time
+  Unique unique(key_cmp, &key_size, key_size, 8 * (key_size + 12), true);
+  add_and_walk(&unique);
+  EXPECT_LT(0U, unique.elements);
+}
+
+
+TEST_F(UniqueCostTest, BinaryKeysGrow)
+{
+  uint key_size= 8;
+  Unique unique(key_cmp, &key_size, key_size, MIN_SORT_MEMORY, true);
+  // Many more keys than the initial hash set capacity
+  for (ulonglong i= 0; i < 10000; i++)
+  {
+    uchar key[8];
+    mi_int8store(key, (i * 7919) % 10000);
+    EXPECT_FALSE(unique.unique_add(key));
+  }
+  EXPECT_EQ(0U, unique.elements);
+  EXPECT_EQ(10000U, unique.elements_in_tree());
+
+  std::vector<ulonglong> keys;
+  EXPECT_FALSE(unique.walk(collect_key, &keys));
+  ASSERT_EQ(10000U, keys.size());
+  for (ulonglong i= 0; i < keys.size(); i++)
+    EXPECT_EQ(i, keys[i]);
+}
+
+
+TEST_F(UniqueCostTest, BinaryKeysCost)
+{
+  const ulong num_keys= 328238;
+  const ulong key_size= 8;
+  Fake_Cost_model_table cost_model_table;
+
+  EXPECT_LT(Unique::get_max_elements(MIN_SORT_MEMORY, key_size),
+            Unique::get_max_elements(MIN_SORT_MEMORY, key_size, true));
+
+  size_t unique_calc_buff_size=
+    Unique::get_cost_calc_buff_size(num_keys, key_size, MIN_SORT_MEMORY);
+  void *rawmem= alloc_root(thd()->mem_root,
+                           unique_calc_buff_size * sizeof(uint));
+  Bounds_checked_array<uint> cost_buff=
+    Bounds_checked_array<uint>(static_cast<uint*>(rawmem), unique_calc_buff_size);
+  const double tree_cost=
+    Unique::get_use_cost(cost_buff, num_keys, key_size, MIN_SORT_MEMORY,
+                         &cost_model_table);
+  // The hash set needs no more merge buffers than the tree
+  const double hash_cost=
+    Unique::get_use_cost(cost_buff, num_keys, key_size, MIN_SORT_MEMORY,
+                         &cost_model_table, true);
+  EXPECT_GT(hash_cost, 0.0);
+  EXPECT_LE(hash_cost, tree_cost);
+}
+
 }